@@ -10,6 +10,8 @@
 #include <faux/str.h>
 #include <faux/vec.h>
 #include <faux/list.h>
+#include <faux/ilist.h>
+#include <faux/ulist.h>
 #include <faux/sysdb.h>
 #include <faux/time.h>
 #include <faux/argv.h>
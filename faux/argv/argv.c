@@ -369,8 +369,14 @@ bool_t faux_argv_del(faux_argv_t *fargv, faux_argv_node_t *node)
 
 
 /** @brief Gets argument by index.
+ *
+ * The argv's list remembers the last found argument (see faux_list_seek()).
+ * So sequential access by index costs O(1). Function changes internal state
+ * of argv object so the same object can't be indexed by several threads
+ * at once.
  *
  * @param [in] fargv Allocated argv object.
+ * @param [in] index Argument's index.
  * @return String or NULL on error.
  */
 const char *faux_argv_index(const faux_argv_t *fargv, size_t index)
@@ -381,7 +387,7 @@ const char *faux_argv_index(const faux_argv_t *fargv, size_t index)
 	if (!fargv)
 		return NULL;
 
-	res = (const char *)faux_list_index(fargv->list, index);
+	res = (const char *)faux_list_seek(fargv->list, index);
 
 	return res;
 }
@@ -2,6 +2,8 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "faux/str.h"
+#include "faux/time.h"
 #include "faux/argv.h"
 
 
@@ -151,3 +153,61 @@ int testc_faux_argv_index(void)
 
 	return retval;
 }
+
+
+#define ARGV_LEN 100000
+int testc_faux_argv_index_seq(void)
+{
+	faux_argv_t *fargv = NULL;
+	struct timespec start = {};
+	struct timespec now = {};
+	struct timespec diff = {};
+	size_t index = 0;
+	int retval = -1;
+
+	fargv = faux_argv_new();
+	for (index = 0; index < ARGV_LEN; index++) {
+		char *arg = faux_str_sprintf("%zu", index);
+		faux_argv_add(fargv, arg);
+		faux_str_free(arg);
+	}
+
+	// Sequential access by index is linear in total. Quadratic walk from
+	// the list head for each index takes much more than a second.
+	faux_timespec_now_monotonic(&start);
+	for (index = 0; index < ARGV_LEN; index++) {
+		const char *res = faux_argv_index(fargv, index);
+		if (!res || ((size_t)atol(res) != index)) {
+			fprintf(stderr, "Wrong argument %zu\n", index);
+			goto err;
+		}
+	}
+	// Backward
+	for (index = ARGV_LEN; index > 0; index--) {
+		const char *res = faux_argv_index(fargv, index - 1);
+		if (!res || ((size_t)atol(res) != (index - 1))) {
+			fprintf(stderr, "Wrong argument %zu\n", index - 1);
+			goto err;
+		}
+	}
+	faux_timespec_now_monotonic(&now);
+	faux_timespec_diff(&diff, &now, &start);
+	if (diff.tv_sec >= 1) {
+		fprintf(stderr, "Too slow sequential access\n");
+		goto err;
+	}
+
+	// Modification drops remembered argument
+	faux_argv_index(fargv, ARGV_LEN / 2);
+	faux_argv_del(fargv, faux_argv_iter(fargv));
+	if (strcmp(faux_argv_index(fargv, ARGV_LEN / 2), "50001") != 0) {
+		fprintf(stderr, "Wrong argument after deletion\n");
+		goto err;
+	}
+
+	retval = 0;
+err:
+	faux_argv_free(fargv);
+
+	return retval;
+}
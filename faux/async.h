@@ -25,6 +25,9 @@ typedef bool_t (*faux_async_read_cb_fn)(faux_async_t *async,
 	faux_buf_t *buf, size_t len, void *user_data);
 typedef bool_t (*faux_async_stall_cb_fn)(faux_async_t *async,
 	size_t len, void *user_data);
+// Engine that takes output data instead of write() (io_uring for example)
+typedef ssize_t (*faux_async_engine_fn)(faux_async_t *async,
+	void *engine_data);
 
 
 C_DECL_BEGIN
@@ -41,11 +44,16 @@ void faux_async_set_stall_cb(faux_async_t *async,
 	faux_async_stall_cb_fn stall_cb, void *user_data);
 void faux_async_set_write_overflow(faux_async_t *async, size_t overflow);
 void faux_async_set_read_overflow(faux_async_t *async, size_t overflow);
+void faux_async_set_read_budget(faux_async_t *async, size_t budget);
+bool_t faux_async_in_pending(const faux_async_t *async);
 ssize_t faux_async_write(faux_async_t *async, void *data, size_t len);
 ssize_t faux_async_writev(faux_async_t *async,
 	const struct iovec *iov, int iovcnt);
 ssize_t faux_async_out(faux_async_t *async);
 ssize_t faux_async_in(faux_async_t *async);
+void faux_async_set_engine(faux_async_t *async,
+	faux_async_engine_fn engine, void *engine_data);
+ssize_t faux_async_feed(faux_async_t *async, const void *data, ssize_t len);
 
 C_DECL_END
 
@@ -20,6 +20,11 @@
  * The "read" callback will get allocated buffer with received data. The
  * length of the data is greater or equal to "min" limit and less or equal to
  * "max" limit.
+ *
+ * The data can be transferred by external engine instead of read() and
+ * write() syscalls. For example event loop with io_uring backend reads and
+ * writes fd by completion requests. See faux_async_set_engine(). Then
+ * faux_async_in() and faux_async_out() don't make syscalls at all.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -81,6 +86,8 @@ faux_async_t *faux_async_new(int fd)
 	async->read_udata = NULL;
 	async->min = 1;
 	async->max = FAUX_ASYNC_UNLIMITED;
+	async->read_budget = FAUX_ASYNC_UNLIMITED;
+	async->in_pending = BOOL_FALSE;
 	async->ibuf = faux_buf_new(DATA_CHUNK);
 	faux_buf_set_limit(async->ibuf, FAUX_ASYNC_IN_OVERFLOW);
 
@@ -90,6 +97,12 @@ faux_async_t *faux_async_new(int fd)
 	async->obuf = faux_buf_new(DATA_CHUNK);
 	faux_buf_set_limit(async->obuf, FAUX_ASYNC_OUT_OVERFLOW);
 
+	// Engine
+	async->engine = NULL;
+	async->engine_data = NULL;
+	async->fed = 0;
+	async->fed_errno = 0;
+
 	return async;
 }
 
@@ -261,6 +274,42 @@ void faux_async_set_read_overflow(faux_async_t *async, size_t overflow)
 }
 
 
+/** @brief Set read budget.
+ *
+ * By default faux_async_in() reads fd until there is no more data. So one
+ * bulk transfer peer can starve other fds served by the same event loop.
+ * The budget limits the number of bytes read by single faux_async_in()
+ * call. Use faux_async_in_pending() to find out if reading was stopped by
+ * budget. Then fd can be requeued by faux_eloop_requeue_fd() for example.
+ *
+ * @param [in] async Allocated and initialized async I/O object.
+ * @param [in] budget Max number of bytes or FAUX_ASYNC_UNLIMITED.
+ */
+void faux_async_set_read_budget(faux_async_t *async, size_t budget)
+{
+	assert(async);
+	if (!async)
+		return;
+
+	async->read_budget = budget;
+}
+
+
+/** @brief Checks if the last reading was stopped by read budget.
+ *
+ * @param [in] async Allocated and initialized async I/O object.
+ * @return BOOL_TRUE if fd can have more data to read else BOOL_FALSE.
+ */
+bool_t faux_async_in_pending(const faux_async_t *async)
+{
+	assert(async);
+	if (!async)
+		return BOOL_FALSE;
+
+	return async->in_pending;
+}
+
+
 /** @brief Async data write.
  *
  * All given data will be stored to internal buffer (list of data chunks).
@@ -353,9 +402,11 @@ ssize_t faux_async_writev(faux_async_t *async,
  * data to fd in non-blocking mode. So function doesn't block. It can be called
  * after select() or poll() if fd is ready to be written to. If function can't
  * to write all buffer to fd it executes "stall" callback to inform about it.
+ * If engine is set then data is passed to engine and "stall" callback is
+ * not executed.
  *
  * @param [in] async Allocated and initialized async I/O object.
- * @return Length of data actually written or < 0 on error.
+ * @return Length of data actually written (taken by engine) or < 0 on error.
  */
 ssize_t faux_async_out(faux_async_t *async)
 {
@@ -365,6 +416,9 @@ ssize_t faux_async_out(faux_async_t *async)
 	if (!async)
 		return -1;
 
+	if (async->engine)
+		return async->engine(async, async->engine_data);
+
 	while (faux_buf_len(async->obuf) > 0) {
 		ssize_t data_to_write = 0;
 		ssize_t bytes_written = 0;
@@ -412,6 +466,38 @@ ssize_t faux_async_out(faux_async_t *async)
 }
 
 
+/** @brief Executes read callback for stored data.
+ *
+ * Static service function. The callback is executed while amount of
+ * stored data is greater or equal to "min" limit.
+ *
+ * @param [in] async Allocated and initialized async I/O object.
+ */
+static void faux_async_read_cb(faux_async_t *async)
+{
+	size_t bytes_stored = 0;
+
+	if (!async->read_cb) // No read callback
+		return;
+	// Check for amount of stored data
+	while ((bytes_stored = faux_buf_len(async->ibuf)) >= async->min) {
+		size_t copy_len = 0;
+
+		// Calculate length of user-requested block
+		if (FAUX_ASYNC_UNLIMITED == async->max) { // Indefinite
+			copy_len = bytes_stored; // Take all data
+		} else {
+			copy_len = (bytes_stored < async->max) ?
+				bytes_stored : async->max;
+		}
+
+		// Execute callback
+		async->read_cb(async, async->ibuf,
+			copy_len, async->read_udata);
+	}
+}
+
+
 /** @brief Read data and store it to internal buffer in non-blocking mode.
  *
  * Reads fd and puts data to internal buffer. It can't be blocked. If length of
@@ -419,6 +505,9 @@ ssize_t faux_async_out(faux_async_t *async)
  * function will execute "read" callback. It gives faux_buf_t object to callback.
  * If "max" limit is "0"
  * (it means indefinite) then function will pass all available data to callback.
+ * The amount of data read by single call can be limited by
+ * faux_async_set_read_budget(). If engine is set then function doesn't read
+ * fd. It executes "read" callback for data fed by engine.
  *
  * @param [in] async Allocated and initialized async I/O object.
  * @return Length of data actually readed or < 0 on error.
@@ -433,13 +522,32 @@ ssize_t faux_async_in(faux_async_t *async)
 	if (!async)
 		return -1;
 
+	async->in_pending = BOOL_FALSE;
+
+	// Data is already read by engine
+	if (async->engine) {
+		total_readed = async->fed;
+		async->fed = 0;
+		if ((0 == total_readed) && (async->fed_errno != 0)) {
+			errno = async->fed_errno;
+			async->fed_errno = 0;
+			return -1;
+		}
+		faux_async_read_cb(async);
+		return total_readed;
+	}
+
 	do {
 		void *data = NULL;
-		size_t bytes_stored = 0;
 
 		locked_len = faux_buf_dwrite_lock_easy(async->ibuf, &data);
 		if (locked_len <= 0)
 			return -1;
+		// Don't read more than budget
+		if ((async->read_budget != FAUX_ASYNC_UNLIMITED) &&
+			((size_t)locked_len >
+			(async->read_budget - (size_t)total_readed)))
+			locked_len = async->read_budget - total_readed;
 		// Read data
 		bytes_readed = read(async->fd, data, locked_len);
 		if (bytes_readed < 0) {
@@ -454,26 +562,78 @@ ssize_t faux_async_in(faux_async_t *async)
 		}
 		faux_buf_dwrite_unlock_easy(async->ibuf, bytes_readed);
 		total_readed += bytes_readed;
+		// Budget is exhausted but fd can have more data
+		if ((async->read_budget != FAUX_ASYNC_UNLIMITED) &&
+			((size_t)total_readed >= async->read_budget) &&
+			(bytes_readed == locked_len))
+			async->in_pending = BOOL_TRUE;
 
-		if (!async->read_cb) // No read callback
-			continue;
-		// Check for amount of stored data
-		while ((bytes_stored = faux_buf_len(async->ibuf)) >= async->min) {
-			size_t copy_len = 0;
-
-			// Calculate length of user-requested block
-			if (FAUX_ASYNC_UNLIMITED == async->max) { // Indefinite
-				copy_len = bytes_stored; // Take all data
-			} else {
-				copy_len = (bytes_stored < async->max) ?
-					bytes_stored : async->max;
-			}
-
-			// Execute callback
-			async->read_cb(async, async->ibuf,
-				copy_len, async->read_udata);
-		}
-	} while (bytes_readed == locked_len);
+		faux_async_read_cb(async);
+	} while ((bytes_readed == locked_len) && !async->in_pending);
 
 	return total_readed;
 }
+
+
+/** @brief Sets engine to transfer data instead of read() and write().
+ *
+ * The engine (event loop with io_uring backend for example) reads fd by
+ * itself and gives data to async object by faux_async_feed(). Then
+ * faux_async_in() doesn't read fd but executes "read" callback for fed data.
+ * The faux_async_out() passes output data to engine function. Engine takes
+ * data from output buffer (see faux_async_obuf()) and writes it later.
+ *
+ * @param [in] async Allocated and initialized async I/O object.
+ * @param [in] engine Engine function to take output data. NULL - no engine.
+ * @param [in] engine_data Data to pass to engine function.
+ */
+void faux_async_set_engine(faux_async_t *async,
+	faux_async_engine_fn engine, void *engine_data)
+{
+	assert(async);
+	if (!async)
+		return;
+
+	async->engine = engine;
+	async->engine_data = engine_data;
+	async->fed = 0;
+	async->fed_errno = 0;
+}
+
+
+/** @brief Feeds data read by engine.
+ *
+ * The data is stored to input buffer. The "read" callback is executed by
+ * the following faux_async_in(). The len argument is a result of read
+ * operation: the number of bytes, 0 for end of file or -errno on error.
+ *
+ * @param [in] async Allocated and initialized async I/O object.
+ * @param [in] data Read data.
+ * @param [in] len Length of data, 0 for end of file or -errno on error.
+ * @return Length of stored data or < 0 on error.
+ */
+ssize_t faux_async_feed(faux_async_t *async, const void *data, ssize_t len)
+{
+	ssize_t bytes_stored = 0;
+
+	assert(async);
+	if (!async)
+		return -1;
+
+	if (len < 0) {
+		async->fed_errno = (int)(-len);
+		return 0;
+	}
+	if (0 == len)
+		return 0;
+	assert(data);
+	if (!data)
+		return -1;
+
+	bytes_stored = faux_buf_write(async->ibuf, data, len);
+	if (bytes_stored < 0)
+		return -1;
+	async->fed += bytes_stored;
+
+	return bytes_stored;
+}
@@ -12,10 +12,18 @@ struct faux_async_s {
 	void *read_udata;
 	size_t min;
 	size_t max;
+	size_t read_budget; // Max bytes to read by single faux_async_in()
+	bool_t in_pending; // Last faux_async_in() is stopped by budget
 	faux_buf_t *ibuf;
 
 	// Write
 	faux_async_stall_cb_fn stall_cb; // Stall callback
 	void *stall_udata;
 	faux_buf_t *obuf;
+
+	// Engine. Transfers data instead of read() and write().
+	faux_async_engine_fn engine; // Takes output data. NULL - no engine
+	void *engine_data;
+	size_t fed; // Data fed by engine since last faux_async_in()
+	int fed_errno; // Read error reported by engine
 };
@@ -189,3 +189,57 @@ parse_error:
 
 	return ret;
 }
+
+
+int testc_faux_async_read_budget(void)
+{
+	const size_t len = 10000;
+	const size_t budget = 4096;
+	char *src = NULL;
+	int ret = -1; // Pessimistic return value
+	faux_async_t *in = NULL;
+	int pipefd[2] = {-1, -1};
+	ssize_t r = 0;
+
+	src = faux_zmalloc(len);
+	if (pipe(pipefd) < 0)
+		goto parse_error;
+	if (write(pipefd[1], src, len) != (ssize_t)len)
+		goto parse_error;
+
+	in = faux_async_new(pipefd[0]);
+	faux_async_set_read_budget(in, budget);
+
+	// Two full budgets and the rest
+	if (((r = faux_async_in(in)) != (ssize_t)budget) ||
+		!faux_async_in_pending(in)) {
+		fprintf(stderr, "The first read is wrong: %zd\n", r);
+		goto parse_error;
+	}
+	if (((r = faux_async_in(in)) != (ssize_t)budget) ||
+		!faux_async_in_pending(in)) {
+		fprintf(stderr, "The second read is wrong: %zd\n", r);
+		goto parse_error;
+	}
+	if (((r = faux_async_in(in)) != (ssize_t)(len - 2 * budget)) ||
+		faux_async_in_pending(in)) {
+		fprintf(stderr, "The last read is wrong: %zd\n", r);
+		goto parse_error;
+	}
+	if (faux_buf_len(faux_async_ibuf(in)) != len) {
+		fprintf(stderr, "Wrong length of stored data\n");
+		goto parse_error;
+	}
+
+	ret = 0; // success
+
+parse_error:
+	if (pipefd[0] >= 0)
+		close(pipefd[0]);
+	if (pipefd[1] >= 0)
+		close(pipefd[1]);
+	faux_async_free(in);
+	faux_free(src);
+
+	return ret;
+}
@@ -5,13 +5,17 @@
 #ifndef _faux_eloop_h
 #define _faux_eloop_h
 
+#include <stdint.h>
 #include <poll.h>
 #include <signal.h>
+#include <sys/socket.h>
 
 #include <faux/faux.h>
 #include <faux/sched.h>
+#include <faux/async.h>
 
 typedef struct faux_eloop_s faux_eloop_t;
+typedef struct faux_eloop_group_s faux_eloop_group_t;
 
 typedef enum {
 	FAUX_ELOOP_NULL = 0,
@@ -20,6 +24,20 @@ typedef enum {
 	FAUX_ELOOP_FD = 3
 } faux_eloop_type_e;
 
+// Dispatch priority of file descriptor
+typedef enum {
+	FAUX_ELOOP_PRIO_HIGH = 0, // Dispatched first
+	FAUX_ELOOP_PRIO_NORMAL = 1, // Default
+	FAUX_ELOOP_PRIO_LOW = 2 // Dispatched after all others
+} faux_eloop_prio_e;
+
+// Mechanism to wait for file descriptor events
+typedef enum {
+	FAUX_ELOOP_BACKEND_POLL = 0, // Portable poll()/ppoll()
+	FAUX_ELOOP_BACKEND_EPOLL = 1, // Linux-specific epoll()
+	FAUX_ELOOP_BACKEND_URING = 2 // Linux-specific io_uring
+} faux_eloop_backend_e;
+
 typedef struct {
 	int ev_id;
 	faux_ev_t *ev;
@@ -34,19 +52,66 @@ typedef struct {
 	int signo;
 } faux_eloop_info_signal_t;
 
+// Number of buckets within histogram of callback durations
+#define FAUX_ELOOP_STATS_HIST_NUM 20
+
+// Statistics of callbacks. The hist[0] counts durations < 1us, hist[i]
+// counts durations within [2^(i-1), 2^i) us. The last bucket is unbounded.
+typedef struct {
+	uint64_t num; // Number of executed callbacks
+	struct timespec time; // Total duration of callbacks
+	struct timespec max; // Max duration of single callback
+	uint64_t hist[FAUX_ELOOP_STATS_HIST_NUM]; // Histogram of durations
+} faux_eloop_cb_stats_t;
+
+// Statistics of event loop. See faux_eloop_set_stats().
+typedef struct {
+	uint64_t iterations; // Number of loop iterations (waits)
+	struct timespec wait_time; // Total time spent within waiting
+	struct timespec cb_time; // Total time spent within callbacks
+	// Indexed by faux_eloop_type_e. FAUX_ELOOP_NULL stands for posted tasks
+	faux_eloop_cb_stats_t types[FAUX_ELOOP_FD + 1];
+	struct timespec slowest; // Duration of the slowest callback
+	faux_eloop_type_e slowest_type; // Type of the slowest callback
+	int slowest_id; // Its fd, signo or ev_id. -1 for posted task
+	ssize_t sched_num; // Number of processed scheduled events
+	struct timespec sched_lateness_avg; // See faux_sched_lateness()
+	struct timespec sched_lateness_max;
+} faux_eloop_stats_t;
+
+// Statistics of busy polling. See faux_eloop_set_busy_poll().
+typedef struct {
+	uint64_t hits; // Spins that have found events
+	uint64_t misses; // Spins that have given up and blocked
+	struct timespec spin_time; // Total time of spinning
+	struct timespec wasted_time; // Time of spins that have given up
+	struct timespec budget; // Current adaptive spin budget
+} faux_eloop_busy_stats_t;
+
 // Callback function prototype
 typedef bool_t (*faux_eloop_cb_fn)(faux_eloop_t *eloop, faux_eloop_type_e type,
 	void *associated_data, void *user_data);
 
+// Function to call within loop's thread
+typedef bool_t (*faux_eloop_call_fn)(faux_eloop_t *eloop, void *arg);
+
+// Callback for accepted connection. The fd belongs to callback.
+typedef bool_t (*faux_eloop_accept_fn)(faux_eloop_t *eloop, int fd,
+	void *user_data);
+
 
 C_DECL_BEGIN
 
 faux_eloop_t *faux_eloop_new(faux_eloop_cb_fn default_event_cb);
 void faux_eloop_free(faux_eloop_t *eloop);
 bool_t faux_eloop_loop(faux_eloop_t *eloop);
+bool_t faux_eloop_set_backend(faux_eloop_t *eloop, faux_eloop_backend_e backend);
+faux_eloop_backend_e faux_eloop_backend(const faux_eloop_t *eloop);
 
 bool_t faux_eloop_add_fd(faux_eloop_t *eloop, int fd, short events,
 	faux_eloop_cb_fn event_cb, void *user_data);
+bool_t faux_eloop_add_async(faux_eloop_t *eloop, faux_async_t *async,
+	faux_eloop_cb_fn event_cb, void *user_data);
 bool_t faux_eloop_del_fd(faux_eloop_t *eloop, int fd);
 bool_t faux_eloop_del_fd_all(faux_eloop_t *eloop);
 
@@ -68,8 +133,46 @@ faux_ev_t *faux_eloop_add_sched_periodic_delayed(faux_eloop_t *eloop,
 ssize_t faux_eloop_del_sched(faux_eloop_t *eloop, faux_ev_t *ev);
 ssize_t faux_eloop_del_sched_by_id(faux_eloop_t *eloop, int ev_id);
 bool_t faux_eloop_del_sched_all(faux_eloop_t *eloop);
+void faux_eloop_set_sched_limit(faux_eloop_t *eloop, unsigned int limit);
+bool_t faux_eloop_set_sched(faux_eloop_t *eloop, faux_sched_t *sched);
+bool_t faux_eloop_now(const faux_eloop_t *eloop, struct timespec *now);
+bool_t faux_eloop_set_coarse_time(faux_eloop_t *eloop, bool_t coarse);
+bool_t faux_eloop_post(faux_eloop_t *eloop, faux_eloop_call_fn fn, void *arg);
+bool_t faux_eloop_defer(faux_eloop_t *eloop, faux_eloop_call_fn fn, void *arg);
+bool_t faux_eloop_defer_idle(faux_eloop_t *eloop, faux_eloop_call_fn fn,
+	void *arg);
+ssize_t faux_eloop_sched_lateness(const faux_eloop_t *eloop,
+	struct timespec *avg, struct timespec *max);
+ssize_t faux_eloop_sched_saved_wakeups(const faux_eloop_t *eloop);
+bool_t faux_eloop_set_stats(faux_eloop_t *eloop, bool_t enable);
+bool_t faux_eloop_set_busy_poll(faux_eloop_t *eloop,
+	const struct timespec *budget);
+bool_t faux_eloop_busy_stats(const faux_eloop_t *eloop,
+	faux_eloop_busy_stats_t *stats);
+bool_t faux_eloop_stats(const faux_eloop_t *eloop, faux_eloop_stats_t *stats);
+bool_t faux_eloop_fd_stats(const faux_eloop_t *eloop, int fd,
+	faux_eloop_cb_stats_t *stats);
 bool_t faux_eloop_include_fd_event(faux_eloop_t *eloop, int fd, short event);
 bool_t faux_eloop_exclude_fd_event(faux_eloop_t *eloop, int fd, short event);
+bool_t faux_eloop_set_fd_prio(faux_eloop_t *eloop, int fd,
+	faux_eloop_prio_e prio);
+bool_t faux_eloop_requeue_fd(faux_eloop_t *eloop, int fd);
+
+// Group of loops. Each loop is served by its own thread.
+faux_eloop_group_t *faux_eloop_group_new(unsigned int num);
+void faux_eloop_group_free(faux_eloop_group_t *group);
+unsigned int faux_eloop_group_len(const faux_eloop_group_t *group);
+faux_eloop_t *faux_eloop_group_eloop(const faux_eloop_group_t *group,
+	unsigned int index);
+bool_t faux_eloop_group_start(faux_eloop_group_t *group);
+bool_t faux_eloop_group_stop(faux_eloop_group_t *group);
+bool_t faux_eloop_group_call(faux_eloop_group_t *group, unsigned int index,
+	faux_eloop_call_fn fn, void *arg);
+bool_t faux_eloop_group_add_listener(faux_eloop_group_t *group, int fd,
+	faux_eloop_accept_fn accept_cb, void *user_data);
+bool_t faux_eloop_group_listen(faux_eloop_group_t *group,
+	const struct sockaddr *addr, socklen_t addrlen,
+	faux_eloop_accept_fn accept_cb, void *user_data);
 
 C_DECL_END
 
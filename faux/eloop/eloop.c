@@ -10,6 +10,18 @@
  * of signal for signals, file descriptor and type of file event for file
  * descriptor events, event ID and pointer to special event object for scheduled
  * time events.
+ *
+ * The scheduled events are measured by CLOCK_MONOTONIC so wall-clock changes
+ * don't affect them. The loop reads the clock before and after waiting and
+ * caches the "loop time". The scheduler and callbacks use cached time while
+ * loop is working. See faux_eloop_now(). The absolute CLOCK_REALTIME time of
+ * event is converted to the loop time on adding. So faux_ev_time() of loop
+ * events returns monotonic time, not wall-clock one.
+ *
+ * The loop is not thread safe. But another thread can post task to loop by
+ * faux_eloop_post(). The tasks are kept within lock-free MPSC queue and loop
+ * is woken up by eventfd (or pipe). The series of tasks posted while loop is
+ * busy produces single wakeup. The loop executes all queued tasks at once.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -30,9 +42,13 @@
 #include <signal.h>
 #include <poll.h>
 #include <sys/signalfd.h>
+#ifdef HAVE_EVENTFD
+#include <sys/eventfd.h>
+#endif
 
 #include "faux/faux.h"
 #include "faux/str.h"
+#include "faux/time.h"
 #include "faux/net.h"
 #include "faux/sched.h"
 #include "faux/eloop.h"
@@ -41,6 +57,17 @@
 
 #define TIMESPEC_TO_MILISECONDS(t) ((t.tv_sec * 1000) + (t.tv_nsec / 1000000l))
 
+// Initial number of entries within fd table
+#define FDS_TABLE_MIN 64
+
+// Initial number of items within queue of deferred calls
+#define QUEUE_MIN 64
+
+// The spin budget grows from (max / BUSY_GROW_DIV) and it's dropped to zero
+// when it's less than (max / BUSY_DROP_DIV).
+#define BUSY_GROW_DIV 8
+#define BUSY_DROP_DIV 64
+
 #ifdef HAVE_SIGNALFD
 #define SIGNALFD_FLAGS (SFD_NONBLOCK | SFD_CLOEXEC)
 
@@ -70,111 +97,1374 @@ static void faux_eloop_static_sighandler(int signo)
 #endif
 
 
-/** @brief Callback compare function for fd list.
+/** @brief Callback compare function for signal list.
+ */
+static int faux_eloop_signal_compare(const void *first, const void *second)
+{
+	const faux_eloop_signal_t *f = (const faux_eloop_signal_t *)first;
+	const faux_eloop_signal_t *s = (const faux_eloop_signal_t *)second;
+
+	return (f->signo - s->signo);
+}
+
+
+/** @brief Callback compare function for signal list to search by key.
+ */
+static int faux_eloop_signal_kcompare(const void *key, const void *list_item)
+{
+	int *f = (int *)key;
+	const faux_eloop_signal_t *s = (const faux_eloop_signal_t *)list_item;
+
+	return (*f - s->signo);
+}
+
+
+/** @brief Gets registered fd entry from fd table.
+ *
+ * Static service function. The fd table is indexed by fd so lookup has
+ * constant cost.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] fd File descriptor.
+ * @return Pointer to fd entry or NULL if fd is not registered.
+ */
+static faux_eloop_fd_t *faux_eloop_fd_entry(const faux_eloop_t *eloop, int fd)
+{
+	faux_eloop_fd_t *entry = NULL;
+
+	if ((fd < 0) || ((size_t)fd >= eloop->fds_size))
+		return NULL;
+	entry = &eloop->fds[fd];
+	if (entry->fd < 0) // Unused entry
+		return NULL;
+
+	return entry;
+}
+
+
+/** @brief Grows fd table to hold specified fd.
+ *
+ * Static service function. Table grows geometrically to make registration
+ * cost amortized constant. New entries are marked as unused.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] fd File descriptor to hold.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+static bool_t faux_eloop_fds_grow(faux_eloop_t *eloop, int fd)
+{
+	faux_eloop_fd_t *new_fds = NULL;
+	size_t new_size = 0;
+	size_t i = 0;
+
+	if ((size_t)fd < eloop->fds_size)
+		return BOOL_TRUE;
+
+	new_size = eloop->fds_size ? eloop->fds_size : FDS_TABLE_MIN;
+	while (new_size <= (size_t)fd)
+		new_size *= 2;
+	new_fds = realloc(eloop->fds, new_size * sizeof(*new_fds));
+	assert(new_fds);
+	if (!new_fds)
+		return BOOL_FALSE;
+	for (i = eloop->fds_size; i < new_size; i++) {
+		faux_bzero(&new_fds[i], sizeof(new_fds[i]));
+		new_fds[i].fd = -1;
+	}
+	eloop->fds = new_fds;
+	eloop->fds_size = new_size;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Starts to watch file descriptor using current backend.
+ *
+ * Static service function. Don't use it for already watched fd. Note
+ * poll() and epoll() have the same values for POLLIN/EPOLLIN,
+ * POLLOUT/EPOLLOUT etc. on Linux. So events mask is passed as is.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] fd File descriptor to watch.
+ * @param [in] events File events mask like POLLIN, POLLOUT.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+static bool_t faux_eloop_watch(faux_eloop_t *eloop, int fd, short events)
+{
+#ifdef HAVE_EPOLL_PWAIT
+	if (FAUX_ELOOP_BACKEND_EPOLL == eloop->backend) {
+		struct epoll_event ev = {};
+
+		ev.events = (unsigned short)events;
+		ev.data.fd = fd;
+		if (epoll_ctl(eloop->epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0)
+			return BOOL_FALSE;
+		return BOOL_TRUE;
+	}
+#endif
+#ifdef HAVE_IO_URING
+	if (FAUX_ELOOP_BACKEND_URING == eloop->backend)
+		return faux_eloop_uring_watch(eloop->uring, fd, events);
+#endif
+
+	if (!faux_pollfd_add(eloop->pollfds, fd, events))
+		return BOOL_FALSE;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Changes events mask of already watched file descriptor.
+ *
+ * Static service function.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] fd File descriptor.
+ * @param [in] events New file events mask.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+static bool_t faux_eloop_rewatch(faux_eloop_t *eloop, int fd, short events)
+{
+#ifdef HAVE_EPOLL_PWAIT
+	if (FAUX_ELOOP_BACKEND_EPOLL == eloop->backend) {
+		struct epoll_event ev = {};
+
+		ev.events = (unsigned short)events;
+		ev.data.fd = fd;
+		if (epoll_ctl(eloop->epoll_fd, EPOLL_CTL_MOD, fd, &ev) < 0)
+			return BOOL_FALSE;
+		return BOOL_TRUE;
+	}
+#endif
+#ifdef HAVE_IO_URING
+	// The old poll request is replaced by the new one
+	if (FAUX_ELOOP_BACKEND_URING == eloop->backend)
+		return faux_eloop_uring_watch(eloop->uring, fd, events);
+#endif
+
+	// The faux_pollfd_add() replaces events mask of existent item
+	if (!faux_pollfd_add(eloop->pollfds, fd, events))
+		return BOOL_FALSE;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Stops to watch file descriptor.
+ *
+ * Static service function.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] fd File descriptor.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+static bool_t faux_eloop_unwatch(faux_eloop_t *eloop, int fd)
+{
+#ifdef HAVE_EPOLL_PWAIT
+	if (FAUX_ELOOP_BACKEND_EPOLL == eloop->backend) {
+		// The fd can be already closed by user. Closed fd is removed
+		// from epoll set automatically so error is not a problem.
+		epoll_ctl(eloop->epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+		return BOOL_TRUE;
+	}
+#endif
+#ifdef HAVE_IO_URING
+	if (FAUX_ELOOP_BACKEND_URING == eloop->backend)
+		return faux_eloop_uring_unwatch(eloop->uring, fd);
+#endif
+
+	return faux_pollfd_del_by_fd(eloop->pollfds, fd);
+}
+
+
+#ifdef HAVE_IO_URING
+/** @brief Engine function of async object served by io_uring backend.
+ *
+ * Static service function. It's called by faux_async_out().
+ *
+ * @param [in] async Async object.
+ * @param [in] engine_data Event loop object.
+ * @return Length of data taken to write or < 0 on error.
+ */
+static ssize_t faux_eloop_async_engine(faux_async_t *async, void *engine_data)
+{
+	faux_eloop_t *eloop = (faux_eloop_t *)engine_data;
+
+	return faux_eloop_uring_async_out(eloop->uring, faux_async_fd(async));
+}
+#endif
+
+
+/** @brief Starts to serve async object using current backend.
+ *
+ * Static service function. The io_uring backend reads and writes fd by
+ * itself. Other backends just watch fd.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] async Async object.
+ * @param [in] events File events mask to watch by poll-like backends.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+static bool_t faux_eloop_watch_async(faux_eloop_t *eloop,
+	faux_async_t *async, short events)
+{
+#ifdef HAVE_IO_URING
+	if (FAUX_ELOOP_BACKEND_URING == eloop->backend) {
+		if (!faux_eloop_uring_add_async(eloop->uring, async))
+			return BOOL_FALSE;
+		faux_async_set_engine(async, faux_eloop_async_engine, eloop);
+		// Data written before registration
+		faux_async_out(async);
+		return BOOL_TRUE;
+	}
+#endif
+
+	faux_async_set_engine(async, NULL, NULL);
+
+	return faux_eloop_watch(eloop, faux_async_fd(async), events);
+}
+
+
+/** @brief Stops to serve async object.
+ *
+ * Static service function.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] async Async object.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+static bool_t faux_eloop_unwatch_async(faux_eloop_t *eloop,
+	faux_async_t *async)
+{
+	faux_async_set_engine(async, NULL, NULL);
+#ifdef HAVE_IO_URING
+	if (FAUX_ELOOP_BACKEND_URING == eloop->backend)
+		return faux_eloop_uring_del_async(eloop->uring,
+			faux_async_fd(async));
+#endif
+
+	return faux_eloop_unwatch(eloop, faux_async_fd(async));
+}
+
+
+/** @brief Checks if fd entry is async object served by backend itself.
+ *
+ * Static service function.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] entry Fd entry.
+ * @return BOOL_TRUE if backend reads and writes fd by itself.
+ */
+static bool_t faux_eloop_async_served(const faux_eloop_t *eloop,
+	const faux_eloop_fd_t *entry)
+{
+#ifdef HAVE_IO_URING
+	if (entry->async && (FAUX_ELOOP_BACKEND_URING == eloop->backend))
+		return BOOL_TRUE;
+#else
+	eloop = eloop; // Happy compiler
+	entry = entry;
+#endif
+
+	return BOOL_FALSE;
+}
+
+
+#ifdef HAVE_EPOLL_PWAIT
+/** @brief Converts timeout to milliseconds for epoll_pwait().
+ *
+ * Static service function. The value is rounded up. Else loop will wake up
+ * before scheduled event and will spin until event time.
+ *
+ * @param [in] timeout Timeout. NULL means infinite.
+ * @return Timeout in milliseconds or -1 for infinite timeout.
+ */
+static int faux_eloop_timeout_ms(const struct timespec *timeout)
+{
+	if (!timeout)
+		return -1;
+
+	return (timeout->tv_sec * 1000) +
+		((timeout->tv_nsec + 999999l) / 1000000l);
+}
+#endif
+
+
+/** @brief Updates cached loop time.
+ *
+ * Static service function. Reads the loop clock and passes the time to
+ * scheduler so scheduler doesn't read the clock by itself.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ */
+static void faux_eloop_update_now(faux_eloop_t *eloop)
+{
+	clock_gettime(eloop->clock, &eloop->now);
+	faux_sched_set_now(eloop->sched, &eloop->now);
+}
+
+
+/** @brief Gets start time of measured interval.
+ *
+ * Static service function. Statistics use precise monotonic clock
+ * regardless of coarse loop time. The time is not read if statistics are
+ * disabled.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [out] start Start time.
+ */
+static void faux_eloop_stats_start(const faux_eloop_t *eloop,
+	struct timespec *start)
+{
+	if (!eloop->stats)
+		return;
+
+	clock_gettime(CLOCK_MONOTONIC, start);
+}
+
+
+/** @brief Gets interval since start time.
+ *
+ * Static service function.
+ *
+ * @param [in] start Start time.
+ * @param [out] duration Interval.
+ */
+static void faux_eloop_stats_duration(const struct timespec *start,
+	struct timespec *duration)
+{
+	struct timespec stop = {};
+
+	clock_gettime(CLOCK_MONOTONIC, &stop);
+	if (!faux_timespec_diff(duration, &stop, start))
+		faux_nsec_to_timespec(duration, 0);
+}
+
+
+/** @brief Accounts callback duration within callback statistics.
+ *
+ * Static service function.
+ *
+ * @param [in] cb_stats Callback statistics.
+ * @param [in] duration Duration of callback.
+ */
+static void faux_eloop_cb_stats_add(faux_eloop_cb_stats_t *cb_stats,
+	const struct timespec *duration)
+{
+	uint64_t usec = faux_timespec_to_nsec(duration) / 1000;
+	unsigned int bucket = 0;
+
+	while ((usec > 0) && (bucket < (FAUX_ELOOP_STATS_HIST_NUM - 1))) {
+		usec >>= 1;
+		bucket++;
+	}
+	cb_stats->hist[bucket]++;
+	cb_stats->num++;
+	faux_timespec_sum(&cb_stats->time, &cb_stats->time, duration);
+	if (faux_timespec_cmp(duration, &cb_stats->max) > 0)
+		cb_stats->max = *duration;
+}
+
+
+/** @brief Accounts finished callback.
+ *
+ * Static service function. Does nothing if statistics are disabled. The
+ * fd callbacks are accounted within per-fd statistics too if fd is still
+ * registered. Callback can unregister fd and register another one with the
+ * same number. So registration number captured before callback is checked.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] type Type of event.
+ * @param [in] id File descriptor, signal number, event ID or -1.
+ * @param [in] gen Registration number of fd. Used for FAUX_ELOOP_FD only.
+ * @param [in] start Start time of callback.
+ */
+static void faux_eloop_stats_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	int id, uint64_t gen, const struct timespec *start)
+{
+	faux_eloop_stats_t *stats = eloop->stats;
+	struct timespec duration = {};
+	faux_eloop_fd_t *entry = NULL;
+
+	if (!stats)
+		return;
+
+	faux_eloop_stats_duration(start, &duration);
+	faux_timespec_sum(&stats->cb_time, &stats->cb_time, &duration);
+	faux_eloop_cb_stats_add(&stats->types[type], &duration);
+	if (faux_timespec_cmp(&duration, &stats->slowest) > 0) {
+		stats->slowest = duration;
+		stats->slowest_type = type;
+		stats->slowest_id = id;
+	}
+
+	if (type != FAUX_ELOOP_FD)
+		return;
+	entry = faux_eloop_fd_entry(eloop, id);
+	if (!entry || (entry->gen != gen)) // Callback has removed fd
+		return;
+	if (!entry->stats)
+		entry->stats = faux_zmalloc(sizeof(*entry->stats));
+	if (!entry->stats)
+		return;
+	faux_eloop_cb_stats_add(entry->stats, &duration);
+}
+
+
+/** @brief Accounts finished wait.
+ *
+ * Static service function. Does nothing if statistics are disabled.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] start Start time of wait.
+ */
+static void faux_eloop_stats_wait(faux_eloop_t *eloop,
+	const struct timespec *start)
+{
+	faux_eloop_stats_t *stats = eloop->stats;
+	struct timespec duration = {};
+
+	if (!stats)
+		return;
+
+	faux_eloop_stats_duration(start, &duration);
+	faux_timespec_sum(&stats->wait_time, &stats->wait_time, &duration);
+	stats->iterations++;
+}
+
+
+/** @brief Pushes task to MPSC queue.
+ *
+ * Static service function. It's thread safe. The producer exchanges the
+ * head of queue and then links previous head to the new item. The queue is
+ * inconsistent between these two steps. The consumer sees that and doesn't
+ * take items after the break.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] post Task to push.
+ */
+static void faux_eloop_post_push(faux_eloop_t *eloop, faux_eloop_post_t *post)
+{
+	faux_eloop_post_t *prev = NULL;
+
+	__atomic_store_n(&post->next, NULL, __ATOMIC_RELAXED);
+	prev = __atomic_exchange_n(&eloop->post_head, post, __ATOMIC_ACQ_REL);
+	__atomic_store_n(&prev->next, post, __ATOMIC_RELEASE);
+}
+
+
+/** @brief Pops task from MPSC queue.
+ *
+ * Static service function. Must be used by loop's thread only. The stub item
+ * is pushed back when the last item is taken. So queue is never empty.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @return Task or NULL if queue is empty or producer didn't finish push.
+ */
+static faux_eloop_post_t *faux_eloop_post_pop(faux_eloop_t *eloop)
+{
+	faux_eloop_post_t *tail = eloop->post_tail;
+	faux_eloop_post_t *next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+
+	if (tail == &eloop->post_stub) {
+		if (!next)
+			return NULL;
+		eloop->post_tail = next;
+		tail = next;
+		next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+	}
+	if (next) {
+		eloop->post_tail = next;
+		return tail;
+	}
+	if (tail != __atomic_load_n(&eloop->post_head, __ATOMIC_ACQUIRE))
+		return NULL; // Producer didn't finish push
+	faux_eloop_post_push(eloop, &eloop->post_stub);
+	next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+	if (next) {
+		eloop->post_tail = next;
+		return tail;
+	}
+
+	return NULL;
+}
+
+
+/** @brief Adds call to the tail of deferred calls queue.
+ *
+ * Static service function. The queue storage grows geometrically and it's
+ * never shrinked. So memory is not allocated when queue is used steadily.
+ *
+ * @param [in] queue Queue of deferred calls.
+ * @param [in] fn Function to call.
+ * @param [in] arg Argument for function.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+static bool_t faux_eloop_queue_push(faux_eloop_queue_t *queue,
+	faux_eloop_call_fn fn, void *arg)
+{
+	faux_eloop_call_t *call = NULL;
+
+	if (queue->len == queue->size) {
+		size_t new_size = queue->size ? (queue->size * 2) : QUEUE_MIN;
+		faux_eloop_call_t *new_calls = NULL;
+
+		new_calls = realloc(queue->calls, new_size * sizeof(*new_calls));
+		if (!new_calls)
+			return BOOL_FALSE;
+		// Unwrap the calls stored at the beginning of old storage
+		if ((queue->head + queue->len) > queue->size)
+			memcpy(&new_calls[queue->size], new_calls,
+				(queue->head + queue->len - queue->size) *
+				sizeof(*new_calls));
+		queue->calls = new_calls;
+		queue->size = new_size;
+	}
+
+	call = &queue->calls[(queue->head + queue->len) % queue->size];
+	call->fn = fn;
+	call->arg = arg;
+	queue->len++;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Executes calls that are queued at the moment.
+ *
+ * Static service function. The calls queued by executed functions will be
+ * executed on the next invocation. So functions that queue themselves
+ * can't block the loop.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] queue Queue of deferred calls.
+ * @return BOOL_FALSE if any call wants to break the loop else BOOL_TRUE.
+ */
+static bool_t faux_eloop_dispatch_queue(faux_eloop_t *eloop,
+	faux_eloop_queue_t *queue)
+{
+	bool_t retval = BOOL_TRUE;
+	size_t num = queue->len;
+	struct timespec start = {};
+
+	while (num-- > 0) {
+		faux_eloop_call_t call = queue->calls[queue->head];
+
+		queue->head = (queue->head + 1) % queue->size;
+		queue->len--;
+		// BOOL_FALSE return value means "break the loop"
+		faux_eloop_stats_start(eloop, &start);
+		if (!call.fn(eloop, call.arg))
+			retval = BOOL_FALSE;
+		faux_eloop_stats_cb(eloop, FAUX_ELOOP_NULL, -1, 0, &start);
+	}
+
+	return retval;
+}
+
+
+/** @brief Opens file descriptors to wake up loop on posted tasks.
+ *
+ * Static service function. It uses eventfd if available else pipe. Both
+ * ends of pipe are non-blocking. The descriptors are -1 on error.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+static bool_t faux_eloop_post_open(faux_eloop_t *eloop)
+{
+#ifdef HAVE_EVENTFD
+	eloop->post_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	eloop->post_wfd = eloop->post_fd;
+	if (eloop->post_fd < 0)
+		return BOOL_FALSE;
+#else
+	int post_pipe[2] = {-1, -1};
+	unsigned int i = 0;
+
+	eloop->post_fd = -1;
+	eloop->post_wfd = -1;
+	if (pipe(post_pipe) < 0)
+		return BOOL_FALSE;
+	for (i = 0; i < 2; i++) {
+		int fflags = fcntl(post_pipe[i], F_GETFL);
+		if ((fflags < 0) ||
+			(fcntl(post_pipe[i], F_SETFL, fflags | O_NONBLOCK) < 0) ||
+			(fcntl(post_pipe[i], F_SETFD, FD_CLOEXEC) < 0)) {
+			close(post_pipe[0]);
+			close(post_pipe[1]);
+			return BOOL_FALSE;
+		}
+	}
+	eloop->post_fd = post_pipe[0];
+	eloop->post_wfd = post_pipe[1];
+#endif
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Create new event loop object.
+ *
+ * Function gets default event callback as argument. It will be used for all
+ * events if private callback for event is not specified.
+ *
+ * @param [in] default_event_cb Default event callback.
+ * @return Allocated faux_eloop_t object or NULL on error.
+ */
+faux_eloop_t *faux_eloop_new(faux_eloop_cb_fn default_event_cb)
+{
+	faux_eloop_t *eloop = NULL;
+
+	eloop = faux_zmalloc(sizeof(*eloop));
+	assert(eloop);
+	if (!eloop)
+		return NULL;
+
+	// Init
+	eloop->working = BOOL_FALSE;
+	eloop->default_event_cb = default_event_cb;
+	eloop->sched_limit = 0; // Unlimited
+
+	// Sched
+	eloop->clock = CLOCK_MONOTONIC;
+	clock_gettime(eloop->clock, &eloop->now);
+	eloop->sched = faux_sched_new();
+	assert(eloop->sched);
+	faux_sched_set_clock(eloop->sched, CLOCK_MONOTONIC);
+
+	// FD
+	eloop->fds = NULL;
+	eloop->fds_size = 0;
+	eloop->fds_num = 0;
+	eloop->fds_gen = 0;
+	eloop->backend = FAUX_ELOOP_BACKEND_POLL;
+	eloop->pollfds = faux_pollfd_new();
+	assert(eloop->pollfds);
+#ifdef HAVE_EPOLL_PWAIT
+	eloop->epoll_fd = -1;
+#endif
+#ifdef HAVE_IO_URING
+	eloop->uring = NULL;
+#endif
+
+	// Signal
+	eloop->signals = faux_list_new(FAUX_LIST_SORTED, FAUX_LIST_UNIQUE,
+		faux_eloop_signal_compare, faux_eloop_signal_kcompare, faux_free);
+	assert(eloop->signals);
+	sigemptyset(&eloop->sig_set);
+	sigfillset(&eloop->sig_mask);
+#ifdef HAVE_SIGNALFD
+	eloop->signal_fd = -1;
+#endif
+
+	// Statistics
+	eloop->stats = NULL;
+
+	// Dispatch
+	eloop->prio_fds = 0;
+	eloop->ready = NULL;
+	eloop->ready_size = 0;
+	eloop->ready_num = 0;
+	eloop->ready_seq = 0;
+	eloop->requeue = NULL;
+	eloop->requeue_size = 0;
+	eloop->requeue_num = 0;
+
+	// Busy polling
+	eloop->busy_max = 0;
+	eloop->busy_budget = 0;
+	faux_bzero(&eloop->busy_stats, sizeof(eloop->busy_stats));
+
+	// Deferred calls
+	faux_bzero(&eloop->defer, sizeof(eloop->defer));
+	faux_bzero(&eloop->idle, sizeof(eloop->idle));
+
+	// Posted tasks
+	eloop->post_stub.next = NULL;
+	eloop->post_head = &eloop->post_stub;
+	eloop->post_tail = &eloop->post_stub;
+	eloop->post_signaled = 0;
+	if (!faux_eloop_post_open(eloop)) {
+		faux_eloop_free(eloop);
+		return NULL;
+	}
+
+	return eloop;
+}
+
+
+/** @brief Free event loop object.
+ *
+ * @param [in] Event loop object.
+ */
+void faux_eloop_free(faux_eloop_t *eloop)
+{
+	faux_eloop_post_t *post = NULL;
+	size_t i = 0;
+
+	if (!eloop)
+		return;
+
+	// Tasks are not executed but their arguments must be freed
+	while ((post = faux_eloop_post_pop(eloop))) {
+		if (post->free_arg_cb)
+			post->free_arg_cb(post->arg);
+		faux_free(post);
+	}
+	if (eloop->post_fd >= 0)
+		close(eloop->post_fd);
+	if (eloop->post_wfd != eloop->post_fd)
+		close(eloop->post_wfd);
+
+	faux_list_free(eloop->signals);
+	// Async objects can outlive the loop
+	for (i = 0; i < eloop->fds_size; i++) {
+		if ((eloop->fds[i].fd >= 0) && eloop->fds[i].async)
+			faux_async_set_engine(eloop->fds[i].async, NULL, NULL);
+	}
+#ifdef HAVE_EPOLL_PWAIT
+	if (eloop->epoll_fd >= 0)
+		close(eloop->epoll_fd);
+#endif
+#ifdef HAVE_IO_URING
+	faux_eloop_uring_free(eloop->uring);
+#endif
+	faux_eloop_set_stats(eloop, BOOL_FALSE);
+	faux_free(eloop->defer.calls);
+	faux_free(eloop->idle.calls);
+	faux_free(eloop->ready);
+	faux_free(eloop->requeue);
+	faux_pollfd_free(eloop->pollfds);
+	faux_free(eloop->fds);
+	faux_sched_free(eloop->sched);
+
+	faux_free(eloop);
+}
+
+
+/** @brief Sets mechanism to wait for file descriptor events.
+ *
+ * The poll() (ppoll()) backend is portable and it's used by default. It
+ * passes the whole vector of registered file descriptors to kernel on each
+ * iteration and then walks through the whole vector to find active entries.
+ * The epoll() backend is Linux-specific. It keeps set of registered file
+ * descriptors within kernel and returns ready entries only. So the cost of
+ * wakeup depends on number of ready fds but not on number of registered fds.
+ * It's usefull for loops with a lot of mostly idle file descriptors.
+ * The io_uring backend is Linux-specific too. It watches file descriptors
+ * by poll requests. The changes of watched set are queued and submitted in
+ * a batch together with waiting for completions. So each loop iteration
+ * costs single syscall regardless of how many fds were added or removed.
+ * The backend is unsupported if kernel doesn't provide io_uring.
+ *
+ * Backend can't be changed while loop is active. Already registered file
+ * descriptors will be moved to the new backend. Note epoll() and io_uring
+ * backends track the underlying open file description. So closed fd with
+ * the living duplicates (dup(), fork()) must be unregistered by
+ * faux_eloop_del_fd() before closing. The data of async objects (see
+ * faux_eloop_add_async()) that is being written by io_uring backend is
+ * dropped on backend change.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] backend Backend to use.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error or unsupported backend.
+ */
+bool_t faux_eloop_set_backend(faux_eloop_t *eloop, faux_eloop_backend_e backend)
+{
+	size_t i = 0;
+
+	assert(eloop);
+	if (!eloop)
+		return BOOL_FALSE;
+	if (eloop->working) // Can't change backend on the fly
+		return BOOL_FALSE;
+	if (eloop->backend == backend)
+		return BOOL_TRUE;
+
+	// Create new backend
+	switch (backend) {
+	case FAUX_ELOOP_BACKEND_POLL:
+		break;
+#ifdef HAVE_EPOLL_PWAIT
+	case FAUX_ELOOP_BACKEND_EPOLL:
+		eloop->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+		if (eloop->epoll_fd < 0)
+			return BOOL_FALSE;
+		break;
+#endif
+#ifdef HAVE_IO_URING
+	case FAUX_ELOOP_BACKEND_URING:
+		eloop->uring = faux_eloop_uring_new();
+		if (!eloop->uring)
+			return BOOL_FALSE;
+		break;
+#endif
+	default: // Unsupported backend
+		return BOOL_FALSE;
+	}
+
+	// Destroy old backend
+	switch (eloop->backend) {
+	case FAUX_ELOOP_BACKEND_POLL:
+		faux_pollfd_del_all(eloop->pollfds);
+		break;
+#ifdef HAVE_EPOLL_PWAIT
+	case FAUX_ELOOP_BACKEND_EPOLL:
+		close(eloop->epoll_fd);
+		eloop->epoll_fd = -1;
+		break;
+#endif
+#ifdef HAVE_IO_URING
+	case FAUX_ELOOP_BACKEND_URING:
+		faux_eloop_uring_free(eloop->uring);
+		eloop->uring = NULL;
+		break;
+#endif
+	default:
+		break;
+	}
+	eloop->backend = backend;
+
+	// Register file descriptors within new backend
+	for (i = 0; i < eloop->fds_size; i++) {
+		faux_eloop_fd_t *entry = &eloop->fds[i];
+		if (entry->fd < 0)
+			continue;
+		if (entry->async)
+			faux_eloop_watch_async(eloop, entry->async,
+				entry->events);
+		else
+			faux_eloop_watch(eloop, entry->fd, entry->events);
+	}
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Gets current backend of event loop.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @return Current backend.
+ */
+faux_eloop_backend_e faux_eloop_backend(const faux_eloop_t *eloop)
+{
+	assert(eloop);
+	if (!eloop)
+		return FAUX_ELOOP_BACKEND_POLL;
+
+	return eloop->backend;
+}
+
+
+/** @brief Reads service signal descriptor and executes signal callbacks.
+ *
+ * Static service function.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] fd Signalfd or read end of signal pipe.
+ * @return BOOL_FALSE if any callback wants to break the loop else BOOL_TRUE.
+ */
+static bool_t faux_eloop_dispatch_signals(faux_eloop_t *eloop, int fd)
+{
+	bool_t retval = BOOL_TRUE;
+	struct timespec start = {};
+#ifdef HAVE_SIGNALFD
+	struct signalfd_siginfo signal_info = {};
+
+	while (faux_read(fd, &signal_info,
+		sizeof(signal_info)) == sizeof(signal_info)) {
+		int signo = signal_info.ssi_signo;
+#else
+	int tmp = 0;
+
+	while (faux_read(fd, &tmp, sizeof(tmp)) == sizeof(tmp)) {
+		int signo = tmp;
+#endif // HAVE_SIGNALFD
+		faux_eloop_info_signal_t sinfo = {};
+		faux_eloop_cb_fn event_cb = NULL;
+		faux_eloop_signal_t *sentry =
+			(faux_eloop_signal_t *)faux_list_kfind(
+			eloop->signals, &signo);
+
+		if (!sentry) // Not registered signal. Drop it.
+			continue;
+		event_cb = sentry->context.event_cb;
+		if (!event_cb)
+			event_cb = eloop->default_event_cb;
+		if (!event_cb) // Callback is not defined
+			continue;
+		sinfo.signo = signo;
+
+		// Execute callback
+		// BOOL_FALSE return value means "break the loop"
+		faux_eloop_stats_start(eloop, &start);
+		if (!event_cb(eloop, FAUX_ELOOP_SIGNAL, &sinfo,
+			sentry->context.user_data))
+			retval = BOOL_FALSE;
+		faux_eloop_stats_cb(eloop, FAUX_ELOOP_SIGNAL, signo, 0, &start);
+	}
+
+	return retval;
+}
+
+
+/** @brief Executes all posted tasks.
+ *
+ * Static service function. The wakeup flag is cleared before queue reading.
+ * So task posted after that will wake up loop again.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @return BOOL_FALSE if any task wants to break the loop else BOOL_TRUE.
+ */
+static bool_t faux_eloop_dispatch_posts(faux_eloop_t *eloop)
+{
+	bool_t retval = BOOL_TRUE;
+	faux_eloop_post_t *post = NULL;
+	struct timespec start = {};
+#ifdef HAVE_EVENTFD
+	uint64_t counter = 0;
+
+	faux_read(eloop->post_fd, &counter, sizeof(counter));
+#else
+	char buf[64];
+
+	while (read(eloop->post_fd, buf, sizeof(buf)) > 0);
+#endif
+
+	__atomic_exchange_n(&eloop->post_signaled, 0, __ATOMIC_ACQ_REL);
+	while ((post = faux_eloop_post_pop(eloop))) {
+		faux_eloop_call_fn fn = post->fn;
+		void *arg = post->arg;
+
+		faux_free(post);
+		// BOOL_FALSE return value means "break the loop"
+		faux_eloop_stats_start(eloop, &start);
+		if (!fn(eloop, arg))
+			retval = BOOL_FALSE;
+		faux_eloop_stats_cb(eloop, FAUX_ELOOP_NULL, -1, 0, &start);
+	}
+
+	return retval;
+}
+
+
+/** @brief Executes callback for active file descriptor.
+ *
+ * Static service function.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] fd Active file descriptor.
+ * @param [in] revents Returned events.
+ * @return BOOL_FALSE if callback wants to break the loop else BOOL_TRUE.
+ */
+static bool_t faux_eloop_dispatch_fd(faux_eloop_t *eloop, int fd, short revents)
+{
+	faux_eloop_info_fd_t info = {};
+	faux_eloop_cb_fn event_cb = NULL;
+	faux_eloop_fd_t *entry = NULL;
+	struct timespec start = {};
+	uint64_t gen = 0;
+	bool_t r = BOOL_TRUE;
+
+	entry = faux_eloop_fd_entry(eloop, fd);
+	if (!entry) // Can be removed by previous callback
+		return BOOL_TRUE;
+	event_cb = entry->context.event_cb;
+	if (!event_cb)
+		event_cb = eloop->default_event_cb;
+	if (!event_cb) // Callback function is not defined for this event
+		return BOOL_TRUE;
+	info.fd = fd;
+	info.revents = revents;
+	entry->revents = revents;
+	gen = entry->gen;
+
+	// Execute callback. Note callback can register new fds so fd table
+	// can be reallocated. Don't use entry pointer after callback.
+	faux_eloop_stats_start(eloop, &start);
+	r = event_cb(eloop, FAUX_ELOOP_FD, &info, entry->context.user_data);
+	faux_eloop_stats_cb(eloop, FAUX_ELOOP_FD, fd, gen, &start);
+
+	return r;
+}
+
+
+/** @brief Waits for fd events using current backend.
+ *
+ * Static service function.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] timeout Timeout. NULL for infinite timeout.
+ * @param [in] sigmask Signal mask to set while waiting. Can be NULL.
+ * @return Number of ready fds, 0 on timeout, < 0 on error.
+ */
+static int faux_eloop_wait(faux_eloop_t *eloop,
+	const struct timespec *timeout, const sigset_t *sigmask)
+{
+#ifndef HAVE_PPOLL
+	int sn = 0;
+	sigset_t blocked_signals;
+#endif
+
+#ifdef HAVE_EPOLL_PWAIT
+	if (FAUX_ELOOP_BACKEND_EPOLL == eloop->backend)
+		return epoll_pwait(eloop->epoll_fd, eloop->epoll_events,
+			EPOLL_EVENTS_NUM, faux_eloop_timeout_ms(timeout),
+			sigmask);
+#endif // HAVE_EPOLL_PWAIT
+#ifdef HAVE_IO_URING
+	if (FAUX_ELOOP_BACKEND_URING == eloop->backend)
+		return faux_eloop_uring_wait(eloop->uring, timeout, sigmask);
+#endif // HAVE_IO_URING
+
+#ifdef HAVE_PPOLL
+	return ppoll(faux_pollfd_vector(eloop->pollfds),
+		faux_pollfd_len(eloop->pollfds), timeout, sigmask);
+#else // poll()
+	sigprocmask(SIG_SETMASK, &eloop->sig_mask, &blocked_signals);
+	sn = poll(faux_pollfd_vector(eloop->pollfds),
+		faux_pollfd_len(eloop->pollfds),
+		timeout ? TIMESPEC_TO_MILISECONDS((*timeout)) : -1);
+	sigprocmask(SIG_SETMASK, &blocked_signals, NULL);
+	sigmask = sigmask; // Happy compiler
+
+	return sn;
+#endif // HAVE_PPOLL
+}
+
+
+/** @brief Grows adaptive spin budget.
+ *
+ * Static service function.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ */
+static void faux_eloop_busy_grow(faux_eloop_t *eloop)
+{
+	uint64_t budget = eloop->busy_budget * 2;
+
+	if (0 == budget)
+		budget = eloop->busy_max / BUSY_GROW_DIV;
+	if (0 == budget)
+		budget = 1;
+	if (budget > eloop->busy_max)
+		budget = eloop->busy_max;
+	eloop->busy_budget = budget;
+}
+
+
+/** @brief Shrinks adaptive spin budget.
+ *
+ * Static service function.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
  */
-static int faux_eloop_fd_compare(const void *first, const void *second)
+static void faux_eloop_busy_shrink(faux_eloop_t *eloop)
 {
-	const faux_eloop_fd_t *f = (const faux_eloop_fd_t *)first;
-	const faux_eloop_fd_t *s = (const faux_eloop_fd_t *)second;
-
-	return (f->fd - s->fd);
+	eloop->busy_budget /= 2;
+	if (eloop->busy_budget < (eloop->busy_max / BUSY_DROP_DIV))
+		eloop->busy_budget = 0;
 }
 
 
-/** @brief Callback compare function for fd list to search by key.
+/** @brief Waits for fd events with busy polling.
+ *
+ * Static service function. Spins with non-blocking waits while spin budget
+ * is not exhausted and then blocks for the rest of timeout. The budget is
+ * grown when spin finds events or when event comes soon after spin has
+ * given up. The budget is shrinked when spin gives up. So loop spins while
+ * events are frequent and sleeps when they are rare. Without busy poll
+ * mode it's the same as faux_eloop_wait().
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] timeout Timeout. NULL for infinite timeout.
+ * @param [in] sigmask Signal mask to set while waiting. Can be NULL.
+ * @return Number of ready fds, 0 on timeout, < 0 on error.
  */
-static int faux_eloop_fd_kcompare(const void *key, const void *list_item)
+static int faux_eloop_busy_wait(faux_eloop_t *eloop,
+	const struct timespec *timeout, const sigset_t *sigmask)
 {
-	int *f = (int *)key;
-	const faux_eloop_fd_t *s = (const faux_eloop_fd_t *)list_item;
+	faux_eloop_busy_stats_t *stats = &eloop->busy_stats;
+	struct timespec zero = {};
+	struct timespec start = {};
+	struct timespec now = {};
+	struct timespec spent = {};
+	struct timespec rest = {};
+	uint64_t budget = eloop->busy_budget;
+	uint64_t spent_nsec = 0;
+	int sn = 0;
+
+	if ((0 == eloop->busy_max) ||
+		(timeout && (0 == faux_timespec_to_nsec(timeout))))
+		return faux_eloop_wait(eloop, timeout, sigmask);
+	if (timeout && (faux_timespec_to_nsec(timeout) < budget))
+		budget = faux_timespec_to_nsec(timeout);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	if (budget > 0) {
+		do {
+			sn = faux_eloop_wait(eloop, &zero, sigmask);
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			faux_timespec_diff(&spent, &now, &start);
+			spent_nsec = faux_timespec_to_nsec(&spent);
+		} while ((0 == sn) && (spent_nsec < budget));
+		faux_timespec_sum(&stats->spin_time, &stats->spin_time,
+			&spent);
+		if (sn != 0) { // Events or error
+			if (sn > 0) {
+				stats->hits++;
+				faux_eloop_busy_grow(eloop);
+			}
+			return sn;
+		}
+		stats->misses++;
+		faux_timespec_sum(&stats->wasted_time, &stats->wasted_time,
+			&spent);
+		faux_eloop_busy_shrink(eloop);
+	}
+
+	// Block for the rest of timeout
+	if (timeout) {
+		if (!faux_timespec_diff(&rest, timeout, &spent))
+			faux_nsec_to_timespec(&rest, 0);
+		timeout = &rest;
+	}
+	sn = faux_eloop_wait(eloop, timeout, sigmask);
+	if (sn > 0) {
+		// Longer spin would get this event
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		faux_timespec_diff(&spent, &now, &start);
+		if (faux_timespec_to_nsec(&spent) < eloop->busy_max)
+			faux_eloop_busy_grow(eloop);
+	}
 
-	return (*f - s->fd);
+	return sn;
 }
 
 
-/** @brief Callback compare function for signal list.
+/** @brief Adds fd to the list of ready fds.
+ *
+ * Static service function. The list storage is never shrinked.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] fd Ready file descriptor.
+ * @param [in] revents Returned events.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
  */
-static int faux_eloop_signal_compare(const void *first, const void *second)
+static bool_t faux_eloop_ready_add(faux_eloop_t *eloop, int fd, short revents)
 {
-	const faux_eloop_signal_t *f = (const faux_eloop_signal_t *)first;
-	const faux_eloop_signal_t *s = (const faux_eloop_signal_t *)second;
+	faux_eloop_fd_t *entry = NULL;
 
-	return (f->signo - s->signo);
+	if (eloop->ready_num == eloop->ready_size) {
+		size_t new_size = eloop->ready_size ?
+			(eloop->ready_size * 2) : FDS_TABLE_MIN;
+		faux_eloop_ready_t *new_ready = NULL;
+
+		new_ready = realloc(eloop->ready, new_size * sizeof(*new_ready));
+		if (!new_ready)
+			return BOOL_FALSE;
+		eloop->ready = new_ready;
+		eloop->ready_size = new_size;
+	}
+	entry = faux_eloop_fd_entry(eloop, fd);
+	eloop->ready[eloop->ready_num].fd = fd;
+	eloop->ready[eloop->ready_num].revents = revents;
+	eloop->ready[eloop->ready_num].gen = entry ? entry->gen : 0;
+	eloop->ready_num++;
+	if (entry)
+		entry->ready_seq = eloop->ready_seq;
+
+	return BOOL_TRUE;
 }
 
 
-/** @brief Callback compare function for signal list to search by key.
+/** @brief Gets ready fds from backend and requeued fds.
+ *
+ * Static service function. The requeued fds are got with the events of
+ * their last dispatch if backend didn't report them.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] sn Number of ready fds returned by faux_eloop_wait().
  */
-static int faux_eloop_signal_kcompare(const void *key, const void *list_item)
+static void faux_eloop_gather_fds(faux_eloop_t *eloop, int sn)
 {
-	int *f = (int *)key;
-	const faux_eloop_signal_t *s = (const faux_eloop_signal_t *)list_item;
+	size_t i = 0;
+
+	eloop->ready_num = 0;
+	eloop->ready_seq++;
+
+#ifdef HAVE_EPOLL_PWAIT
+	if (FAUX_ELOOP_BACKEND_EPOLL == eloop->backend) {
+		int j = 0;
+
+		for (j = 0; j < sn; j++)
+			faux_eloop_ready_add(eloop,
+				eloop->epoll_events[j].data.fd,
+				(short)eloop->epoll_events[j].events);
+	} else
+#endif // HAVE_EPOLL_PWAIT
+#ifdef HAVE_IO_URING
+	if (FAUX_ELOOP_BACKEND_URING == eloop->backend) {
+		faux_eloop_uring_t *uring = eloop->uring;
+		int j = 0;
+
+		for (j = 0; j < sn; j++)
+			faux_eloop_ready_add(eloop, uring->ready[j].fd,
+				uring->ready[j].revents);
+	} else
+#endif // HAVE_IO_URING
+	if (sn > 0) {
+		faux_pollfd_iterator_t pollfd_iter;
+		struct pollfd *pollfd = NULL;
 
-	return (*f - s->signo);
+		faux_pollfd_init_iterator(eloop->pollfds, &pollfd_iter);
+		while ((pollfd = faux_pollfd_each_active(eloop->pollfds,
+			&pollfd_iter)))
+			faux_eloop_ready_add(eloop, pollfd->fd,
+				pollfd->revents);
+		faux_pollfd_fini_iterator(eloop->pollfds, &pollfd_iter);
+	}
+
+	// Requeued fds. Entry can be removed or registered again.
+	for (i = 0; i < eloop->requeue_num; i++) {
+		faux_eloop_fd_t *entry = faux_eloop_fd_entry(eloop,
+			eloop->requeue[i]);
+		if (!entry || !entry->requeued)
+			continue;
+		entry->requeued = BOOL_FALSE;
+		if (entry->ready_seq == eloop->ready_seq) // Reported already
+			continue;
+		faux_eloop_ready_add(eloop, entry->fd, entry->revents);
+	}
+	eloop->requeue_num = 0;
 }
 
 
-/** @brief Create new event loop object.
+/** @brief Executes callbacks for ready file descriptors.
  *
- * Function gets default event callback as argument. It will be used for all
- * events if private callback for event is not specified.
+ * Static service function. The fds are dispatched by priority classes. The
+ * service fds (signals, posted tasks) have high priority. The fds within
+ * the same class are dispatched in the order got from backend.
  *
- * @param [in] default_event_cb Default event callback.
- * @return Allocated faux_eloop_t object or NULL on error.
+ * Callbacks can change the set of registered fds while pass. The fd is not
+ * dispatched if it was removed or its number was reused by new registration
+ * (registration number differs). The fd is dispatched once per pass even if
+ * callback changes its priority.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] sn Number of ready fds returned by faux_eloop_wait().
+ * @param [in] signal_rfd Service fd to get signals from.
+ * @return BOOL_FALSE if any callback wants to break the loop else BOOL_TRUE.
  */
-faux_eloop_t *faux_eloop_new(faux_eloop_cb_fn default_event_cb)
+static bool_t faux_eloop_dispatch_fds(faux_eloop_t *eloop, int sn,
+	int signal_rfd)
 {
-	faux_eloop_t *eloop = NULL;
+	bool_t retval = BOOL_TRUE;
+	unsigned int prio = FAUX_ELOOP_PRIO_HIGH;
+	unsigned int prio_last = FAUX_ELOOP_PRIO_HIGH;
 
-	eloop = faux_zmalloc(sizeof(*eloop));
-	assert(eloop);
-	if (!eloop)
-		return NULL;
+	faux_eloop_gather_fds(eloop, sn);
 
-	// Init
-	eloop->working = BOOL_FALSE;
-	eloop->default_event_cb = default_event_cb;
+	// Single pass if all fds have default priority
+	if (eloop->prio_fds > 0)
+		prio_last = FAUX_ELOOP_PRIO_LOW;
 
-	// Sched
-	eloop->sched = faux_sched_new();
-	assert(eloop->sched);
+	for (prio = FAUX_ELOOP_PRIO_HIGH; prio <= prio_last; prio++) {
+		size_t i = 0;
 
-	// FD
-	eloop->fds = faux_list_new(FAUX_LIST_SORTED, FAUX_LIST_UNIQUE,
-		faux_eloop_fd_compare, faux_eloop_fd_kcompare, faux_free);
-	assert(eloop->fds);
-	eloop->pollfds = faux_pollfd_new();
-	assert(eloop->pollfds);
+		for (i = 0; i < eloop->ready_num; i++) {
+			int fd = eloop->ready[i].fd;
+			short revents = eloop->ready[i].revents;
+			faux_eloop_fd_t *entry = NULL;
+			bool_t r = BOOL_TRUE;
 
-	// Signal
-	eloop->signals = faux_list_new(FAUX_LIST_SORTED, FAUX_LIST_UNIQUE,
-		faux_eloop_signal_compare, faux_eloop_signal_kcompare, faux_free);
-	assert(eloop->signals);
-	sigemptyset(&eloop->sig_set);
-	sigfillset(&eloop->sig_mask);
-#ifdef HAVE_SIGNALFD
-	eloop->signal_fd = -1;
-#endif
+			if ((fd == signal_rfd) || (fd == eloop->post_fd)) {
+				if (prio != FAUX_ELOOP_PRIO_HIGH)
+					continue;
+			} else {
+				entry = faux_eloop_fd_entry(eloop, fd);
+				// Removed or registered again
+				if (!entry || (entry->gen != eloop->ready[i].gen))
+					continue;
+				if ((prio_last != FAUX_ELOOP_PRIO_HIGH) &&
+					(entry->prio != prio))
+					continue;
+				if (entry->dispatch_seq == eloop->ready_seq)
+					continue;
+				entry->dispatch_seq = eloop->ready_seq;
+			}
 
-	return eloop;
+			if (fd == signal_rfd)
+				r = faux_eloop_dispatch_signals(eloop, fd);
+			else if (fd == eloop->post_fd)
+				r = faux_eloop_dispatch_posts(eloop);
+			else
+				r = faux_eloop_dispatch_fd(eloop, fd, revents);
+			// BOOL_FALSE return value means "break the loop"
+			if (!r)
+				retval = BOOL_FALSE;
+		}
+	}
+
+	return retval;
 }
 
 
-/** @brief Free event loop object.
+/** @brief Executes callbacks for already coming scheduled events.
  *
- * @param [in] Event loop object.
+ * Static service function. Number of executed callbacks can be limited by
+ * faux_eloop_set_sched_limit(). The rest of coming events will be processed
+ * on the next iteration. The loop will not block while there are coming
+ * events.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @return BOOL_FALSE if any callback wants to break the loop else BOOL_TRUE.
  */
-void faux_eloop_free(faux_eloop_t *eloop)
+static bool_t faux_eloop_dispatch_sched(faux_eloop_t *eloop)
 {
-	if (!eloop)
-		return;
+	bool_t retval = BOOL_TRUE;
+	unsigned int processed = 0;
+	faux_ev_t *ev = NULL;
+	struct timespec start = {};
 
-	faux_list_free(eloop->signals);
-	faux_pollfd_free(eloop->pollfds);
-	faux_list_free(eloop->fds);
-	faux_sched_free(eloop->sched);
+	faux_sched_start_pass(eloop->sched);
+	while ((0 == eloop->sched_limit) || (processed < eloop->sched_limit)) {
+		faux_eloop_info_sched_t info = {};
+		int ev_id = 0;
+		faux_eloop_context_t *context = NULL;
+		faux_eloop_cb_fn event_cb = NULL;
+		void *user_data = NULL;
 
-	faux_free(eloop);
+		if (!(ev = faux_sched_pop(eloop->sched)))
+			break;
+		processed++;
+		ev_id = faux_ev_id(ev);
+		context = (faux_eloop_context_t *)faux_ev_data(ev);
+		event_cb = context->event_cb;
+		user_data = context->user_data;
+
+		if (!faux_ev_is_busy(ev)) {
+			faux_ev_free(ev);
+			ev = NULL;
+		}
+		if (!event_cb)
+			event_cb = eloop->default_event_cb;
+		if (!event_cb) // Callback is not defined
+			continue;
+		info.ev_id = ev_id;
+		// Callback will get only rescheduled event object.
+		// If event is not scheduled, callback will get NULL.
+		info.ev = ev;
+		// Execute callback
+		// BOOL_FALSE return value means "break the loop"
+		faux_eloop_stats_start(eloop, &start);
+		if (!event_cb(eloop, FAUX_ELOOP_SCHED, &info, user_data))
+			retval = BOOL_FALSE;
+		faux_eloop_stats_cb(eloop, FAUX_ELOOP_SCHED, ev_id, 0, &start);
+	}
+
+	return retval;
 }
 
 
@@ -194,9 +1484,8 @@ bool_t faux_eloop_loop(faux_eloop_t *eloop)
 	bool_t stop = BOOL_FALSE;
 	sigset_t blocked_signals;
 	sigset_t orig_sig_set;
-#ifdef HAVE_PPOLL
-	sigset_t *sigset_for_ppoll = NULL;
-#endif // HAVE_PPOLL
+	sigset_t *sigset_for_wait = NULL;
+	int signal_rfd = -1; // Service fd to get signals from
 #ifndef HAVE_SIGNALFD
 	int signal_pipe[2];
 	int fflags = 0;
@@ -218,12 +1507,11 @@ bool_t faux_eloop_loop(faux_eloop_t *eloop)
 	// Create Linux-specific signal file descriptor. Wait for signals.
 	eloop->signal_fd = signalfd(eloop->signal_fd, &eloop->sig_set,
 		SIGNALFD_FLAGS);
-	faux_pollfd_add(eloop->pollfds, eloop->signal_fd, POLLIN);
+	signal_rfd = eloop->signal_fd;
+	faux_eloop_watch(eloop, signal_rfd, POLLIN);
 
 #else // Standard signal processing
-#ifdef PPOLL
-	sigset_for_ppoll = &eloop->sig_mask;
-#endif // HAVE_PPOLL
+	sigset_for_wait = &eloop->sig_mask;
 
 	// Create signal pipe pair to get signal number on pipe read end
 	pipe(signal_pipe);
@@ -238,7 +1526,8 @@ bool_t faux_eloop_loop(faux_eloop_t *eloop)
 	// faux_eloop_t objects). So it need to be restored after loop.
 	saved_static_user_data = faux_eloop_static_user_data;
 	faux_eloop_static_user_data = &signal_pipe[1];
-	faux_pollfd_add(eloop->pollfds, signal_pipe[0], POLLIN);
+	signal_rfd = signal_pipe[0];
+	faux_eloop_watch(eloop, signal_rfd, POLLIN);
 
 	if (faux_list_len(eloop->signals) != 0) {
 		faux_list_node_t *iter = faux_list_head(eloop->signals);
@@ -253,31 +1542,42 @@ bool_t faux_eloop_loop(faux_eloop_t *eloop)
 	}
 #endif // HAVE_SIGNALFD
 
+	// Wake up on posted tasks
+	faux_eloop_watch(eloop, eloop->post_fd, POLLIN);
+
 	// Main loop
 	while (!stop) {
 		int sn = 0;
 		struct timespec *timeout = NULL;
 		struct timespec next_interval = {};
-		faux_pollfd_iterator_t pollfd_iter;
-		struct pollfd *pollfd = NULL;
+		struct timespec wait_start = {};
+		bool_t idle = BOOL_FALSE;
 
 		// Find out next scheduled interval
+		faux_eloop_update_now(eloop);
 		if (!faux_sched_next_interval(eloop->sched, &next_interval))
 			timeout = NULL;
 		else
 			timeout = &next_interval;
 
+		// Don't block while there are deferred calls or requeued fds.
+		// The idle calls are executed if there are no events within
+		// non-blocking wait.
+		if ((eloop->defer.len > 0) || (eloop->requeue_num > 0)) {
+			faux_nsec_to_timespec(&next_interval, 0);
+			timeout = &next_interval;
+		} else if (eloop->idle.len > 0) {
+			if (!timeout || (faux_timespec_to_nsec(timeout) > 0))
+				idle = BOOL_TRUE;
+			faux_nsec_to_timespec(&next_interval, 0);
+			timeout = &next_interval;
+		}
+
 		// Wait for events
-#ifdef HAVE_PPOLL
-		sn = ppoll(faux_pollfd_vector(eloop->pollfds),
-			faux_pollfd_len(eloop->pollfds), timeout, sigset_for_ppoll);
-#else // poll()
-		sigprocmask(SIG_SETMASK, &eloop->sig_mask, NULL);
-		sn = poll(faux_pollfd_vector(eloop->pollfds),
-			faux_pollfd_len(eloop->pollfds),
-			timeout ? TIMESPEC_TO_MILISECONDS(next_interval) : -1);
-		sigprocmask(SIG_SETMASK, &blocked_signals, NULL);
-#endif // HAVE_PPOLL
+		faux_eloop_stats_start(eloop, &wait_start);
+		sn = faux_eloop_busy_wait(eloop, timeout, sigset_for_wait);
+		faux_eloop_stats_wait(eloop, &wait_start);
+		faux_eloop_update_now(eloop);
 
 		// Error or signal
 		if (sn < 0) {
@@ -288,114 +1588,36 @@ bool_t faux_eloop_loop(faux_eloop_t *eloop)
 			break;
 		}
 
-		// Scheduled event
-		if (0 == sn) {
-			faux_ev_t *ev = NULL;
-
-			// Some scheduled events
-			while((ev = faux_sched_pop(eloop->sched))) {
-				faux_eloop_info_sched_t info = {};
-				bool_t r = BOOL_TRUE;
-				int ev_id = faux_ev_id(ev);
-				faux_eloop_context_t *context =
-					(faux_eloop_context_t *)faux_ev_data(ev);
-				faux_eloop_cb_fn event_cb = context->event_cb;
-				void *user_data = context->user_data;
-
-				if (!faux_ev_is_busy(ev)) {
-					faux_ev_free(ev);
-					ev = NULL;
-				}
-				if (!event_cb)
-					event_cb = eloop->default_event_cb;
-				if (!event_cb) // Callback is not defined
-					continue;
-				info.ev_id = ev_id;
-				// Callback will get only rescheduled event object.
-				// If event is not scheduled, callback will get NULL.
-				info.ev = ev;
-				// Execute callback
-				r = event_cb(eloop, FAUX_ELOOP_SCHED, &info,
-					user_data);
-				// BOOL_FALSE return value means "break the loop"
-				if (!r)
-					stop = BOOL_TRUE;
-			}
-			continue;
-		}
-
-		// File descriptor
-		faux_pollfd_init_iterator(eloop->pollfds, &pollfd_iter);
-		while ((pollfd = faux_pollfd_each_active(eloop->pollfds, &pollfd_iter))) {
-			int fd = pollfd->fd;
-			faux_eloop_info_fd_t info = {};
-			faux_eloop_cb_fn event_cb = NULL;
-			faux_eloop_fd_t *entry = NULL;
-			bool_t r = BOOL_TRUE;
+		// File descriptors
+		if (((sn > 0) || (eloop->requeue_num > 0)) &&
+			!faux_eloop_dispatch_fds(eloop, sn, signal_rfd))
+			stop = BOOL_TRUE;
 
-			// Read special signal file descriptor
-#ifdef HAVE_SIGNALFD
-			if (fd == eloop->signal_fd) {
-				struct signalfd_siginfo signal_info = {};
-				while (faux_read(fd, &signal_info,
-					sizeof(signal_info)) == sizeof(signal_info)) {
-					int signo = signal_info.ssi_signo;
-#else
-			if (fd == signal_pipe[0]) {
-				int tmp = 0;
-				while (faux_read(fd, &tmp,
-					sizeof(tmp)) == sizeof(tmp)) {
-					int signo = tmp;
-#endif // HAVE_SIGNALFD
-					faux_eloop_info_signal_t sinfo = {};
-					faux_eloop_signal_t *sentry =
-						(faux_eloop_signal_t *)faux_list_kfind(
-						eloop->signals, &signo);
-
-					if (!sentry) // Not registered signal. Drop it.
-						continue;
-					event_cb = sentry->context.event_cb;
-					if (!event_cb)
-						event_cb = eloop->default_event_cb;
-					if (!event_cb) // Callback is not defined
-						continue;
-					sinfo.signo = signo;
-
-					// Execute callback
-					r = event_cb(eloop, FAUX_ELOOP_SIGNAL, &sinfo,
-						sentry->context.user_data);
-					// BOOL_FALSE return value means "break the loop"
-					if (!r)
-						stop = BOOL_TRUE;
-				}
-				continue; // Another fds are common, not signal
-			}
+		// Scheduled events. They are processed on every iteration
+		// but not on timeout only. Else constantly active fds can
+		// delay scheduled events without bound.
+		if (!stop && !faux_eloop_dispatch_sched(eloop))
+			stop = BOOL_TRUE;
 
-			// File descriptor
-			entry = (faux_eloop_fd_t *)faux_list_kfind(eloop->fds, &fd);
-			assert(entry);
-			if (!entry) // Something went wrong
-				continue;
-			event_cb = entry->context.event_cb;
-			if (!event_cb)
-				event_cb = eloop->default_event_cb;
-			if (!event_cb) // Callback function is not defined for this event
-				continue;
-			info.fd = fd;
-			info.revents = pollfd->revents;
+		// Deferred calls are executed after dispatch pass
+		if (!stop && !faux_eloop_dispatch_queue(eloop, &eloop->defer))
+			stop = BOOL_TRUE;
 
-			// Execute callback
-			r = event_cb(eloop, FAUX_ELOOP_FD, &info, entry->context.user_data);
-			// BOOL_FALSE return value means "break the loop"
-			if (!r)
-				stop = BOOL_TRUE;
-		}
+		// Idle calls. Loop would block if there were no idle calls.
+		if (!stop && idle && (0 == sn) &&
+			!faux_eloop_dispatch_queue(eloop, &eloop->idle))
+			stop = BOOL_TRUE;
 
 	} // Loop end
 
+	// Scheduler reads the clock by itself while loop is not working
+	faux_sched_set_now(eloop->sched, NULL);
+
+	faux_eloop_unwatch(eloop, eloop->post_fd);
+
 #ifdef HAVE_SIGNALFD
 	// Close signal file descriptor
-	faux_pollfd_del_by_fd(eloop->pollfds, eloop->signal_fd);
+	faux_eloop_unwatch(eloop, eloop->signal_fd);
 	close(eloop->signal_fd);
 	eloop->signal_fd = -1;
 
@@ -411,7 +1633,7 @@ bool_t faux_eloop_loop(faux_eloop_t *eloop)
 			sigaction(sig->signo, &sig->oldact, NULL);
 	}
 
-	faux_pollfd_del_by_fd(eloop->pollfds, signal_pipe[0]);
+	faux_eloop_unwatch(eloop, signal_pipe[0]);
 	close(signal_pipe[0]);
 	close(signal_pipe[1]);
 #endif
@@ -426,6 +1648,56 @@ bool_t faux_eloop_loop(faux_eloop_t *eloop)
 }
 
 
+/** @brief Registers file descriptor or async object.
+ *
+ * Static service function.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] fd File descriptor to wait on.
+ * @param [in] events File events mask like POLLIN, POLLOUT.
+ * @param [in] async Async object to serve. NULL for plain fd.
+ * @param [in] event_cb Callback for event.
+ * @param [in] user_data User data to pass to callback.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+static bool_t faux_eloop_add_entry(faux_eloop_t *eloop, int fd, short events,
+	faux_async_t *async, faux_eloop_cb_fn event_cb, void *user_data)
+{
+	faux_eloop_fd_t *entry = NULL;
+
+	if (faux_eloop_fd_entry(eloop, fd))
+		return BOOL_FALSE; // Already registered
+	if (!faux_eloop_fds_grow(eloop, fd))
+		return BOOL_FALSE;
+
+	if (async) {
+		if (!faux_eloop_watch_async(eloop, async, events))
+			return BOOL_FALSE;
+	} else {
+		if (!faux_eloop_watch(eloop, fd, events))
+			return BOOL_FALSE;
+	}
+
+	entry = &eloop->fds[fd];
+	entry->fd = fd;
+	entry->events = events;
+	entry->context.event_cb = event_cb;
+	entry->context.user_data = user_data;
+	entry->stats = NULL;
+	entry->prio = FAUX_ELOOP_PRIO_NORMAL;
+	entry->async = async;
+	entry->revents = 0;
+	entry->requeued = BOOL_FALSE;
+	entry->ready_seq = 0;
+	entry->dispatch_seq = 0;
+	eloop->fds_gen++;
+	entry->gen = eloop->fds_gen;
+	eloop->fds_num++;
+
+	return BOOL_TRUE;
+}
+
+
 /** @brief Registers file descriptor to wait for events.
  *
  * See poll() for explanation of possible file events ("events" argument).
@@ -439,106 +1711,218 @@ bool_t faux_eloop_loop(faux_eloop_t *eloop)
  */
 bool_t faux_eloop_add_fd(faux_eloop_t *eloop, int fd, short events,
 	faux_eloop_cb_fn event_cb, void *user_data)
+{
+	assert(eloop);
+	if (!eloop || (fd < 0))
+		return BOOL_FALSE;
+
+	return faux_eloop_add_entry(eloop, fd, events, NULL,
+		event_cb, user_data);
+}
+
+
+/** @brief Registers async I/O object to serve by loop.
+ *
+ * The fd of async object is registered with POLLIN event. The callback gets
+ * POLLIN event when there is input data and it must call faux_async_in()
+ * to get data by "read" callback of async object. The POLLHUP means end of
+ * file and POLLERR means error.
+ *
+ * The poll() and epoll() backends just watch fd. Then faux_async_in() and
+ * faux_async_out() use read() and write() syscalls as usual. The io_uring
+ * backend reads and writes fd by completion requests. The data is already
+ * read when callback is executed so faux_async_in() doesn't make syscall.
+ * The faux_async_out() (and so faux_async_write()) queues write request
+ * that is submitted by the next wait of loop. It saves syscall per I/O
+ * operation. The POLLOUT event and "stall" callback are not used in this
+ * case.
+ *
+ * Async object must be unregistered by faux_eloop_del_fd() before
+ * faux_async_free(). The data not written yet is dropped then.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] async Async object.
+ * @param [in] event_cb Callback for event.
+ * @param [in] user_data User data to pass to callback.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+bool_t faux_eloop_add_async(faux_eloop_t *eloop, faux_async_t *async,
+	faux_eloop_cb_fn event_cb, void *user_data)
+{
+	int fd = -1;
+
+	assert(eloop);
+	assert(async);
+	if (!eloop || !async)
+		return BOOL_FALSE;
+	fd = faux_async_fd(async);
+	if (fd < 0)
+		return BOOL_FALSE;
+
+	return faux_eloop_add_entry(eloop, fd, POLLIN, async,
+		event_cb, user_data);
+}
+
+
+/** @brief Registers additional event for specified fd.
+ *
+ * See poll() for explanation of possible file events ("events" argument).
+ * Suppose some fd was added by faux_eloop_add_fd(). User have specified some
+ * events like POLLIN. Now user wants to track POLLOUT event too. So it's not
+ * necessary to remove fd by faux_eloop_del_fd() and then re-add it with new
+ * event mask. User can include additional events by
+ * faux_eloop_include_fd_event(). Specified event will be added to existent
+ * event mask.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] fd File descriptor to change event mask.
+ * @param [in] events File event to include (like POLLIN, POLLOUT).
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+bool_t faux_eloop_include_fd_event(faux_eloop_t *eloop, int fd, short event)
 {
 	faux_eloop_fd_t *entry = NULL;
-	faux_list_node_t *new_node = NULL;
 
 	assert(eloop);
-	if (!eloop || (fd < 0))
+	if (!eloop)
+		return BOOL_FALSE;
+	assert(fd >= 0);
+	if (fd < 0)
 		return BOOL_FALSE;
 
-	entry = faux_zmalloc(sizeof(*entry));
+	entry = faux_eloop_fd_entry(eloop, fd);
 	if (!entry)
 		return BOOL_FALSE;
-	entry->fd = fd;
-	entry->events = events;
-	entry->context.event_cb = event_cb;
-	entry->context.user_data = user_data;
+	entry->events = entry->events | event;
+	if (faux_eloop_async_served(eloop, entry))
+		return BOOL_TRUE; // Backend doesn't wait for events
+	if (!faux_eloop_rewatch(eloop, fd, entry->events))
+		return BOOL_FALSE;
 
-	if (!(new_node = faux_list_add(eloop->fds, entry))) {
-		faux_free(entry);
+	return BOOL_TRUE;
+}
+
+
+/** @brief Unregisters event for specified fd.
+ *
+ * See poll() for explanation of possible file events ("events" argument).
+ * Suppose some fd was added by faux_eloop_add_fd(). User have specified some
+ * events like POLLIN, POLLOUT. Now user doesn't wants to track one of the
+ * events (POLLOUT for example). So it's not necessary to remove fd by
+ * faux_eloop_del_fd() and then re-add it with new event mask. User can exclude
+ * event by faux_eloop_include_fd_event(). Specified event will be excluded from
+ * existent event mask.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] fd File descriptor to change event mask.
+ * @param [in] events File event to exclude (like POLLIN, POLLOUT).
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+bool_t faux_eloop_exclude_fd_event(faux_eloop_t *eloop, int fd, short event)
+{
+	faux_eloop_fd_t *entry = NULL;
+
+	assert(eloop);
+	if (!eloop)
+		return BOOL_FALSE;
+	assert(fd >= 0);
+	if (fd < 0)
 		return BOOL_FALSE;
-	}
 
-	if (!faux_pollfd_add(eloop->pollfds, entry->fd, entry->events)) {
-		faux_list_del(eloop->fds, new_node);
-		faux_free(entry);
+	entry = faux_eloop_fd_entry(eloop, fd);
+	if (!entry)
+		return BOOL_FALSE;
+	entry->events = entry->events & (~event);
+	if (faux_eloop_async_served(eloop, entry))
+		return BOOL_TRUE; // Backend doesn't wait for events
+	if (!faux_eloop_rewatch(eloop, fd, entry->events))
 		return BOOL_FALSE;
-	}
 
 	return BOOL_TRUE;
 }
 
 
-/** @brief Registers additional event for specified fd.
+/** @brief Sets dispatch priority of file descriptor.
  *
- * See poll() for explanation of possible file events ("events" argument).
- * Suppose some fd was added by faux_eloop_add_fd(). User have specified some
- * events like POLLIN. Now user wants to track POLLOUT event too. So it's not
- * necessary to remove fd by faux_eloop_del_fd() and then re-add it with new
- * event mask. User can include additional events by
- * faux_eloop_include_fd_event(). Specified event will be added to existent
- * event mask.
+ * The ready fds are dispatched by priority classes. All high priority fds
+ * are dispatched before normal ones and normal ones are dispatched before
+ * low priority fds. It lets control connections to be served before bulk
+ * transfers within the same iteration. The default priority is
+ * FAUX_ELOOP_PRIO_NORMAL. If all fds have default priority then there is
+ * no additional cost.
  *
  * @param [in] eloop Allocated and initialized event loop object.
- * @param [in] fd File descriptor to change event mask.
- * @param [in] events File event to include (like POLLIN, POLLOUT).
+ * @param [in] fd Registered file descriptor.
+ * @param [in] prio Priority class.
  * @return BOOL_TRUE - success, BOOL_FALSE - error.
  */
-bool_t faux_eloop_include_fd_event(faux_eloop_t *eloop, int fd, short event)
+bool_t faux_eloop_set_fd_prio(faux_eloop_t *eloop, int fd,
+	faux_eloop_prio_e prio)
 {
 	faux_eloop_fd_t *entry = NULL;
 
 	assert(eloop);
 	if (!eloop)
 		return BOOL_FALSE;
-	assert(fd >= 0);
-	if (fd < 0)
+	if ((prio < FAUX_ELOOP_PRIO_HIGH) || (prio > FAUX_ELOOP_PRIO_LOW))
 		return BOOL_FALSE;
 
-	entry = (faux_eloop_fd_t *)faux_list_kfind(eloop->fds, &fd);
+	entry = faux_eloop_fd_entry(eloop, fd);
 	if (!entry)
 		return BOOL_FALSE;
-	entry->events = entry->events | event;
-	faux_pollfd_del_by_fd(eloop->pollfds, fd);
-	faux_pollfd_add(eloop->pollfds, fd, entry->events);
+	if (entry->prio != FAUX_ELOOP_PRIO_NORMAL)
+		eloop->prio_fds--;
+	if (prio != FAUX_ELOOP_PRIO_NORMAL)
+		eloop->prio_fds++;
+	entry->prio = prio;
 
 	return BOOL_TRUE;
 }
 
 
-/** @brief Unregisters event for specified fd.
+/** @brief Requests fd dispatch on the next iteration.
  *
- * See poll() for explanation of possible file events ("events" argument).
- * Suppose some fd was added by faux_eloop_add_fd(). User have specified some
- * events like POLLIN, POLLOUT. Now user doesn't wants to track one of the
- * events (POLLOUT for example). So it's not necessary to remove fd by
- * faux_eloop_del_fd() and then re-add it with new event mask. User can exclude
- * event by faux_eloop_include_fd_event(). Specified event will be excluded from
- * existent event mask.
+ * Callback can limit amount of work per invocation (see
+ * faux_async_set_read_budget()) to don't starve other fds. If work is not
+ * finished the callback requeues fd. Then fd callback will be called on the
+ * next iteration with the same returned events even if backend doesn't
+ * report fd as ready, i.e. without waiting for readiness. The loop doesn't
+ * block while there are requeued fds. The fd is dispatched once even if
+ * it's requeued several times or backend reports it too.
  *
  * @param [in] eloop Allocated and initialized event loop object.
- * @param [in] fd File descriptor to change event mask.
- * @param [in] events File event to exclude (like POLLIN, POLLOUT).
+ * @param [in] fd Registered file descriptor.
  * @return BOOL_TRUE - success, BOOL_FALSE - error.
  */
-bool_t faux_eloop_exclude_fd_event(faux_eloop_t *eloop, int fd, short event)
+bool_t faux_eloop_requeue_fd(faux_eloop_t *eloop, int fd)
 {
 	faux_eloop_fd_t *entry = NULL;
 
 	assert(eloop);
 	if (!eloop)
 		return BOOL_FALSE;
-	assert(fd >= 0);
-	if (fd < 0)
-		return BOOL_FALSE;
 
-	entry = (faux_eloop_fd_t *)faux_list_kfind(eloop->fds, &fd);
+	entry = faux_eloop_fd_entry(eloop, fd);
 	if (!entry)
 		return BOOL_FALSE;
-	entry->events = entry->events & (~event);
-	faux_pollfd_del_by_fd(eloop->pollfds, fd);
-	faux_pollfd_add(eloop->pollfds, fd, entry->events);
+	if (entry->requeued)
+		return BOOL_TRUE;
+
+	if (eloop->requeue_num == eloop->requeue_size) {
+		size_t new_size = eloop->requeue_size ?
+			(eloop->requeue_size * 2) : FDS_TABLE_MIN;
+		int *new_requeue = NULL;
+
+		new_requeue = realloc(eloop->requeue,
+			new_size * sizeof(*new_requeue));
+		if (!new_requeue)
+			return BOOL_FALSE;
+		eloop->requeue = new_requeue;
+		eloop->requeue_size = new_size;
+	}
+	eloop->requeue[eloop->requeue_num] = fd;
+	eloop->requeue_num++;
+	entry->requeued = BOOL_TRUE;
 
 	return BOOL_TRUE;
 }
@@ -552,13 +1936,29 @@ bool_t faux_eloop_exclude_fd_event(faux_eloop_t *eloop, int fd, short event)
  */
 bool_t faux_eloop_del_fd(faux_eloop_t *eloop, int fd)
 {
+	faux_eloop_fd_t *entry = NULL;
+
 	if (!eloop || (fd < 0))
 		return BOOL_FALSE;
 
-	if (!faux_list_kdel(eloop->fds, &fd))
+	entry = faux_eloop_fd_entry(eloop, fd);
+	if (!entry)
 		return BOOL_FALSE;
-
-	if (!faux_pollfd_del_by_fd(eloop->pollfds, fd))
+	entry->fd = -1;
+	faux_free(entry->stats);
+	entry->stats = NULL;
+	if (entry->prio != FAUX_ELOOP_PRIO_NORMAL)
+		eloop->prio_fds--;
+	eloop->fds_num--;
+
+	if (entry->async) {
+		faux_async_t *async = entry->async;
+		entry->async = NULL;
+		if (!faux_eloop_unwatch_async(eloop, async))
+			return BOOL_FALSE;
+		return BOOL_TRUE;
+	}
+	if (!faux_eloop_unwatch(eloop, fd))
 		return BOOL_FALSE;
 
 	return BOOL_TRUE;
@@ -572,7 +1972,7 @@ bool_t faux_eloop_del_fd(faux_eloop_t *eloop, int fd)
  */
 bool_t faux_eloop_del_fd_all(faux_eloop_t *eloop)
 {
-	faux_list_node_t *iter = NULL;
+	size_t i = 0;
 
 	if (!eloop)
 		return BOOL_FALSE;
@@ -580,10 +1980,10 @@ bool_t faux_eloop_del_fd_all(faux_eloop_t *eloop)
 	// "Del all" function is so complex because pollfd object
 	// contains not user added fds only. It contains special fd for signals,
 	// service pipe and may be something else. So del all fds one by one.
-	while ((iter = faux_list_tail(eloop->fds))) {
-		faux_eloop_fd_t *entry = NULL;
-		entry = (faux_eloop_fd_t *)faux_list_data(iter);
-		faux_eloop_del_fd(eloop, entry->fd);
+	for (i = 0; (i < eloop->fds_size) && (eloop->fds_num > 0); i++) {
+		if (eloop->fds[i].fd < 0)
+			continue;
+		faux_eloop_del_fd(eloop, eloop->fds[i].fd);
 	}
 
 	return BOOL_TRUE;
@@ -734,7 +2134,46 @@ static faux_eloop_context_t *faux_eloop_new_context(
 }
 
 
+/** @brief Converts absolute wall-clock time to loop time.
+ *
+ * Static service function. The user specifies absolute time of event using
+ * CLOCK_REALTIME but scheduler uses CLOCK_MONOTONIC. Both clocks are read
+ * right now. The cached loop time can't be used. It's older than the wall
+ * clock within callback so event would be popped too early.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] time Absolute CLOCK_REALTIME time. NULL means "now".
+ * @param [out] loop_time Converted time.
+ * @return Pointer to converted time or NULL for "now".
+ */
+static const struct timespec *faux_eloop_loop_time(const faux_eloop_t *eloop,
+	const struct timespec *time, struct timespec *loop_time)
+{
+	struct timespec real_now = {};
+	struct timespec loop_now = {};
+	struct timespec delta = {};
+
+	if (!time)
+		return FAUX_SCHED_NOW;
+
+	faux_timespec_now(&real_now);
+	clock_gettime(eloop->clock, &loop_now);
+	if (faux_timespec_diff(&delta, time, &real_now)) {
+		faux_timespec_sum(loop_time, &loop_now, &delta);
+	} else { // The time is in the past
+		faux_timespec_diff(&delta, &real_now, time);
+		if (!faux_timespec_diff(loop_time, &loop_now, &delta))
+			faux_nsec_to_timespec(loop_time, 0);
+	}
+
+	return loop_time;
+}
+
+
 /** @brief Registers scheduled time event. See faux_sched_once().
+ *
+ * The time is absolute CLOCK_REALTIME time. It's converted to the loop time
+ * internally so faux_ev_time() returns the loop (monotonic) time.
  *
  * @param [in] eloop Allocated and initialized event loop object.
  * @param [in] time See faux_sched_once().
@@ -748,6 +2187,7 @@ faux_ev_t *faux_eloop_add_sched_once(faux_eloop_t *eloop, const struct timespec
 {
 	faux_eloop_context_t *context = NULL;
 	faux_ev_t *ev = NULL;
+	struct timespec loop_time = {};
 
 	assert(eloop);
 	if (!eloop)
@@ -758,7 +2198,8 @@ faux_ev_t *faux_eloop_add_sched_once(faux_eloop_t *eloop, const struct timespec
 	if (!context)
 		return NULL;
 
-	if (!(ev = faux_sched_once(eloop->sched, time, ev_id, context))) {
+	if (!(ev = faux_sched_once(eloop->sched,
+		faux_eloop_loop_time(eloop, time, &loop_time), ev_id, context))) {
 		faux_free(context);
 		return NULL;
 	}
@@ -803,6 +2244,8 @@ faux_ev_t *faux_eloop_add_sched_once_delayed(faux_eloop_t *eloop, const struct t
 
 
 /** @brief Registers scheduled time event. See faux_sched_periodic().
+ *
+ * The time is absolute CLOCK_REALTIME time. See faux_eloop_add_sched_once().
  *
  * @param [in] eloop Allocated and initialized event loop object.
  * @param [in] time See faux_sched_periodic().
@@ -819,6 +2262,7 @@ faux_ev_t *faux_eloop_add_sched_periodic(faux_eloop_t *eloop, const struct times
 {
 	faux_eloop_context_t *context = NULL;
 	faux_ev_t *ev = NULL;
+	struct timespec loop_time = {};
 
 	assert(eloop);
 	if (!eloop)
@@ -829,7 +2273,8 @@ faux_ev_t *faux_eloop_add_sched_periodic(faux_eloop_t *eloop, const struct times
 	if (!context)
 		return NULL;
 
-	if (!(ev = faux_sched_periodic(eloop->sched, time, ev_id, context,
+	if (!(ev = faux_sched_periodic(eloop->sched,
+		faux_eloop_loop_time(eloop, time, &loop_time), ev_id, context,
 		period, cycle_num))) {
 		faux_free(context);
 		return NULL;
@@ -924,3 +2369,433 @@ ssize_t faux_eloop_del_sched_by_id(faux_eloop_t *eloop, int ev_id)
 
 	return faux_sched_del_by_id(eloop->sched, ev_id);
 }
+
+
+/** @brief Limits number of scheduled events callbacks per loop iteration.
+ *
+ * Scheduled events are processed on every loop iteration after fd events.
+ * A lot of coming scheduled events can delay fd events processing. The limit
+ * makes loop to process the rest of coming scheduled events on the next
+ * iterations.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] limit Max number of callbacks per iteration. 0 - unlimited.
+ */
+void faux_eloop_set_sched_limit(faux_eloop_t *eloop, unsigned int limit)
+{
+	assert(eloop);
+	if (!eloop)
+		return;
+
+	eloop->sched_limit = limit;
+}
+
+
+/** @brief Gets lateness of scheduled events. See faux_sched_lateness().
+ *
+ * Lateness is an interval between planned time of scheduled event and the
+ * moment when event is really processed by loop.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [out] avg Average lateness. Can be NULL.
+ * @param [out] max Max lateness. Can be NULL.
+ * @return Number of processed scheduled events or < 0 on error.
+ */
+ssize_t faux_eloop_sched_lateness(const faux_eloop_t *eloop,
+	struct timespec *avg, struct timespec *max)
+{
+	assert(eloop);
+	if (!eloop)
+		return -1;
+
+	return faux_sched_lateness(eloop->sched, avg, max);
+}
+
+
+/** @brief Gets number of wakeups saved by coalescing.
+ *
+ * See faux_sched_saved_wakeups(). Use faux_ev_set_slack() for the event
+ * returned by faux_eloop_add_sched_*() functions to let loop coalesce it
+ * with other scheduled events.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @return Number of saved wakeups or < 0 on error.
+ */
+ssize_t faux_eloop_sched_saved_wakeups(const faux_eloop_t *eloop)
+{
+	assert(eloop);
+	if (!eloop)
+		return -1;
+
+	return faux_sched_saved_wakeups(eloop->sched);
+}
+
+
+/** @brief Enables or disables statistics of event loop.
+ *
+ * Statistics are disabled by default. While disabled the loop doesn't read
+ * the clock for statistics so cost is a single check per callback.
+ * Enabled statistics read precise monotonic clock around each wait and
+ * each callback. Enabling resets previously gathered values.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] enable BOOL_TRUE to enable, BOOL_FALSE to disable.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_eloop_set_stats(faux_eloop_t *eloop, bool_t enable)
+{
+	size_t i = 0;
+
+	assert(eloop);
+	if (!eloop)
+		return BOOL_FALSE;
+
+	// Per-fd statistics are dropped in both cases
+	for (i = 0; i < eloop->fds_size; i++) {
+		faux_free(eloop->fds[i].stats);
+		eloop->fds[i].stats = NULL;
+	}
+	faux_free(eloop->stats);
+	eloop->stats = NULL;
+	if (!enable)
+		return BOOL_TRUE;
+
+	eloop->stats = faux_zmalloc(sizeof(*eloop->stats));
+	if (!eloop->stats)
+		return BOOL_FALSE;
+	eloop->stats->slowest_type = FAUX_ELOOP_NULL;
+	eloop->stats->slowest_id = -1;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Sets busy poll mode.
+ *
+ * In busy poll mode loop spins with non-blocking waits before it blocks.
+ * It saves sleep/wakeup latency for frequent events but burns CPU while
+ * spinning. The spin budget is adaptive. It's doubled when spinning pays
+ * off and halved when loop gives up spinning. The specified budget is an
+ * upper limit. The loop starts with max budget. Setting the mode resets
+ * statistics. See faux_eloop_busy_stats().
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] budget Max spin time. NULL or zero disables busy poll.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_eloop_set_busy_poll(faux_eloop_t *eloop,
+	const struct timespec *budget)
+{
+	assert(eloop);
+	if (!eloop)
+		return BOOL_FALSE;
+
+	eloop->busy_max = budget ? faux_timespec_to_nsec(budget) : 0;
+	eloop->busy_budget = eloop->busy_max;
+	faux_bzero(&eloop->busy_stats, sizeof(eloop->busy_stats));
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Gets statistics of busy polling.
+ *
+ * The hits is a number of spins that have found events. The misses is a
+ * number of spins that have given up and blocked. The wasted time is a
+ * total spin time of misses.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [out] stats Statistics of busy polling.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_eloop_busy_stats(const faux_eloop_t *eloop,
+	faux_eloop_busy_stats_t *stats)
+{
+	assert(eloop);
+	assert(stats);
+	if (!eloop || !stats)
+		return BOOL_FALSE;
+
+	*stats = eloop->busy_stats;
+	faux_nsec_to_timespec(&stats->budget, eloop->busy_budget);
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Gets statistics of event loop.
+ *
+ * The iterations, wait time and callback times are gathered since
+ * statistics enabling by faux_eloop_set_stats(). The durations of
+ * callbacks are broken down by event type. Use faux_eloop_fd_stats() to get
+ * callback durations of single fd. The lateness of scheduled events is
+ * taken from scheduler. See faux_sched_lateness().
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [out] stats Statistics.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error or if disabled.
+ */
+bool_t faux_eloop_stats(const faux_eloop_t *eloop, faux_eloop_stats_t *stats)
+{
+	assert(eloop);
+	assert(stats);
+	if (!eloop || !stats)
+		return BOOL_FALSE;
+	if (!eloop->stats)
+		return BOOL_FALSE;
+
+	*stats = *eloop->stats;
+	stats->sched_num = faux_sched_lateness(eloop->sched,
+		&stats->sched_lateness_avg, &stats->sched_lateness_max);
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Gets statistics of callbacks for single fd.
+ *
+ * The statistics are gathered while fd is registered. The fd removing
+ * drops its statistics.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] fd Registered file descriptor.
+ * @param [out] stats Statistics of fd callbacks.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error, if disabled or if fd
+ * is not registered.
+ */
+bool_t faux_eloop_fd_stats(const faux_eloop_t *eloop, int fd,
+	faux_eloop_cb_stats_t *stats)
+{
+	faux_eloop_fd_t *entry = NULL;
+
+	assert(eloop);
+	assert(stats);
+	if (!eloop || !stats)
+		return BOOL_FALSE;
+	if (!eloop->stats)
+		return BOOL_FALSE;
+
+	entry = faux_eloop_fd_entry(eloop, fd);
+	if (!entry)
+		return BOOL_FALSE;
+	if (entry->stats)
+		*stats = *entry->stats;
+	else
+		faux_bzero(stats, sizeof(*stats));
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Replaces scheduler of event loop.
+ *
+ * By default event loop uses scheduler created by faux_sched_new(). User
+ * can choose another scheduler implementation, faux_sched_new_wheel() for
+ * example. The event loop takes ownership of specified sched object and
+ * frees it later. The scheduler can be replaced only while loop is not
+ * working and both current and new schedulers are empty. The clock of
+ * new scheduler is changed to CLOCK_MONOTONIC.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] sched Allocated and initialized empty sched object.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_eloop_set_sched(faux_eloop_t *eloop, faux_sched_t *sched)
+{
+	assert(eloop);
+	assert(sched);
+	if (!eloop || !sched)
+		return BOOL_FALSE;
+	if (eloop->working)
+		return BOOL_FALSE;
+	if (faux_sched_init_ev_iter(eloop->sched) ||
+		faux_sched_init_ev_iter(sched))
+		return BOOL_FALSE; // Scheduled events can't be moved
+	if (!faux_sched_set_clock(sched, CLOCK_MONOTONIC))
+		return BOOL_FALSE;
+
+	faux_sched_free(eloop->sched);
+	eloop->sched = sched;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Gets loop time.
+ *
+ * The loop time is CLOCK_MONOTONIC time cached once per loop iteration
+ * while loop is working. So all callbacks of the same iteration get the
+ * same time without clock reading. It's current time of loop clock when
+ * loop is not working. The scheduled events are measured by loop time.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [out] now Loop time.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_eloop_now(const faux_eloop_t *eloop, struct timespec *now)
+{
+	assert(eloop);
+	assert(now);
+	if (!eloop || !now)
+		return BOOL_FALSE;
+
+	if (eloop->working)
+		*now = eloop->now;
+	else
+		clock_gettime(eloop->clock, now);
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Uses coarse clock to get loop time.
+ *
+ * The CLOCK_MONOTONIC_COARSE is faster to read than CLOCK_MONOTONIC but
+ * its resolution is about system tick (1-10 msec). So scheduled events can
+ * be popped with such inaccuracy. Both clocks have the same base so it can
+ * be changed at any moment. Not all systems support coarse clock.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] coarse BOOL_TRUE to use coarse clock, BOOL_FALSE for precise.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error or if not supported.
+ */
+bool_t faux_eloop_set_coarse_time(faux_eloop_t *eloop, bool_t coarse)
+{
+	assert(eloop);
+	if (!eloop)
+		return BOOL_FALSE;
+
+	if (!coarse) {
+		eloop->clock = CLOCK_MONOTONIC;
+		return BOOL_TRUE;
+	}
+#ifdef CLOCK_MONOTONIC_COARSE
+	{
+		struct timespec ts = {};
+		if (clock_gettime(CLOCK_MONOTONIC_COARSE, &ts) < 0)
+			return BOOL_FALSE;
+		eloop->clock = CLOCK_MONOTONIC_COARSE;
+		return BOOL_TRUE;
+	}
+#else
+	return BOOL_FALSE;
+#endif
+}
+
+
+/** @brief Posts task to execute within loop's thread.
+ *
+ * Service function. Same as faux_eloop_post() but with function to free
+ * argument if task will not be executed (loop is freed before).
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] fn Function to execute.
+ * @param [in] arg Argument for function.
+ * @param [in] free_arg_cb Function to free argument. Can be NULL.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_eloop_post_ext(faux_eloop_t *eloop,
+	faux_eloop_call_fn fn, void *arg, faux_list_free_fn free_arg_cb)
+{
+	faux_eloop_post_t *post = NULL;
+
+	assert(eloop);
+	assert(fn);
+	if (!eloop || !fn)
+		return BOOL_FALSE;
+
+	post = faux_zmalloc(sizeof(*post));
+	if (!post)
+		return BOOL_FALSE;
+	post->fn = fn;
+	post->arg = arg;
+	post->free_arg_cb = free_arg_cb;
+	faux_eloop_post_push(eloop, post);
+
+	// Only the first task of batch wakes up the loop
+	if (0 == __atomic_exchange_n(&eloop->post_signaled, 1,
+		__ATOMIC_ACQ_REL)) {
+#ifdef HAVE_EVENTFD
+		uint64_t one = 1;
+		faux_write(eloop->post_wfd, &one, sizeof(one));
+#else
+		char c = 0;
+		faux_write(eloop->post_wfd, &c, sizeof(c));
+#endif
+	}
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Posts task to execute within loop's thread.
+ *
+ * It's thread safe. It's the only function of event loop that can be used
+ * by another thread. The task is executed by loop on the next iteration.
+ * The task can be posted while loop is not working. Then it will be
+ * executed after loop start. The BOOL_FALSE return value of task function
+ * breaks the loop. The tasks that are not executed before faux_eloop_free()
+ * are dropped.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] fn Function to execute.
+ * @param [in] arg Argument for function.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_eloop_post(faux_eloop_t *eloop, faux_eloop_call_fn fn, void *arg)
+{
+	return faux_eloop_post_ext(eloop, fn, arg, NULL);
+}
+
+
+/** @brief Defers call until the end of current loop iteration.
+ *
+ * The function is executed after all ready fd, signal and scheduled event
+ * callbacks of current iteration. It's useful to batch work (writes for
+ * example) requested by several callbacks. Unlike scheduled events the
+ * deferred calls don't allocate memory in steady state and don't need a
+ * syscall. The calls are executed in order of deferring. The call deferred
+ * by deferred function is executed on the next iteration. The loop doesn't
+ * block while there are deferred calls. The BOOL_FALSE return value of
+ * function breaks the loop. Not executed calls are dropped by
+ * faux_eloop_free(). The function is not thread safe. Use faux_eloop_post()
+ * from another thread.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] fn Function to execute.
+ * @param [in] arg Argument for function.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_eloop_defer(faux_eloop_t *eloop, faux_eloop_call_fn fn, void *arg)
+{
+	assert(eloop);
+	assert(fn);
+	if (!eloop || !fn)
+		return BOOL_FALSE;
+
+	return faux_eloop_queue_push(&eloop->defer, fn, arg);
+}
+
+
+/** @brief Defers call until loop has nothing to do.
+ *
+ * The function is executed when loop would otherwise block waiting for
+ * events, i.e. there are no ready fds, signals, coming scheduled events and
+ * deferred calls. Each deferred call is executed once. See
+ * faux_eloop_defer() for other details.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] fn Function to execute.
+ * @param [in] arg Argument for function.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_eloop_defer_idle(faux_eloop_t *eloop, faux_eloop_call_fn fn,
+	void *arg)
+{
+	assert(eloop);
+	assert(fn);
+	if (!eloop || !fn)
+		return BOOL_FALSE;
+
+	return faux_eloop_queue_push(&eloop->idle, fn, arg);
+}
@@ -0,0 +1,702 @@
+/** @file group.c
+ * @brief Group of event loops served by separate threads.
+ *
+ * The single faux_eloop_t object can be used by single thread only. The
+ * group contains several independent event loops. Each loop is served by
+ * its own thread. The thread is pinned to CPU if system supports it. The
+ * loop with index N gets the (N modulo number of CPUs)-th CPU of the
+ * affinity set of thread that starts the group. So the group allows to use
+ * several CPU cores and respects cpusets and taskset restrictions.
+ *
+ * The loops don't share anything. Another thread can ask loop to execute
+ * function within loop's thread by faux_eloop_group_call(). It's a wrapper
+ * for faux_eloop_post().
+ *
+ * The listening sockets can be served by group. There are two ways to
+ * distribute accepted connections among loops. The listener added by
+ * faux_eloop_group_add_listener() is served by the first loop. It accepts
+ * connections and passes them to loops in round-robin order. The
+ * faux_eloop_group_listen() creates separate listening socket with
+ * SO_REUSEPORT option for each loop. Then the kernel distributes
+ * connections among sockets.
+ *
+ * The signals are blocked within group threads. The loops of group must not
+ * register signal handlers.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#include "faux/faux.h"
+#include "faux/list.h"
+#include "faux/eloop.h"
+
+#include "private.h"
+
+// Connection accepted by one loop and passed to another one
+typedef struct faux_eloop_group_conn_s {
+	faux_eloop_group_listener_t *listener;
+	int fd;
+} faux_eloop_group_conn_t;
+
+
+/** @brief Sets close-on-exec and non-blocking flags for fd.
+ *
+ * Static service function.
+ *
+ * @param [in] fd File descriptor.
+ */
+static void faux_eloop_group_fd_flags(int fd)
+{
+	int fflags = 0;
+
+	fcntl(fd, F_SETFD, FD_CLOEXEC);
+	fflags = fcntl(fd, F_GETFL);
+	fcntl(fd, F_SETFL, fflags | O_NONBLOCK);
+}
+
+
+/** @brief Frees listener.
+ *
+ * Static service function. It's used as a free callback for listeners list.
+ *
+ * @param [in] ptr Listener to free.
+ */
+static void faux_eloop_group_listener_free(void *ptr)
+{
+	faux_eloop_group_listener_t *listener =
+		(faux_eloop_group_listener_t *)ptr;
+
+	if (!listener)
+		return;
+
+	if (listener->own_fd)
+		close(listener->fd);
+	faux_free(listener);
+}
+
+
+/** @brief Call to break the loop.
+ *
+ * Static service function.
+ *
+ * @param [in] eloop Event loop.
+ * @param [in] arg Not used.
+ * @return BOOL_FALSE to break the loop.
+ */
+static bool_t faux_eloop_group_stop_call(faux_eloop_t *eloop, void *arg)
+{
+	eloop = eloop; // Happy compiler
+	arg = arg; // Happy compiler
+
+	return BOOL_FALSE;
+}
+
+
+/** @brief Frees connection passed between loops.
+ *
+ * Static service function. The connection is not processed so close it.
+ *
+ * @param [in] ptr Connection.
+ */
+static void faux_eloop_group_conn_free(void *ptr)
+{
+	faux_eloop_group_conn_t *conn = (faux_eloop_group_conn_t *)ptr;
+
+	if (!conn)
+		return;
+
+	close(conn->fd);
+	faux_free(conn);
+}
+
+
+/** @brief Passes accepted connection to user callback.
+ *
+ * Static service function. It's executed within the loop that got the
+ * connection from another loop.
+ *
+ * @param [in] eloop Event loop.
+ * @param [in] arg Connection.
+ * @return Return value of user callback.
+ */
+static bool_t faux_eloop_group_conn_call(faux_eloop_t *eloop, void *arg)
+{
+	faux_eloop_group_conn_t *conn = (faux_eloop_group_conn_t *)arg;
+	faux_eloop_group_listener_t *listener = conn->listener;
+	int fd = conn->fd;
+
+	faux_free(conn);
+
+	return listener->accept_cb(eloop, fd, listener->user_data);
+}
+
+
+/** @brief Accepts connections on listening socket.
+ *
+ * Static service function. It's a callback for listening socket. The
+ * round-robin listener passes connections to loops in turn. The
+ * SO_REUSEPORT listener processes connections within the current loop.
+ *
+ * @param [in] eloop Event loop.
+ * @param [in] type Type of event.
+ * @param [in] associated_data Information about fd event.
+ * @param [in] user_data Listener.
+ * @return BOOL_FALSE if user callback asks to break the loop.
+ */
+static bool_t faux_eloop_group_accept_cb(faux_eloop_t *eloop,
+	faux_eloop_type_e type, void *associated_data, void *user_data)
+{
+	faux_eloop_group_listener_t *listener =
+		(faux_eloop_group_listener_t *)user_data;
+	faux_eloop_info_fd_t *info = (faux_eloop_info_fd_t *)associated_data;
+	faux_eloop_group_t *group = listener->group;
+	bool_t retval = BOOL_TRUE;
+	int fd = -1;
+
+	while ((fd = accept(info->fd, NULL, NULL)) >= 0) {
+		faux_eloop_group_loop_t *loop = NULL;
+		faux_eloop_group_conn_t *conn = NULL;
+
+		faux_eloop_group_fd_flags(fd);
+		if (!listener->round_robin) {
+			if (!listener->accept_cb(eloop, fd, listener->user_data))
+				retval = BOOL_FALSE;
+			continue;
+		}
+
+		loop = &group->loops[group->next_loop];
+		group->next_loop = (group->next_loop + 1) % group->num;
+		if (loop->eloop == eloop) {
+			if (!listener->accept_cb(eloop, fd, listener->user_data))
+				retval = BOOL_FALSE;
+			continue;
+		}
+		conn = faux_zmalloc(sizeof(*conn));
+		if (!conn) {
+			close(fd);
+			continue;
+		}
+		conn->listener = listener;
+		conn->fd = fd;
+		if (!faux_eloop_post_ext(loop->eloop, faux_eloop_group_conn_call,
+			conn, faux_eloop_group_conn_free))
+			faux_eloop_group_conn_free(conn);
+	}
+
+	type = type; // Happy compiler
+
+	return retval;
+}
+
+
+#ifdef HAVE_PTHREAD_GETAFFINITY_NP
+/** @brief Gets CPUs the current thread is allowed to run on.
+ *
+ * Static service function.
+ *
+ * @param [out] cpu_set Set of allowed CPUs.
+ * @return Number of allowed CPUs or 0 on error.
+ */
+static unsigned int faux_eloop_group_allowed_cpus(cpu_set_t *cpu_set)
+{
+	CPU_ZERO(cpu_set);
+	if (pthread_getaffinity_np(pthread_self(),
+		sizeof(*cpu_set), cpu_set) != 0)
+		return 0;
+
+	return CPU_COUNT(cpu_set);
+}
+#endif
+
+
+/** @brief Thread function to serve loop of group.
+ *
+ * Static service function.
+ *
+ * @param [in] arg Loop of group.
+ * @return NULL.
+ */
+static void *faux_eloop_group_thread(void *arg)
+{
+	faux_eloop_group_loop_t *loop = (faux_eloop_group_loop_t *)arg;
+#if defined(HAVE_PTHREAD_SETAFFINITY_NP) && defined(HAVE_PTHREAD_GETAFFINITY_NP)
+	cpu_set_t allowed;
+	unsigned int cpus = faux_eloop_group_allowed_cpus(&allowed);
+
+	// The thread inherits affinity set of thread that starts the group
+	if (cpus > 0) {
+		cpu_set_t cpu_set;
+		unsigned int n = loop->index % cpus;
+		int cpu = 0;
+		for (cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+			if (!CPU_ISSET(cpu, &allowed))
+				continue;
+			if (0 == n)
+				break;
+			n--;
+		}
+		CPU_ZERO(&cpu_set);
+		CPU_SET(cpu, &cpu_set);
+		pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+	}
+#endif
+
+	faux_eloop_loop(loop->eloop);
+
+	return NULL;
+}
+
+
+/** @brief Inits single loop of group.
+ *
+ * Static service function.
+ *
+ * @param [in] group Group of loops.
+ * @param [in] loop Loop to init.
+ * @param [in] index Index of loop.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+static bool_t faux_eloop_group_loop_init(faux_eloop_group_t *group,
+	faux_eloop_group_loop_t *loop, unsigned int index)
+{
+	// Init
+	loop->group = group;
+	loop->index = index;
+	loop->started = BOOL_FALSE;
+	loop->eloop = faux_eloop_new(NULL);
+	if (!loop->eloop)
+		return BOOL_FALSE;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Frees single loop of group.
+ *
+ * Static service function.
+ *
+ * @param [in] loop Loop to free.
+ */
+static void faux_eloop_group_loop_free(faux_eloop_group_loop_t *loop)
+{
+	faux_eloop_free(loop->eloop);
+}
+
+
+/** @brief Creates group of event loops.
+ *
+ * The loops are created but not started. User can register fds, scheduled
+ * events etc. for each loop before start. See faux_eloop_group_eloop().
+ *
+ * @param [in] num Number of loops. 0 - number of CPUs allowed for caller.
+ * @return Allocated group or NULL on error.
+ */
+faux_eloop_group_t *faux_eloop_group_new(unsigned int num)
+{
+	faux_eloop_group_t *group = NULL;
+	unsigned int i = 0;
+
+	if (0 == num) {
+#ifdef HAVE_PTHREAD_GETAFFINITY_NP
+		cpu_set_t allowed;
+		num = faux_eloop_group_allowed_cpus(&allowed);
+#endif
+		if (0 == num) {
+			long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+			num = (cpus > 0) ? (unsigned int)cpus : 1;
+		}
+	}
+
+	group = faux_zmalloc(sizeof(*group));
+	assert(group);
+	if (!group)
+		return NULL;
+
+	// Init
+	group->num = 0;
+	group->started = BOOL_FALSE;
+	group->next_loop = 0;
+	group->listeners = faux_list_new(FAUX_LIST_UNSORTED, FAUX_LIST_NONUNIQUE,
+		NULL, NULL, faux_eloop_group_listener_free);
+	group->loops = faux_zmalloc(num * sizeof(*group->loops));
+	if (!group->listeners || !group->loops) {
+		faux_eloop_group_free(group);
+		return NULL;
+	}
+	for (i = 0; i < num; i++) {
+		bool_t res = faux_eloop_group_loop_init(group,
+			&group->loops[i], i);
+		group->num++; // Partially initialized loop must be freed too
+		if (!res) {
+			faux_eloop_group_free(group);
+			return NULL;
+		}
+	}
+
+	return group;
+}
+
+
+/** @brief Frees group of event loops.
+ *
+ * Stops running loops before freeing.
+ *
+ * @param [in] group Group of loops.
+ */
+void faux_eloop_group_free(faux_eloop_group_t *group)
+{
+	unsigned int i = 0;
+
+	if (!group)
+		return;
+
+	faux_eloop_group_stop(group);
+	for (i = 0; i < group->num; i++)
+		faux_eloop_group_loop_free(&group->loops[i]);
+	faux_free(group->loops);
+	faux_list_free(group->listeners);
+	faux_free(group);
+}
+
+
+/** @brief Gets number of loops within group.
+ *
+ * @param [in] group Group of loops.
+ * @return Number of loops.
+ */
+unsigned int faux_eloop_group_len(const faux_eloop_group_t *group)
+{
+	assert(group);
+	if (!group)
+		return 0;
+
+	return group->num;
+}
+
+
+/** @brief Gets event loop of group by index.
+ *
+ * The loop must not be changed by another thread when group is started.
+ * Use faux_eloop_group_call() to do something within loop's thread.
+ *
+ * @param [in] group Group of loops.
+ * @param [in] index Index of loop.
+ * @return Event loop or NULL on error.
+ */
+faux_eloop_t *faux_eloop_group_eloop(const faux_eloop_group_t *group,
+	unsigned int index)
+{
+	assert(group);
+	if (!group)
+		return NULL;
+	if (index >= group->num)
+		return NULL;
+
+	return group->loops[index].eloop;
+}
+
+
+/** @brief Starts threads to serve loops.
+ *
+ * The signals are blocked within threads.
+ *
+ * @param [in] group Group of loops.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_eloop_group_start(faux_eloop_group_t *group)
+{
+	sigset_t all_signals;
+	sigset_t orig_sig_set;
+	bool_t retval = BOOL_TRUE;
+	unsigned int i = 0;
+
+	assert(group);
+	if (!group)
+		return BOOL_FALSE;
+	if (group->started)
+		return BOOL_FALSE;
+
+	// Threads inherit signal mask
+	sigfillset(&all_signals);
+	pthread_sigmask(SIG_SETMASK, &all_signals, &orig_sig_set);
+	group->started = BOOL_TRUE;
+	for (i = 0; i < group->num; i++) {
+		faux_eloop_group_loop_t *loop = &group->loops[i];
+		if (pthread_create(&loop->thread, NULL,
+			faux_eloop_group_thread, loop) != 0) {
+			retval = BOOL_FALSE;
+			break;
+		}
+		loop->started = BOOL_TRUE;
+	}
+	pthread_sigmask(SIG_SETMASK, &orig_sig_set, NULL);
+
+	if (!retval)
+		faux_eloop_group_stop(group);
+
+	return retval;
+}
+
+
+/** @brief Stops all loops of group and waits for threads.
+ *
+ * The calls queued before stop are executed. The calls queued later will
+ * be executed after next start. Function must not be called from the
+ * thread of group.
+ *
+ * @param [in] group Group of loops.
+ * @return BOOL_TRUE - success, BOOL_FALSE if group is not started or error.
+ */
+bool_t faux_eloop_group_stop(faux_eloop_group_t *group)
+{
+	unsigned int i = 0;
+
+	assert(group);
+	if (!group)
+		return BOOL_FALSE;
+	if (!group->started)
+		return BOOL_FALSE;
+
+	for (i = 0; i < group->num; i++) {
+		faux_eloop_group_loop_t *loop = &group->loops[i];
+		if (loop->started && pthread_equal(loop->thread, pthread_self()))
+			return BOOL_FALSE; // Thread can't join itself
+	}
+
+	for (i = 0; i < group->num; i++) {
+		faux_eloop_group_loop_t *loop = &group->loops[i];
+		if (!loop->started)
+			continue;
+		faux_eloop_post(loop->eloop, faux_eloop_group_stop_call, NULL);
+	}
+	for (i = 0; i < group->num; i++) {
+		faux_eloop_group_loop_t *loop = &group->loops[i];
+		if (!loop->started)
+			continue;
+		pthread_join(loop->thread, NULL);
+		loop->started = BOOL_FALSE;
+	}
+	group->started = BOOL_FALSE;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Executes function within the thread of specified loop.
+ *
+ * It's thread safe. The function is executed on the next iteration of
+ * loop. The BOOL_FALSE return value of function breaks the loop. The calls
+ * queued before start of group are executed after start.
+ *
+ * @param [in] group Group of loops.
+ * @param [in] index Index of loop.
+ * @param [in] fn Function to execute.
+ * @param [in] arg Argument for function.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_eloop_group_call(faux_eloop_group_t *group, unsigned int index,
+	faux_eloop_call_fn fn, void *arg)
+{
+	assert(group);
+	assert(fn);
+	if (!group || !fn)
+		return BOOL_FALSE;
+	if (index >= group->num)
+		return BOOL_FALSE;
+
+	return faux_eloop_post(group->loops[index].eloop, fn, arg);
+}
+
+
+/** @brief Adds listening socket to distribute connections in round-robin.
+ *
+ * The socket is served by the first loop of group. The accepted connections
+ * are passed to loops in turn. The accept_cb is executed within the loop
+ * that gets connection. The socket is switched to non-blocking mode. The
+ * socket is not closed by group. Listener can be added before start only.
+ *
+ * @param [in] group Group of loops.
+ * @param [in] fd Listening socket.
+ * @param [in] accept_cb Callback for accepted connection.
+ * @param [in] user_data User data for callback.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_eloop_group_add_listener(faux_eloop_group_t *group, int fd,
+	faux_eloop_accept_fn accept_cb, void *user_data)
+{
+	faux_eloop_group_listener_t *listener = NULL;
+	faux_list_node_t *node = NULL;
+
+	assert(group);
+	assert(accept_cb);
+	if (!group || !accept_cb || (fd < 0))
+		return BOOL_FALSE;
+	if (group->started)
+		return BOOL_FALSE;
+
+	listener = faux_zmalloc(sizeof(*listener));
+	if (!listener)
+		return BOOL_FALSE;
+	listener->group = group;
+	listener->fd = fd;
+	listener->own_fd = BOOL_FALSE;
+	listener->round_robin = BOOL_TRUE;
+	listener->accept_cb = accept_cb;
+	listener->user_data = user_data;
+	if (!(node = faux_list_add(group->listeners, listener))) {
+		faux_free(listener);
+		return BOOL_FALSE;
+	}
+	faux_eloop_group_fd_flags(fd);
+	if (!faux_eloop_add_fd(group->loops[0].eloop, fd, POLLIN,
+		faux_eloop_group_accept_cb, listener)) {
+		faux_list_del(group->listeners, node);
+		return BOOL_FALSE;
+	}
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Creates listening sockets with SO_REUSEPORT for each loop.
+ *
+ * Each loop gets its own TCP listening socket bound to the same address.
+ * The kernel distributes connections among sockets. The accept_cb is
+ * executed within the loop that accepts connection. If port is 0 then
+ * the port assigned to the first socket is used for all sockets. The
+ * sockets are closed by group. Listener can be added before start only.
+ *
+ * @param [in] group Group of loops.
+ * @param [in] addr Address to bind to.
+ * @param [in] addrlen Length of address.
+ * @param [in] accept_cb Callback for accepted connection.
+ * @param [in] user_data User data for callback.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error or if not supported.
+ */
+bool_t faux_eloop_group_listen(faux_eloop_group_t *group,
+	const struct sockaddr *addr, socklen_t addrlen,
+	faux_eloop_accept_fn accept_cb, void *user_data)
+{
+#ifdef SO_REUSEPORT
+	struct sockaddr_storage bind_addr = {};
+	socklen_t bind_addrlen = addrlen;
+	int *fds = NULL;
+	faux_list_node_t **nodes = NULL;
+	unsigned int i = 0;
+	unsigned int created = 0;
+	unsigned int added = 0;
+
+	assert(group);
+	assert(addr);
+	assert(accept_cb);
+	if (!group || !addr || !accept_cb)
+		return BOOL_FALSE;
+	if (group->started)
+		return BOOL_FALSE;
+	if (addrlen > sizeof(bind_addr))
+		return BOOL_FALSE;
+	memcpy(&bind_addr, addr, addrlen);
+
+	fds = faux_zmalloc(group->num * sizeof(*fds));
+	if (!fds)
+		return BOOL_FALSE;
+	for (created = 0; created < group->num; created++) {
+		int opt = 1;
+		int fd = socket(addr->sa_family, SOCK_STREAM, 0);
+		if (fd < 0)
+			break;
+		fds[created] = fd;
+		faux_eloop_group_fd_flags(fd);
+		if ((setsockopt(fd, SOL_SOCKET, SO_REUSEADDR,
+				&opt, sizeof(opt)) < 0) ||
+			(setsockopt(fd, SOL_SOCKET, SO_REUSEPORT,
+				&opt, sizeof(opt)) < 0) ||
+			(bind(fd, (struct sockaddr *)&bind_addr,
+				bind_addrlen) < 0) ||
+			(listen(fd, SOMAXCONN) < 0)) {
+			close(fd);
+			break;
+		}
+		// The port 0 means "any". So get the real port.
+		if (0 == created) {
+			bind_addrlen = sizeof(bind_addr);
+			if (getsockname(fd, (struct sockaddr *)&bind_addr,
+				&bind_addrlen) < 0) {
+				close(fd);
+				break;
+			}
+		}
+	}
+	if (created < group->num) {
+		for (i = 0; i < created; i++)
+			close(fds[i]);
+		faux_free(fds);
+		return BOOL_FALSE;
+	}
+
+	// Listeners own sockets so they will be closed by group
+	nodes = faux_zmalloc(group->num * sizeof(*nodes));
+	for (added = 0; nodes && (added < group->num); added++) {
+		faux_eloop_group_listener_t *listener = NULL;
+		listener = faux_zmalloc(sizeof(*listener));
+		if (!listener)
+			break;
+		listener->group = group;
+		listener->fd = fds[added];
+		listener->own_fd = BOOL_TRUE;
+		listener->round_robin = BOOL_FALSE;
+		listener->accept_cb = accept_cb;
+		listener->user_data = user_data;
+		if (!(nodes[added] = faux_list_add(group->listeners, listener))) {
+			faux_free(listener);
+			break;
+		}
+		if (!faux_eloop_add_fd(group->loops[added].eloop, fds[added],
+			POLLIN, faux_eloop_group_accept_cb, listener)) {
+			faux_list_del(group->listeners, nodes[added]);
+			fds[added] = -1; // Closed by listener
+			break;
+		}
+	}
+	if (added < group->num) {
+		for (i = 0; i < added; i++) {
+			faux_eloop_del_fd(group->loops[i].eloop, fds[i]);
+			faux_list_del(group->listeners, nodes[i]);
+		}
+		for (i = added; i < group->num; i++) {
+			if (fds[i] >= 0)
+				close(fds[i]);
+		}
+		faux_free(nodes);
+		faux_free(fds);
+		return BOOL_FALSE;
+	}
+	faux_free(nodes);
+	faux_free(fds);
+
+	return BOOL_TRUE;
+
+#else // SO_REUSEPORT is not supported
+	group = group; // Happy compiler
+	addr = addr; // Happy compiler
+	addrlen = addrlen; // Happy compiler
+	accept_cb = accept_cb; // Happy compiler
+	user_data = user_data; // Happy compiler
+
+	return BOOL_FALSE;
+#endif
+}
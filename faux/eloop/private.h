@@ -1,38 +1,240 @@
+#include <pthread.h>
+
 #include "faux/faux.h"
 #include "faux/list.h"
 #include "faux/net.h"
 #include "faux/vec.h"
 #include "faux/sched.h"
+#include "faux/async.h"
+
+#ifdef HAVE_EPOLL_PWAIT
+#include <sys/epoll.h>
+
+// Max number of ready events to get by single epoll_pwait() call
+#define EPOLL_EVENTS_NUM 64
+#endif
+
+#ifdef HAVE_IO_URING
+#include <stdint.h>
+#include <linux/io_uring.h>
+
+#define URING_ENTRIES 256 // Number of submission queue entries
+#define URING_EVENTS_NUM 64 // Max number of ready events per wait
+#define URING_IO_CHUNK 16384 // Size of buffer for read and write requests
+
+// Read or write request of async object. Owns its buffer so the request
+// can outlive async object.
+typedef struct faux_eloop_uring_io_s {
+	faux_async_t *async; // NULL if async object is unregistered
+	int fd;
+	uint8_t opcode; // IORING_OP_READ or IORING_OP_WRITE
+	size_t len; // Length of data within buffer (buffer size for read)
+	size_t off; // Offset of data not written yet
+	char buf[URING_IO_CHUNK];
+} faux_eloop_uring_io_t;
+
+// State of fd watched by io_uring
+typedef struct faux_eloop_uring_fd_s {
+	short events; // Interested events
+	bool_t watched; // Fd is watched by loop
+	bool_t armed; // Poll request is submitted and not completed
+	uint32_t gen; // Generation to filter out stale completions
+	faux_async_t *async; // Async object served by read/write requests
+	faux_eloop_uring_io_t *rd; // Active read request
+	faux_eloop_uring_io_t *wr; // Active write request
+} faux_eloop_uring_fd_t;
+
+typedef struct faux_eloop_uring_ready_s {
+	int fd;
+	short revents;
+} faux_eloop_uring_ready_t;
+
+typedef struct faux_eloop_uring_s {
+	int fd; // Handler of io_uring instance
+	void *sq_ptr; // Mapped submission queue ring
+	size_t sq_size;
+	void *cq_ptr; // Mapped completion queue ring. Can be equal to sq_ptr
+	size_t cq_size;
+	struct io_uring_sqe *sqes; // Mapped submission queue entries
+	size_t sqes_size;
+	unsigned int *sq_head;
+	unsigned int *sq_tail;
+	unsigned int *sq_mask;
+	unsigned int *sq_array;
+	unsigned int sq_entries;
+	unsigned int *cq_head;
+	unsigned int *cq_tail;
+	unsigned int *cq_mask;
+	struct io_uring_cqe *cqes;
+	faux_eloop_uring_fd_t *fds; // Table of watched fds. Indexed by fd
+	size_t fds_size; // Number of allocated entries within fds table
+	faux_eloop_uring_ready_t ready[URING_EVENTS_NUM]; // Ready events
+	int ready_num; // Number of ready events got by the last wait
+	size_t io_num; // Number of read/write requests within kernel
+} faux_eloop_uring_t;
+#endif
+
+
+typedef struct faux_eloop_context_s {
+	faux_eloop_cb_fn event_cb;
+	void *user_data;
+} faux_eloop_context_t;
+
+// Task posted to loop by another thread. Item of MPSC queue.
+typedef struct faux_eloop_post_s faux_eloop_post_t;
+struct faux_eloop_post_s {
+	faux_eloop_post_t *next;
+	faux_eloop_call_fn fn;
+	void *arg;
+	faux_list_free_fn free_arg_cb; // Frees arg if task is not executed
+};
+
+// Deferred call. Item of deferred and idle queues.
+typedef struct faux_eloop_call_s {
+	faux_eloop_call_fn fn;
+	void *arg;
+} faux_eloop_call_t;
+
+// Ring buffer of deferred calls. Storage is reused so steady state doesn't
+// allocate memory.
+typedef struct faux_eloop_queue_s {
+	faux_eloop_call_t *calls;
+	size_t size; // Number of allocated items
+	size_t head; // Index of the first call
+	size_t len; // Number of queued calls
+} faux_eloop_queue_t;
+
+typedef struct faux_eloop_fd_s {
+	int fd; // Registered fd or -1 for unused entry of table
+	short events;
+	faux_eloop_context_t context;
+	faux_eloop_cb_stats_t *stats; // Allocated while stats are enabled
+	faux_eloop_prio_e prio; // Dispatch priority
+	faux_async_t *async; // Async object served by loop. NULL for plain fd
+	short revents; // Returned events of the last dispatch
+	bool_t requeued; // Must be dispatched on the next iteration
+	uint64_t ready_seq; // Dispatch pass when fd was got as ready
+	uint64_t dispatch_seq; // Dispatch pass when fd callback was executed
+	uint64_t gen; // Registration number. Distinguishes reused fd numbers
+} faux_eloop_fd_t;
+
+// Ready fd to dispatch
+typedef struct faux_eloop_ready_s {
+	int fd;
+	short revents;
+	uint64_t gen; // Registration number of fd when it got ready
+} faux_eloop_ready_t;
 
 
 struct faux_eloop_s {
 	bool_t working; // Is event loop active now. Can detect nested loop.
 	faux_eloop_cb_fn default_event_cb; // Default callback function
 	faux_sched_t *sched; // Service shed structure
-	faux_list_t *fds; // List of registered file descriptors
+	unsigned int sched_limit; // Max number of sched callbacks per iteration
+	clockid_t clock; // Clock to get loop time (monotonic)
+	struct timespec now; // Cached loop time. Updated once per wait.
+	faux_eloop_fd_t *fds; // Table of registered fds. Indexed by fd
+	size_t fds_size; // Number of allocated entries within fds table
+	size_t fds_num; // Number of registered fds
+	uint64_t fds_gen; // Number of fd registrations
+	faux_eloop_backend_e backend; // Mechanism to wait for fd events
 	faux_pollfd_t *pollfds; // Service object for ppoll()
+#ifdef HAVE_EPOLL_PWAIT
+	int epoll_fd; // Handler for epoll. Valid for epoll backend only
+	struct epoll_event epoll_events[EPOLL_EVENTS_NUM]; // Ready events
+#endif
+#ifdef HAVE_IO_URING
+	faux_eloop_uring_t *uring; // Valid for io_uring backend only
+#endif
 	faux_list_t *signals; // List of registered signals
 	sigset_t sig_set; // Set of registered signals (1 for interested signal)
 	sigset_t sig_mask; // Mask of registered signals (0 - interested) = not sig_set
 #ifdef HAVE_SIGNALFD
 	int signal_fd; // Handler for signalfd(). Valid when loop is active only
 #endif
+	faux_eloop_post_t *post_head; // Last posted task. Changed by producers
+	faux_eloop_post_t *post_tail; // Next task to execute. Used by loop only
+	faux_eloop_post_t post_stub; // Stub item. Queue is never empty
+	int post_signaled; // Loop is woken up already. Atomic access only
+	int post_fd; // Eventfd or read end of pipe to wake up loop
+	int post_wfd; // Write end to wake up loop. Same as post_fd for eventfd
+	faux_eloop_stats_t *stats; // Statistics. NULL if disabled
+	size_t prio_fds; // Number of fds with non-default priority
+	faux_eloop_ready_t *ready; // Ready fds of current dispatch pass
+	size_t ready_size; // Number of allocated items within ready array
+	size_t ready_num; // Number of ready fds
+	uint64_t ready_seq; // Number of dispatch pass
+	int *requeue; // Fds to dispatch on the next iteration
+	size_t requeue_size; // Number of allocated items within requeue array
+	size_t requeue_num; // Number of requeued fds
+	uint64_t busy_max; // Max spin budget (nsec). 0 - busy poll is disabled
+	uint64_t busy_budget; // Current adaptive spin budget (nsec)
+	faux_eloop_busy_stats_t busy_stats; // Statistics of busy polling
+	faux_eloop_queue_t defer; // Calls to execute after dispatch pass
+	faux_eloop_queue_t idle; // Calls to execute when loop has nothing to do
 };
 
 
-typedef struct faux_eloop_context_s {
-	faux_eloop_cb_fn event_cb;
-	void *user_data;
-} faux_eloop_context_t;
-
-typedef struct faux_eloop_fd_s {
-	int fd;
-	short events;
-	faux_eloop_context_t context;
-} faux_eloop_fd_t;
-
 typedef struct faux_eloop_signal_s {
 	int signo;
 	struct sigaction oldact;
 	faux_eloop_context_t context;
 } faux_eloop_signal_t;
+
+
+
+
+// Single loop of group. It's served by its own thread.
+typedef struct faux_eloop_group_loop_s {
+	faux_eloop_group_t *group;
+	unsigned int index; // Index of loop within group
+	faux_eloop_t *eloop;
+	pthread_t thread;
+	bool_t started; // Thread is created
+} faux_eloop_group_loop_t;
+
+
+// Listener to distribute accepted connections among loops
+typedef struct faux_eloop_group_listener_s {
+	faux_eloop_group_t *group;
+	int fd;
+	bool_t own_fd; // Listener socket is created by group
+	bool_t round_robin; // Pass connections to loops in turn
+	faux_eloop_accept_fn accept_cb;
+	void *user_data;
+} faux_eloop_group_listener_t;
+
+
+struct faux_eloop_group_s {
+	unsigned int num; // Number of loops
+	faux_eloop_group_loop_t *loops;
+	bool_t started; // Threads are running
+	faux_list_t *listeners;
+	unsigned int next_loop; // Next loop to get connection (round-robin)
+};
+
+
+C_DECL_BEGIN
+
+FAUX_HIDDEN bool_t faux_eloop_post_ext(faux_eloop_t *eloop,
+	faux_eloop_call_fn fn, void *arg, faux_list_free_fn free_arg_cb);
+
+#ifdef HAVE_IO_URING
+FAUX_HIDDEN faux_eloop_uring_t *faux_eloop_uring_new(void);
+FAUX_HIDDEN void faux_eloop_uring_free(faux_eloop_uring_t *uring);
+FAUX_HIDDEN bool_t faux_eloop_uring_watch(faux_eloop_uring_t *uring,
+	int fd, short events);
+FAUX_HIDDEN bool_t faux_eloop_uring_unwatch(faux_eloop_uring_t *uring,
+	int fd);
+FAUX_HIDDEN int faux_eloop_uring_wait(faux_eloop_uring_t *uring,
+	const struct timespec *timeout, const sigset_t *sigmask);
+FAUX_HIDDEN bool_t faux_eloop_uring_add_async(faux_eloop_uring_t *uring,
+	faux_async_t *async);
+FAUX_HIDDEN bool_t faux_eloop_uring_del_async(faux_eloop_uring_t *uring,
+	int fd);
+FAUX_HIDDEN ssize_t faux_eloop_uring_async_out(faux_eloop_uring_t *uring,
+	int fd);
+#endif
+
+C_DECL_END
+
@@ -0,0 +1,1603 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <poll.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "faux/faux.h"
+#include "faux/time.h"
+#include "faux/eloop.h"
+
+
+typedef struct {
+	int pipefd[2];
+	unsigned int fd_events;
+	unsigned int sched_events;
+} eloop_test_t;
+
+
+static bool_t sched_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	void *associated_data, void *user_data)
+{
+	eloop_test_t *t = (eloop_test_t *)user_data;
+
+	t->sched_events++;
+	if (write(t->pipefd[1], "x", 1) != 1)
+		return BOOL_FALSE;
+
+	eloop = eloop; // Happy compiler
+	type = type; // Happy compiler
+	associated_data = associated_data; // Happy compiler
+
+	return BOOL_TRUE;
+}
+
+
+static bool_t fd_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	void *associated_data, void *user_data)
+{
+	eloop_test_t *t = (eloop_test_t *)user_data;
+	faux_eloop_info_fd_t *info = (faux_eloop_info_fd_t *)associated_data;
+	char buf[16];
+
+	if (type != FAUX_ELOOP_FD)
+		return BOOL_FALSE;
+	if (!(info->revents & POLLIN))
+		return BOOL_FALSE;
+	if (read(info->fd, buf, sizeof(buf)) <= 0)
+		return BOOL_FALSE;
+	t->fd_events++;
+
+	eloop = eloop; // Happy compiler
+
+	// Stop the loop after third event
+	if (t->fd_events >= 3)
+		return BOOL_FALSE;
+
+	return BOOL_TRUE;
+}
+
+
+static int eloop_test(faux_eloop_backend_e backend)
+{
+	faux_eloop_t *eloop = NULL;
+	eloop_test_t t = {};
+	struct timespec period = {0, 10000000l}; // 10ms
+	int ret = -1;
+
+	if (pipe(t.pipefd) < 0)
+		return -1;
+
+	eloop = faux_eloop_new(NULL);
+	if (!faux_eloop_set_backend(eloop, backend)) {
+		fprintf(stderr, "Can't set backend %d\n", backend);
+		goto err;
+	}
+	faux_eloop_add_fd(eloop, t.pipefd[0], POLLIN, fd_cb, &t);
+	faux_eloop_add_sched_periodic_delayed(eloop, 1, sched_cb, &t,
+		&period, FAUX_SCHED_INFINITE);
+	faux_eloop_loop(eloop);
+
+	if (t.fd_events != 3) {
+		fprintf(stderr, "Wrong number of fd events: %u\n", t.fd_events);
+		goto err;
+	}
+	if (t.sched_events != 3) {
+		fprintf(stderr, "Wrong number of sched events: %u\n",
+			t.sched_events);
+		goto err;
+	}
+
+	ret = 0;
+err:
+	faux_eloop_free(eloop);
+	close(t.pipefd[0]);
+	close(t.pipefd[1]);
+
+	return ret;
+}
+
+
+int testc_faux_eloop_poll(void)
+{
+	return eloop_test(FAUX_ELOOP_BACKEND_POLL);
+}
+
+
+int testc_faux_eloop_epoll(void)
+{
+	faux_eloop_t *eloop = faux_eloop_new(NULL);
+	bool_t supported = faux_eloop_set_backend(eloop,
+		FAUX_ELOOP_BACKEND_EPOLL);
+
+	faux_eloop_free(eloop);
+	if (!supported) {
+		printf("The epoll() backend is not supported. Skipped\n");
+		return 0;
+	}
+
+	return eloop_test(FAUX_ELOOP_BACKEND_EPOLL);
+}
+
+
+int testc_faux_eloop_uring(void)
+{
+	faux_eloop_t *eloop = faux_eloop_new(NULL);
+	bool_t supported = faux_eloop_set_backend(eloop,
+		FAUX_ELOOP_BACKEND_URING);
+
+	faux_eloop_free(eloop);
+	if (!supported) {
+		printf("The io_uring backend is not supported. Skipped\n");
+		return 0;
+	}
+
+	return eloop_test(FAUX_ELOOP_BACKEND_URING);
+}
+
+
+#define ASYNC_ROUNDS 500
+#define ASYNC_MSG "ping"
+#define ASYNC_MSG_LEN (sizeof(ASYNC_MSG) - 1)
+
+typedef struct {
+	int fd;
+	unsigned int rounds;
+} async_peer_t;
+
+typedef struct {
+	faux_async_t *async;
+	size_t echoed;
+	bool_t eof;
+} async_test_t;
+
+
+// Peer sends message and waits for echo
+static void *async_peer(void *arg)
+{
+	async_peer_t *peer = (async_peer_t *)arg;
+	char buf[ASYNC_MSG_LEN] = {};
+	unsigned int i = 0;
+
+	for (i = 0; i < ASYNC_ROUNDS; i++) {
+		size_t got = 0;
+		if (write(peer->fd, ASYNC_MSG, ASYNC_MSG_LEN) != ASYNC_MSG_LEN)
+			break;
+		while (got < ASYNC_MSG_LEN) {
+			ssize_t r = read(peer->fd, buf + got, ASYNC_MSG_LEN - got);
+			if (r <= 0)
+				break;
+			got += r;
+		}
+		if ((got != ASYNC_MSG_LEN) ||
+			(memcmp(buf, ASYNC_MSG, ASYNC_MSG_LEN) != 0))
+			break;
+		peer->rounds++;
+	}
+	shutdown(peer->fd, SHUT_WR);
+
+	return NULL;
+}
+
+
+static bool_t async_echo_cb(faux_async_t *async, faux_buf_t *buf, size_t len,
+	void *user_data)
+{
+	async_test_t *t = (async_test_t *)user_data;
+	char data[ASYNC_MSG_LEN * 8] = {};
+	ssize_t r = 0;
+
+	if (len > sizeof(data))
+		len = sizeof(data);
+	r = faux_buf_read(buf, data, len);
+	if (r <= 0)
+		return BOOL_FALSE;
+	faux_async_write(async, data, r);
+	t->echoed += r;
+
+	return BOOL_TRUE;
+}
+
+
+static bool_t async_fd_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	void *associated_data, void *user_data)
+{
+	async_test_t *t = (async_test_t *)user_data;
+	faux_eloop_info_fd_t *info = (faux_eloop_info_fd_t *)associated_data;
+
+	if ((info->revents & POLLIN) && (faux_async_in(t->async) > 0))
+		return BOOL_TRUE;
+	// EOF or error
+	t->eof = BOOL_TRUE;
+
+	eloop = eloop; // Happy compiler
+	type = type; // Happy compiler
+
+	return BOOL_FALSE;
+}
+
+
+// Gets number of read and write syscalls made by current thread
+static long long async_syscalls(void)
+{
+	FILE *f = NULL;
+	char line[128] = {};
+	long long num = 0;
+	long long val = 0;
+
+	f = fopen("/proc/thread-self/io", "r");
+	if (!f)
+		return -1;
+	while (fgets(line, sizeof(line), f)) {
+		if ((sscanf(line, "syscr: %lld", &val) == 1) ||
+			(sscanf(line, "syscw: %lld", &val) == 1))
+			num += val;
+	}
+	fclose(f);
+
+	return num;
+}
+
+
+// Echoes peer's messages. Returns number of read/write syscalls or -1
+static long long async_echo(faux_eloop_backend_e backend)
+{
+	faux_eloop_t *eloop = NULL;
+	async_test_t t = {};
+	async_peer_t peer = {};
+	pthread_t thread;
+	int sv[2] = {-1, -1};
+	long long before = 0;
+	long long after = 0;
+	bool_t ok = BOOL_FALSE;
+
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0)
+		return -1;
+	eloop = faux_eloop_new(NULL);
+	if (!faux_eloop_set_backend(eloop, backend))
+		goto err;
+	t.async = faux_async_new(sv[0]);
+	faux_async_set_read_cb(t.async, async_echo_cb, &t);
+	if (!faux_eloop_add_async(eloop, t.async, async_fd_cb, &t))
+		goto err;
+
+	peer.fd = sv[1];
+	before = async_syscalls();
+	pthread_create(&thread, NULL, async_peer, &peer);
+	faux_eloop_loop(eloop);
+	after = async_syscalls();
+	pthread_join(thread, NULL);
+
+	if (!t.eof || (peer.rounds != ASYNC_ROUNDS) ||
+		(t.echoed != ASYNC_ROUNDS * ASYNC_MSG_LEN)) {
+		fprintf(stderr, "Backend %d: rounds %u, echoed %zu\n",
+			backend, peer.rounds, t.echoed);
+		goto err;
+	}
+	ok = BOOL_TRUE;
+
+err:
+	if (t.async)
+		faux_eloop_del_fd(eloop, sv[0]);
+	faux_eloop_free(eloop);
+	faux_async_free(t.async);
+	close(sv[0]);
+	close(sv[1]);
+
+	if (!ok || (before < 0) || (after < 0))
+		return -1;
+
+	return after - before;
+}
+
+
+int testc_faux_eloop_uring_async(void)
+{
+	faux_eloop_t *eloop = faux_eloop_new(NULL);
+	bool_t supported = faux_eloop_set_backend(eloop,
+		FAUX_ELOOP_BACKEND_URING);
+	long long poll_syscalls = 0;
+	long long uring_syscalls = 0;
+
+	faux_eloop_free(eloop);
+	if (!supported) {
+		printf("The io_uring backend is not supported. Skipped\n");
+		return 0;
+	}
+	if (async_syscalls() < 0) {
+		printf("The /proc/thread-self/io is not available. Skipped\n");
+		return 0;
+	}
+
+	poll_syscalls = async_echo(FAUX_ELOOP_BACKEND_POLL);
+	if (poll_syscalls < 0) {
+		fprintf(stderr, "Echo with poll() backend failed\n");
+		return -1;
+	}
+	uring_syscalls = async_echo(FAUX_ELOOP_BACKEND_URING);
+	if (uring_syscalls < 0) {
+		fprintf(stderr, "Echo with io_uring backend failed\n");
+		return -1;
+	}
+
+	// The poll() backend reads and writes each message by syscalls
+	fprintf(stderr, "Read/write syscalls for %u echoes: "
+		"poll() %lld, io_uring %lld\n",
+		ASYNC_ROUNDS, poll_syscalls, uring_syscalls);
+	if (poll_syscalls < ASYNC_ROUNDS * 2) {
+		fprintf(stderr, "Too few syscalls for poll() backend\n");
+		return -1;
+	}
+	if (uring_syscalls > ASYNC_ROUNDS / 10) {
+		fprintf(stderr, "Too many syscalls for io_uring backend\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+
+static bool_t async_stop_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	void *associated_data, void *user_data)
+{
+	eloop = eloop; // Happy compiler
+	type = type; // Happy compiler
+	associated_data = associated_data; // Happy compiler
+	user_data = user_data; // Happy compiler
+
+	return BOOL_FALSE;
+}
+
+
+// Runs loop for a while
+static void async_run(faux_eloop_t *eloop)
+{
+	struct timespec interval = {0, 50000000l}; // 50ms
+
+	faux_eloop_add_sched_once_delayed(eloop, &interval, 1,
+		async_stop_cb, NULL);
+	faux_eloop_loop(eloop);
+}
+
+
+int testc_faux_eloop_uring_async_del(void)
+{
+	faux_eloop_t *eloop = NULL;
+	faux_async_t *async = NULL;
+	async_test_t t = {};
+	int sv[2] = {-1, -1};
+	struct pollfd pfd = {};
+	struct timespec start = {};
+	struct timespec now = {};
+	struct timespec diff = {};
+	char c = 0;
+	int ret = -1;
+
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0)
+		return -1;
+	eloop = faux_eloop_new(NULL);
+	if (!faux_eloop_set_backend(eloop, FAUX_ELOOP_BACKEND_URING)) {
+		printf("The io_uring backend is not supported. Skipped\n");
+		ret = 0;
+		goto err;
+	}
+	async = faux_async_new(sv[0]);
+	t.async = async;
+	faux_async_set_read_cb(async, async_echo_cb, &t);
+	if (!faux_eloop_add_async(eloop, async, async_fd_cb, &t))
+		goto err;
+
+	// Read request waits for data within kernel
+	async_run(eloop);
+	if (t.eof) {
+		fprintf(stderr, "Unexpected EOF\n");
+		goto err;
+	}
+
+	// Idle fd is deleted and closed. Kernel must not hold the file.
+	faux_eloop_del_fd(eloop, sv[0]);
+	async_run(eloop);
+	close(sv[0]);
+	sv[0] = -1;
+	pfd.fd = sv[1];
+	pfd.events = POLLIN;
+	if ((poll(&pfd, 1, 1000) != 1) || (read(sv[1], &c, 1) != 0)) {
+		fprintf(stderr, "Peer doesn't see EOF\n");
+		goto err;
+	}
+
+	// Cancelled requests are completed so freeing doesn't wait
+	faux_timespec_now_monotonic(&start);
+	faux_eloop_free(eloop);
+	eloop = NULL;
+	faux_timespec_now_monotonic(&now);
+	faux_timespec_diff(&diff, &now, &start);
+	if (diff.tv_sec >= 1) {
+		fprintf(stderr, "Too long freeing of event loop\n");
+		goto err;
+	}
+
+	ret = 0;
+err:
+	faux_eloop_free(eloop);
+	faux_async_free(async);
+	if (sv[0] >= 0)
+		close(sv[0]);
+	close(sv[1]);
+
+	return ret;
+}
+
+
+static bool_t busy_fd_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	void *associated_data, void *user_data)
+{
+	eloop_test_t *t = (eloop_test_t *)user_data;
+
+	// Don't read data so fd is always ready
+	t->fd_events++;
+
+	eloop = eloop; // Happy compiler
+	type = type; // Happy compiler
+	associated_data = associated_data; // Happy compiler
+
+	return BOOL_TRUE;
+}
+
+
+static bool_t busy_sched_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	void *associated_data, void *user_data)
+{
+	eloop_test_t *t = (eloop_test_t *)user_data;
+
+	t->sched_events++;
+
+	eloop = eloop; // Happy compiler
+	type = type; // Happy compiler
+	associated_data = associated_data; // Happy compiler
+
+	// Stop the loop after third event
+	if (t->sched_events >= 3)
+		return BOOL_FALSE;
+
+	return BOOL_TRUE;
+}
+
+
+int testc_faux_eloop_busy_fd(void)
+{
+	faux_eloop_t *eloop = NULL;
+	eloop_test_t t = {};
+	struct timespec period = {0, 10000000l}; // 10ms
+	struct timespec max = {};
+	int ret = -1;
+
+	if (pipe(t.pipefd) < 0)
+		return -1;
+	if (write(t.pipefd[1], "x", 1) != 1)
+		goto err;
+
+	// Periodic events must be processed even if fd is always ready
+	eloop = faux_eloop_new(NULL);
+	faux_eloop_add_fd(eloop, t.pipefd[0], POLLIN, busy_fd_cb, &t);
+	faux_eloop_add_sched_periodic_delayed(eloop, 1, busy_sched_cb, &t,
+		&period, FAUX_SCHED_INFINITE);
+	faux_eloop_set_sched_limit(eloop, 1);
+	faux_eloop_loop(eloop);
+
+	if (t.sched_events != 3) {
+		fprintf(stderr, "Wrong number of sched events: %u\n",
+			t.sched_events);
+		goto err;
+	}
+	if (faux_eloop_sched_lateness(eloop, NULL, &max) != 3) {
+		fprintf(stderr, "Wrong number of popped events\n");
+		goto err;
+	}
+	printf("Max lateness: %ld.%09ld\n", (long)max.tv_sec, max.tv_nsec);
+
+	ret = 0;
+err:
+	faux_eloop_free(eloop);
+	close(t.pipefd[0]);
+	close(t.pipefd[1]);
+
+	return ret;
+}
+
+
+static bool_t stats_fd_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	void *associated_data, void *user_data)
+{
+	eloop_test_t *t = (eloop_test_t *)user_data;
+
+	t->fd_events++;
+	usleep(1000); // Slow callback
+
+	eloop = eloop; // Happy compiler
+	type = type; // Happy compiler
+	associated_data = associated_data; // Happy compiler
+
+	return BOOL_TRUE;
+}
+
+
+// Replaces own registration by new one with the same fd number
+static bool_t stats_reuse_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	void *associated_data, void *user_data)
+{
+	faux_eloop_info_fd_t *info = (faux_eloop_info_fd_t *)associated_data;
+
+	faux_eloop_del_fd(eloop, info->fd);
+	faux_eloop_add_fd(eloop, info->fd, POLLIN, stats_fd_cb, user_data);
+
+	type = type; // Happy compiler
+
+	return BOOL_FALSE;
+}
+
+
+int testc_faux_eloop_stats(void)
+{
+	faux_eloop_t *eloop = NULL;
+	eloop_test_t t = {};
+	struct timespec period = {0, 10000000l}; // 10ms
+	faux_eloop_stats_t stats = {};
+	faux_eloop_cb_stats_t fd_stats = {};
+	uint64_t hist_num = 0;
+	unsigned int i = 0;
+	int ret = -1;
+
+	if (pipe(t.pipefd) < 0)
+		return -1;
+	if (write(t.pipefd[1], "x", 1) != 1)
+		goto err;
+
+	eloop = faux_eloop_new(NULL);
+	if (faux_eloop_stats(eloop, &stats)) {
+		fprintf(stderr, "Statistics are enabled by default\n");
+		goto err;
+	}
+	faux_eloop_set_stats(eloop, BOOL_TRUE);
+	faux_eloop_add_fd(eloop, t.pipefd[0], POLLIN, stats_fd_cb, &t);
+	faux_eloop_add_sched_periodic_delayed(eloop, 1, busy_sched_cb, &t,
+		&period, FAUX_SCHED_INFINITE);
+	faux_eloop_loop(eloop);
+
+	if (!faux_eloop_stats(eloop, &stats)) {
+		fprintf(stderr, "Can't get statistics\n");
+		goto err;
+	}
+	if ((0 == stats.iterations) ||
+		(stats.types[FAUX_ELOOP_FD].num != t.fd_events) ||
+		(stats.types[FAUX_ELOOP_SCHED].num != 3) ||
+		(stats.sched_num != 3)) {
+		fprintf(stderr, "Wrong counters\n");
+		goto err;
+	}
+	if ((stats.slowest_type != FAUX_ELOOP_FD) ||
+		(stats.slowest_id != t.pipefd[0]) ||
+		(faux_timespec_to_nsec(&stats.slowest) < 1000000l) ||
+		(faux_timespec_to_nsec(&stats.cb_time) <
+		(uint64_t)t.fd_events * 1000000l)) {
+		fprintf(stderr, "Wrong slowest callback\n");
+		goto err;
+	}
+	if (!faux_eloop_fd_stats(eloop, t.pipefd[0], &fd_stats) ||
+		(fd_stats.num != t.fd_events)) {
+		fprintf(stderr, "Wrong fd statistics\n");
+		goto err;
+	}
+	// Durations >= 1ms are within bucket 10 and upper
+	for (i = 10; i < FAUX_ELOOP_STATS_HIST_NUM; i++)
+		hist_num += fd_stats.hist[i];
+	if (hist_num != fd_stats.num) {
+		fprintf(stderr, "Wrong histogram\n");
+		goto err;
+	}
+	faux_eloop_del_fd(eloop, t.pipefd[0]);
+	if (faux_eloop_fd_stats(eloop, t.pipefd[0], &fd_stats)) {
+		fprintf(stderr, "Statistics of removed fd\n");
+		goto err;
+	}
+
+	// Callback of old registration must not be accounted for new one
+	faux_eloop_del_sched_all(eloop);
+	faux_eloop_add_fd(eloop, t.pipefd[0], POLLIN, stats_reuse_cb, &t);
+	faux_eloop_loop(eloop);
+	if (!faux_eloop_fd_stats(eloop, t.pipefd[0], &fd_stats) ||
+		(fd_stats.num != 0)) {
+		fprintf(stderr, "Statistics of reused fd number\n");
+		goto err;
+	}
+
+	ret = 0;
+err:
+	faux_eloop_free(eloop);
+	close(t.pipefd[0]);
+	close(t.pipefd[1]);
+
+	return ret;
+}
+
+
+typedef struct {
+	unsigned int num;
+	struct timespec now[2];
+	struct timespec ev_time;
+} eloop_now_t;
+
+
+static bool_t now_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	void *associated_data, void *user_data)
+{
+	eloop_now_t *t = (eloop_now_t *)user_data;
+
+	if (type != FAUX_ELOOP_SCHED)
+		return BOOL_FALSE;
+	if (t->num >= 2)
+		return BOOL_FALSE;
+	faux_eloop_now(eloop, &t->now[t->num]);
+	t->num++;
+
+	associated_data = associated_data; // Happy compiler
+
+	// Stop the loop after second event
+	if (t->num >= 2)
+		return BOOL_FALSE;
+
+	return BOOL_TRUE;
+}
+
+
+int testc_faux_eloop_now(void)
+{
+	faux_eloop_t *eloop = NULL;
+	eloop_now_t t = {};
+	struct timespec time = {};
+	struct timespec before = {};
+	struct timespec after = {};
+	faux_ev_t *ev = NULL;
+	int ret = -1;
+
+	eloop = faux_eloop_new(NULL);
+	faux_eloop_now(eloop, &before);
+
+	// Absolute wall-clock time is converted to loop time
+	faux_timespec_now(&time);
+	ev = faux_eloop_add_sched_once(eloop, &time, 1, now_cb, &t);
+	t.ev_time = *faux_ev_time(ev);
+	faux_eloop_add_sched_once_delayed(eloop, NULL, 2, now_cb, &t);
+	faux_eloop_loop(eloop);
+	faux_eloop_now(eloop, &after);
+
+	if (t.num != 2) {
+		fprintf(stderr, "Wrong number of sched events: %u\n", t.num);
+		goto err;
+	}
+	// Both events are popped within the same iteration
+	if (faux_timespec_cmp(&t.now[0], &t.now[1]) != 0) {
+		fprintf(stderr, "Loop time is not cached\n");
+		goto err;
+	}
+	if ((faux_timespec_cmp(&before, &t.now[0]) > 0) ||
+		(faux_timespec_cmp(&t.now[0], &after) > 0) ||
+		(faux_timespec_cmp(&t.ev_time, &t.now[0]) > 0)) {
+		fprintf(stderr, "Wrong loop time\n");
+		goto err;
+	}
+	if (faux_eloop_set_coarse_time(eloop, BOOL_TRUE)) {
+		faux_eloop_now(eloop, &before);
+		printf("Coarse loop time: %ld.%09ld\n",
+			(long)before.tv_sec, before.tv_nsec);
+	}
+
+	ret = 0;
+err:
+	faux_eloop_free(eloop);
+
+	return ret;
+}
+
+
+typedef struct {
+	struct timespec target; // Wall-clock time of event
+	struct timespec fired; // Wall-clock time when event is popped
+} eloop_abs_time_t;
+
+
+static bool_t abs_time_fire_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	void *associated_data, void *user_data)
+{
+	eloop_abs_time_t *t = (eloop_abs_time_t *)user_data;
+
+	faux_timespec_now(&t->fired);
+
+	eloop = eloop; // Happy compiler
+	type = type; // Happy compiler
+	associated_data = associated_data; // Happy compiler
+
+	return BOOL_FALSE;
+}
+
+
+static bool_t abs_time_add_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	void *associated_data, void *user_data)
+{
+	eloop_abs_time_t *t = (eloop_abs_time_t *)user_data;
+	struct timespec busy = {0, 200000000l}; // 200ms
+	struct timespec delay = {0, 100000000l}; // 100ms
+	struct timespec now = {};
+
+	// Cached loop time becomes older than real time
+	nanosleep(&busy, NULL);
+	faux_timespec_now(&now);
+	faux_timespec_sum(&t->target, &now, &delay);
+	if (!faux_eloop_add_sched_once(eloop, &t->target, 2,
+		abs_time_fire_cb, t))
+		return BOOL_FALSE;
+
+	type = type; // Happy compiler
+	associated_data = associated_data; // Happy compiler
+
+	return BOOL_TRUE;
+}
+
+
+int testc_faux_eloop_abs_time(void)
+{
+	faux_eloop_t *eloop = NULL;
+	eloop_abs_time_t t = {};
+	int ret = -1;
+
+	eloop = faux_eloop_new(NULL);
+	faux_eloop_add_sched_once_delayed(eloop, NULL, 1, abs_time_add_cb, &t);
+	faux_eloop_loop(eloop);
+
+	// Event added by callback is not popped before absolute time
+	if (faux_timespec_cmp(&t.fired, &t.target) < 0) {
+		fprintf(stderr, "Early event: target %ld.%09ld, fired %ld.%09ld\n",
+			(long)t.target.tv_sec, t.target.tv_nsec,
+			(long)t.fired.tv_sec, t.fired.tv_nsec);
+		goto err;
+	}
+
+	ret = 0;
+err:
+	faux_eloop_free(eloop);
+
+	return ret;
+}
+
+
+#define GROUP_LOOPS 3
+#define GROUP_CONNS 6
+
+typedef struct {
+	faux_eloop_group_t *group;
+	unsigned int calls[GROUP_LOOPS];
+	unsigned int conns[GROUP_LOOPS];
+} eloop_group_test_t;
+
+
+static unsigned int group_index(eloop_group_test_t *t, faux_eloop_t *eloop)
+{
+	unsigned int i = 0;
+
+	for (i = 0; i < GROUP_LOOPS; i++) {
+		if (faux_eloop_group_eloop(t->group, i) == eloop)
+			break;
+	}
+
+	return i;
+}
+
+
+static bool_t group_call_fn(faux_eloop_t *eloop, void *arg)
+{
+	eloop_group_test_t *t = (eloop_group_test_t *)arg;
+	unsigned int i = group_index(t, eloop);
+
+	if (i < GROUP_LOOPS)
+		t->calls[i]++;
+
+	return BOOL_TRUE;
+}
+
+
+static bool_t group_accept_cb(faux_eloop_t *eloop, int fd, void *user_data)
+{
+	eloop_group_test_t *t = (eloop_group_test_t *)user_data;
+	unsigned int i = group_index(t, eloop);
+
+	if (i < GROUP_LOOPS)
+		t->conns[i]++;
+	// Client waits for data so it's synchronization point
+	if (write(fd, "x", 1) != 1) {
+		close(fd);
+		return BOOL_FALSE;
+	}
+	close(fd);
+
+	return BOOL_TRUE;
+}
+
+
+static int group_connect(const struct sockaddr_in *addr)
+{
+	unsigned int i = 0;
+	char c = 0;
+
+	for (i = 0; i < GROUP_CONNS; i++) {
+		int fd = socket(AF_INET, SOCK_STREAM, 0);
+		if (fd < 0)
+			return -1;
+		if ((connect(fd, (const struct sockaddr *)addr,
+			sizeof(*addr)) < 0) || (read(fd, &c, 1) != 1)) {
+			close(fd);
+			return -1;
+		}
+		close(fd);
+	}
+
+	return 0;
+}
+
+
+int testc_faux_eloop_group(void)
+{
+	eloop_group_test_t t = {};
+	struct sockaddr_in addr = {};
+	socklen_t addrlen = sizeof(addr);
+	unsigned int i = 0;
+	unsigned int total = 0;
+	int lfd = -1;
+	int ret = -1;
+
+	t.group = faux_eloop_group_new(GROUP_LOOPS);
+	if (!t.group)
+		return -1;
+	if (faux_eloop_group_len(t.group) != GROUP_LOOPS)
+		goto err;
+
+	// Round-robin listener
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	lfd = socket(AF_INET, SOCK_STREAM, 0);
+	if ((lfd < 0) ||
+		(bind(lfd, (struct sockaddr *)&addr, sizeof(addr)) < 0) ||
+		(listen(lfd, 16) < 0) ||
+		(getsockname(lfd, (struct sockaddr *)&addr, &addrlen) < 0))
+		goto err;
+	if (!faux_eloop_group_add_listener(t.group, lfd, group_accept_cb, &t))
+		goto err;
+
+	// The call queued before start is executed after start
+	if (!faux_eloop_group_call(t.group, 1, group_call_fn, &t))
+		goto err;
+	if (!faux_eloop_group_start(t.group))
+		goto err;
+	for (i = 0; i < GROUP_LOOPS; i++)
+		faux_eloop_group_call(t.group, i, group_call_fn, &t);
+	if (group_connect(&addr) < 0) {
+		fprintf(stderr, "Can't connect to round-robin listener\n");
+		goto err;
+	}
+	if (!faux_eloop_group_stop(t.group))
+		goto err;
+
+	for (i = 0; i < GROUP_LOOPS; i++) {
+		if (t.calls[i] != ((1 == i) ? 2 : 1)) {
+			fprintf(stderr, "Wrong number of calls for loop %u\n", i);
+			goto err;
+		}
+		if (t.conns[i] != (GROUP_CONNS / GROUP_LOOPS)) {
+			fprintf(stderr, "Wrong number of conns for loop %u\n", i);
+			goto err;
+		}
+	}
+	faux_eloop_group_free(t.group);
+	t.group = NULL;
+
+	// SO_REUSEPORT listeners. Find out free port.
+	close(lfd);
+	lfd = socket(AF_INET, SOCK_STREAM, 0);
+	addr.sin_port = 0;
+	if ((lfd < 0) ||
+		(bind(lfd, (struct sockaddr *)&addr, sizeof(addr)) < 0) ||
+		(getsockname(lfd, (struct sockaddr *)&addr, &addrlen) < 0))
+		goto err;
+	close(lfd);
+	lfd = -1;
+	memset(&t, 0, sizeof(t));
+	t.group = faux_eloop_group_new(GROUP_LOOPS);
+	if (!faux_eloop_group_listen(t.group, (struct sockaddr *)&addr,
+		sizeof(addr), group_accept_cb, &t)) {
+		printf("SO_REUSEPORT is not supported. Skipped\n");
+		ret = 0;
+		goto err;
+	}
+	if (!faux_eloop_group_start(t.group))
+		goto err;
+	if (group_connect(&addr) < 0) {
+		fprintf(stderr, "Can't connect to SO_REUSEPORT listeners\n");
+		goto err;
+	}
+	faux_eloop_group_stop(t.group);
+	for (i = 0; i < GROUP_LOOPS; i++)
+		total += t.conns[i];
+	if (total != GROUP_CONNS) {
+		fprintf(stderr, "Wrong number of conns: %u\n", total);
+		goto err;
+	}
+
+	ret = 0;
+
+err:
+	faux_eloop_group_free(t.group);
+	if (lfd >= 0)
+		close(lfd);
+
+	return ret;
+}
+
+
+#define POST_THREADS 4
+#define POST_TASKS 10000
+#define POST_FDS_MAX 64
+
+typedef struct {
+	faux_eloop_t *eloop;
+	unsigned int tasks;
+	unsigned int done;
+} eloop_post_test_t;
+
+
+static bool_t post_task_fn(faux_eloop_t *eloop, void *arg)
+{
+	eloop_post_test_t *t = (eloop_post_test_t *)arg;
+
+	t->tasks++;
+
+	eloop = eloop; // Happy compiler
+
+	return BOOL_TRUE;
+}
+
+
+static bool_t post_done_fn(faux_eloop_t *eloop, void *arg)
+{
+	eloop_post_test_t *t = (eloop_post_test_t *)arg;
+
+	t->done++;
+
+	eloop = eloop; // Happy compiler
+
+	// Stop the loop when all producers are done
+	if (t->done >= POST_THREADS)
+		return BOOL_FALSE;
+
+	return BOOL_TRUE;
+}
+
+
+static void *post_thread(void *arg)
+{
+	eloop_post_test_t *t = (eloop_post_test_t *)arg;
+	unsigned int i = 0;
+
+	for (i = 0; i < POST_TASKS; i++)
+		faux_eloop_post(t->eloop, post_task_fn, t);
+	faux_eloop_post(t->eloop, post_done_fn, t);
+
+	return NULL;
+}
+
+
+int testc_faux_eloop_post(void)
+{
+	eloop_post_test_t t = {};
+	pthread_t threads[POST_THREADS];
+	unsigned int i = 0;
+	int ret = -1;
+
+	t.eloop = faux_eloop_new(NULL);
+	// The task posted before loop start is executed after start
+	faux_eloop_post(t.eloop, post_task_fn, &t);
+	for (i = 0; i < POST_THREADS; i++)
+		pthread_create(&threads[i], NULL, post_thread, &t);
+	faux_eloop_loop(t.eloop);
+	for (i = 0; i < POST_THREADS; i++)
+		pthread_join(threads[i], NULL);
+
+	if (t.tasks != (POST_THREADS * POST_TASKS + 1)) {
+		fprintf(stderr, "Wrong number of tasks: %u\n", t.tasks);
+		goto err;
+	}
+	// Not executed task is dropped
+	faux_eloop_post(t.eloop, post_task_fn, &t);
+
+	// The loop can't be created without descriptor for wakeups
+	{
+		struct rlimit rl = {};
+		struct rlimit low = {};
+		int fds[POST_FDS_MAX];
+		unsigned int fds_num = 0;
+		faux_eloop_t *eloop = NULL;
+
+		getrlimit(RLIMIT_NOFILE, &rl);
+		low = rl;
+		low.rlim_cur = POST_FDS_MAX;
+		setrlimit(RLIMIT_NOFILE, &low);
+		while ((fds_num < POST_FDS_MAX) &&
+			((fds[fds_num] = dup(STDERR_FILENO)) >= 0))
+			fds_num++;
+		eloop = faux_eloop_new(NULL);
+		for (i = 0; i < fds_num; i++)
+			close(fds[i]);
+		setrlimit(RLIMIT_NOFILE, &rl);
+		if (eloop) {
+			fprintf(stderr, "Loop is created without free fds\n");
+			faux_eloop_free(eloop);
+			goto err;
+		}
+	}
+
+	ret = 0;
+err:
+	faux_eloop_free(t.eloop);
+
+	return ret;
+}
+
+
+
+#define DEFER_BYTES 3
+#define DEFER_CALLS 100
+
+typedef struct {
+	int pipefd[2];
+	unsigned int reads;
+	unsigned int flushes;
+	unsigned int calls;
+	bool_t flush_pending;
+	bool_t error;
+	bool_t idle_done;
+} eloop_defer_test_t;
+
+
+static bool_t defer_flush_fn(faux_eloop_t *eloop, void *arg)
+{
+	eloop_defer_test_t *t = (eloop_defer_test_t *)arg;
+
+	t->flushes++;
+	t->flush_pending = BOOL_FALSE;
+
+	eloop = eloop; // Happy compiler
+
+	return BOOL_TRUE;
+}
+
+
+static bool_t defer_count_fn(faux_eloop_t *eloop, void *arg)
+{
+	eloop_defer_test_t *t = (eloop_defer_test_t *)arg;
+
+	t->calls++;
+
+	eloop = eloop; // Happy compiler
+
+	return BOOL_TRUE;
+}
+
+
+static bool_t defer_idle_fn(faux_eloop_t *eloop, void *arg)
+{
+	eloop_defer_test_t *t = (eloop_defer_test_t *)arg;
+
+	// Idle call must wait for all fd data and deferred calls
+	if ((t->reads != DEFER_BYTES) || t->flush_pending ||
+		(t->calls != DEFER_CALLS))
+		t->error = BOOL_TRUE;
+	t->idle_done = BOOL_TRUE;
+
+	eloop = eloop; // Happy compiler
+
+	return BOOL_FALSE;
+}
+
+
+static bool_t defer_fd_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	void *associated_data, void *user_data)
+{
+	eloop_defer_test_t *t = (eloop_defer_test_t *)user_data;
+	unsigned int i = 0;
+	char c = 0;
+
+	// Deferred call of previous iteration must be executed already
+	if (t->flush_pending)
+		t->error = BOOL_TRUE;
+	if (read(t->pipefd[0], &c, 1) != 1)
+		return BOOL_FALSE;
+	t->reads++;
+	t->flush_pending = BOOL_TRUE;
+	faux_eloop_defer(eloop, defer_flush_fn, t);
+	if (1 == t->reads) {
+		for (i = 0; i < DEFER_CALLS; i++)
+			faux_eloop_defer(eloop, defer_count_fn, t);
+	}
+	if (t->reads == DEFER_BYTES)
+		faux_eloop_del_fd(eloop, t->pipefd[0]);
+
+	type = type; // Happy compiler
+	associated_data = associated_data; // Happy compiler
+
+	return BOOL_TRUE;
+}
+
+
+int testc_faux_eloop_defer(void)
+{
+	faux_eloop_t *eloop = NULL;
+	eloop_defer_test_t t = {};
+	int ret = -1;
+
+	if (pipe(t.pipefd) < 0)
+		return -1;
+	if (write(t.pipefd[1], "xxx", DEFER_BYTES) != DEFER_BYTES)
+		goto err;
+
+	eloop = faux_eloop_new(NULL);
+	faux_eloop_add_fd(eloop, t.pipefd[0], POLLIN, defer_fd_cb, &t);
+	faux_eloop_defer_idle(eloop, defer_idle_fn, &t);
+	faux_eloop_loop(eloop);
+
+	if (!t.idle_done || t.error) {
+		fprintf(stderr, "Wrong order of deferred calls\n");
+		goto err;
+	}
+	if (t.flushes != DEFER_BYTES) {
+		fprintf(stderr, "Wrong number of flushes: %u\n", t.flushes);
+		goto err;
+	}
+	// Not executed call is dropped
+	faux_eloop_defer(eloop, defer_count_fn, &t);
+
+	ret = 0;
+err:
+	faux_eloop_free(eloop);
+	close(t.pipefd[0]);
+	close(t.pipefd[1]);
+
+	return ret;
+}
+
+
+#define BUSY_BYTES 50
+
+typedef struct {
+	int pipefd[2];
+	unsigned int reads;
+} eloop_busy_test_t;
+
+
+static void *busy_thread(void *arg)
+{
+	eloop_busy_test_t *t = (eloop_busy_test_t *)arg;
+	unsigned int i = 0;
+
+	for (i = 0; i < BUSY_BYTES; i++) {
+		usleep(100);
+		if (write(t->pipefd[1], "x", 1) != 1)
+			break;
+	}
+
+	return NULL;
+}
+
+
+static bool_t busy_poll_fd_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	void *associated_data, void *user_data)
+{
+	eloop_busy_test_t *t = (eloop_busy_test_t *)user_data;
+	char buf[BUSY_BYTES] = {};
+	ssize_t r = 0;
+
+	r = read(t->pipefd[0], buf, sizeof(buf));
+	if (r <= 0)
+		return BOOL_FALSE;
+	t->reads += r;
+
+	eloop = eloop; // Happy compiler
+	type = type; // Happy compiler
+	associated_data = associated_data; // Happy compiler
+
+	// Stop the loop when all data is received
+	if (t->reads >= BUSY_BYTES)
+		return BOOL_FALSE;
+
+	return BOOL_TRUE;
+}
+
+
+int testc_faux_eloop_busy_poll(void)
+{
+	faux_eloop_t *eloop = NULL;
+	eloop_busy_test_t t = {};
+	pthread_t thread;
+	struct timespec budget = {0, 10000000l}; // 10ms
+	faux_eloop_busy_stats_t stats = {};
+	int ret = -1;
+
+	if (pipe(t.pipefd) < 0)
+		return -1;
+
+	eloop = faux_eloop_new(NULL);
+	faux_eloop_set_busy_poll(eloop, &budget);
+	faux_eloop_add_fd(eloop, t.pipefd[0], POLLIN, busy_poll_fd_cb, &t);
+	pthread_create(&thread, NULL, busy_thread, &t);
+	faux_eloop_loop(eloop);
+	pthread_join(thread, NULL);
+
+	if (t.reads != BUSY_BYTES) {
+		fprintf(stderr, "Wrong number of bytes: %u\n", t.reads);
+		goto err;
+	}
+	faux_eloop_busy_stats(eloop, &stats);
+	printf("Busy poll hits: %llu, misses: %llu\n",
+		(unsigned long long)stats.hits,
+		(unsigned long long)stats.misses);
+	// Events are much more frequent than budget so spinning pays off
+	if ((0 == stats.hits) ||
+		(0 == faux_timespec_to_nsec(&stats.spin_time))) {
+		fprintf(stderr, "Spinning has not found events\n");
+		goto err;
+	}
+	if (faux_timespec_to_nsec(&stats.budget) > 10000000l) {
+		fprintf(stderr, "Budget exceeds limit\n");
+		goto err;
+	}
+
+	ret = 0;
+err:
+	faux_eloop_free(eloop);
+	close(t.pipefd[0]);
+	close(t.pipefd[1]);
+
+	return ret;
+}
+
+
+#define PRIO_FDS 3
+#define PRIO_REQUEUES 3
+
+typedef struct {
+	int pipefd[PRIO_FDS][2];
+	int order[PRIO_FDS]; // Indexes of pipes in dispatch order
+	unsigned int dispatched;
+	int idle_pipefd[2];
+	unsigned int requeues;
+	bool_t timeout;
+} eloop_prio_test_t;
+
+
+static bool_t prio_fd_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	void *associated_data, void *user_data)
+{
+	eloop_prio_test_t *t = (eloop_prio_test_t *)user_data;
+	faux_eloop_info_fd_t *info = (faux_eloop_info_fd_t *)associated_data;
+	unsigned int i = 0;
+	char c = 0;
+
+	for (i = 0; i < PRIO_FDS; i++) {
+		if (t->pipefd[i][0] == info->fd)
+			break;
+	}
+	if ((i == PRIO_FDS) || (read(info->fd, &c, 1) != 1))
+		return BOOL_FALSE;
+	if (t->dispatched < PRIO_FDS)
+		t->order[t->dispatched] = i;
+	t->dispatched++;
+
+	eloop = eloop; // Happy compiler
+	type = type; // Happy compiler
+
+	return BOOL_TRUE;
+}
+
+
+static bool_t prio_requeue_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	void *associated_data, void *user_data)
+{
+	eloop_prio_test_t *t = (eloop_prio_test_t *)user_data;
+	faux_eloop_info_fd_t *info = (faux_eloop_info_fd_t *)associated_data;
+
+	// The fd is never ready. It's dispatched due to requeue only.
+	t->requeues++;
+	if (t->requeues >= PRIO_REQUEUES)
+		return BOOL_FALSE;
+	faux_eloop_requeue_fd(eloop, info->fd);
+
+	type = type; // Happy compiler
+
+	return BOOL_TRUE;
+}
+
+
+static bool_t prio_timeout_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	void *associated_data, void *user_data)
+{
+	eloop_prio_test_t *t = (eloop_prio_test_t *)user_data;
+
+	t->timeout = BOOL_TRUE;
+
+	eloop = eloop; // Happy compiler
+	type = type; // Happy compiler
+	associated_data = associated_data; // Happy compiler
+
+	return BOOL_FALSE;
+}
+
+
+int testc_faux_eloop_prio(void)
+{
+	faux_eloop_t *eloop = NULL;
+	eloop_prio_test_t t = {};
+	faux_eloop_prio_e prio[PRIO_FDS] = {FAUX_ELOOP_PRIO_LOW,
+		FAUX_ELOOP_PRIO_NORMAL, FAUX_ELOOP_PRIO_HIGH};
+	struct timespec interval = {5, 0};
+	unsigned int i = 0;
+	int ret = -1;
+
+	for (i = 0; i < PRIO_FDS; i++) {
+		t.pipefd[i][0] = -1;
+		t.pipefd[i][1] = -1;
+	}
+	t.idle_pipefd[0] = -1;
+	t.idle_pipefd[1] = -1;
+
+	eloop = faux_eloop_new(NULL);
+	// Low priority fd is registered first but high one is dispatched first
+	for (i = 0; i < PRIO_FDS; i++) {
+		if (pipe(t.pipefd[i]) < 0)
+			goto err;
+		if (write(t.pipefd[i][1], "x", 1) != 1)
+			goto err;
+		faux_eloop_add_fd(eloop, t.pipefd[i][0], POLLIN,
+			prio_fd_cb, &t);
+		faux_eloop_set_fd_prio(eloop, t.pipefd[i][0], prio[i]);
+	}
+	// Requeued fd is dispatched without readiness
+	if (pipe(t.idle_pipefd) < 0)
+		goto err;
+	faux_eloop_add_fd(eloop, t.idle_pipefd[0], POLLIN,
+		prio_requeue_cb, &t);
+	faux_eloop_requeue_fd(eloop, t.idle_pipefd[0]);
+	faux_eloop_add_sched_once_delayed(eloop, &interval, 1,
+		prio_timeout_cb, &t);
+	faux_eloop_loop(eloop);
+
+	if (t.timeout || (t.requeues != PRIO_REQUEUES)) {
+		fprintf(stderr, "Wrong number of requeues: %u\n", t.requeues);
+		goto err;
+	}
+	if (t.dispatched != PRIO_FDS) {
+		fprintf(stderr, "Wrong number of dispatched fds: %u\n",
+			t.dispatched);
+		goto err;
+	}
+	if ((t.order[0] != 2) || (t.order[1] != 1) || (t.order[2] != 0)) {
+		fprintf(stderr, "Wrong dispatch order: %d %d %d\n",
+			t.order[0], t.order[1], t.order[2]);
+		goto err;
+	}
+
+	ret = 0;
+err:
+	faux_eloop_free(eloop);
+	for (i = 0; i < PRIO_FDS; i++) {
+		if (t.pipefd[i][0] >= 0)
+			close(t.pipefd[i][0]);
+		if (t.pipefd[i][1] >= 0)
+			close(t.pipefd[i][1]);
+	}
+	if (t.idle_pipefd[0] >= 0)
+		close(t.idle_pipefd[0]);
+	if (t.idle_pipefd[1] >= 0)
+		close(t.idle_pipefd[1]);
+
+	return ret;
+}
+
+
+static bool_t stop_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	void *associated_data, void *user_data)
+{
+	eloop = eloop; // Happy compiler
+	type = type; // Happy compiler
+	associated_data = associated_data; // Happy compiler
+	user_data = user_data; // Happy compiler
+
+	return BOOL_FALSE;
+}
+
+
+static bool_t prio_change_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	void *associated_data, void *user_data)
+{
+	unsigned int *dispatched = (unsigned int *)user_data;
+	faux_eloop_info_fd_t *info = (faux_eloop_info_fd_t *)associated_data;
+	char c = 0;
+
+	// Pipe has single byte. Don't block on the repeated dispatch.
+	if ((0 == *dispatched) && (read(info->fd, &c, 1) != 1))
+		return BOOL_FALSE;
+	(*dispatched)++;
+	// The fd goes to the class that is not dispatched yet within pass
+	faux_eloop_set_fd_prio(eloop, info->fd, FAUX_ELOOP_PRIO_LOW);
+
+	type = type; // Happy compiler
+
+	return BOOL_TRUE;
+}
+
+
+int testc_faux_eloop_prio_change(void)
+{
+	faux_eloop_t *eloop = NULL;
+	int pipefd[2] = {-1, -1};
+	struct timespec interval = {0, 100000000l}; // 100ms
+	unsigned int dispatched = 0;
+	int ret = -1;
+
+	if (pipe(pipefd) < 0)
+		return -1;
+	if (write(pipefd[1], "x", 1) != 1)
+		goto err;
+
+	eloop = faux_eloop_new(NULL);
+	faux_eloop_add_fd(eloop, pipefd[0], POLLIN, prio_change_cb,
+		&dispatched);
+	faux_eloop_set_fd_prio(eloop, pipefd[0], FAUX_ELOOP_PRIO_HIGH);
+	faux_eloop_add_sched_once_delayed(eloop, &interval, 1, stop_cb, NULL);
+	faux_eloop_loop(eloop);
+
+	if (dispatched != 1) {
+		fprintf(stderr, "Wrong number of dispatches: %u\n", dispatched);
+		goto err;
+	}
+
+	ret = 0;
+err:
+	faux_eloop_free(eloop);
+	close(pipefd[0]);
+	close(pipefd[1]);
+
+	return ret;
+}
+
+
+typedef struct {
+	int pipefd[2][2];
+	int new_pipefd[2];
+	unsigned int dispatched;
+	unsigned int reused;
+} eloop_reuse_test_t;
+
+
+static bool_t reuse_new_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	void *associated_data, void *user_data)
+{
+	eloop_reuse_test_t *t = (eloop_reuse_test_t *)user_data;
+
+	t->reused++;
+
+	eloop = eloop; // Happy compiler
+	type = type; // Happy compiler
+	associated_data = associated_data; // Happy compiler
+
+	return BOOL_TRUE;
+}
+
+
+static bool_t reuse_fd_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	void *associated_data, void *user_data)
+{
+	eloop_reuse_test_t *t = (eloop_reuse_test_t *)user_data;
+	faux_eloop_info_fd_t *info = (faux_eloop_info_fd_t *)associated_data;
+	int other = t->pipefd[0][0];
+	char c = 0;
+
+	if (info->fd == other)
+		other = t->pipefd[1][0];
+	t->dispatched++;
+	if (read(info->fd, &c, 1) != 1)
+		return BOOL_FALSE;
+
+	// Replace the other ready fd by idle pipe with the same fd number
+	faux_eloop_del_fd(eloop, other);
+	if (dup2(t->new_pipefd[0], other) < 0)
+		return BOOL_FALSE;
+	faux_eloop_add_fd(eloop, other, POLLIN, reuse_new_cb, t);
+
+	type = type; // Happy compiler
+
+	return BOOL_TRUE;
+}
+
+
+static int eloop_reuse_test(faux_eloop_backend_e backend)
+{
+	faux_eloop_t *eloop = NULL;
+	eloop_reuse_test_t t = {};
+	struct timespec interval = {0, 100000000l}; // 100ms
+	unsigned int i = 0;
+	int ret = -1;
+
+	for (i = 0; i < 2; i++) {
+		t.pipefd[i][0] = -1;
+		t.pipefd[i][1] = -1;
+	}
+	t.new_pipefd[0] = -1;
+	t.new_pipefd[1] = -1;
+
+	eloop = faux_eloop_new(NULL);
+	if (!faux_eloop_set_backend(eloop, backend)) {
+		ret = 0; // Not supported
+		goto err;
+	}
+	if (pipe(t.new_pipefd) < 0)
+		goto err;
+	// Both fds are ready within the same iteration
+	for (i = 0; i < 2; i++) {
+		if (pipe(t.pipefd[i]) < 0)
+			goto err;
+		if (write(t.pipefd[i][1], "x", 1) != 1)
+			goto err;
+		faux_eloop_add_fd(eloop, t.pipefd[i][0], POLLIN,
+			reuse_fd_cb, &t);
+	}
+	faux_eloop_add_sched_once_delayed(eloop, &interval, 1, stop_cb, NULL);
+	faux_eloop_loop(eloop);
+
+	// Stale events of removed fd are not passed to new registration
+	if ((t.dispatched != 1) || (t.reused != 0)) {
+		fprintf(stderr, "Backend %d: Wrong dispatches: %u, reused %u\n",
+			backend, t.dispatched, t.reused);
+		goto err;
+	}
+
+	ret = 0;
+err:
+	faux_eloop_free(eloop);
+	for (i = 0; i < 2; i++) {
+		if (t.pipefd[i][0] >= 0)
+			close(t.pipefd[i][0]);
+		if (t.pipefd[i][1] >= 0)
+			close(t.pipefd[i][1]);
+	}
+	if (t.new_pipefd[0] >= 0)
+		close(t.new_pipefd[0]);
+	if (t.new_pipefd[1] >= 0)
+		close(t.new_pipefd[1]);
+
+	return ret;
+}
+
+
+int testc_faux_eloop_reuse_fd(void)
+{
+	if (eloop_reuse_test(FAUX_ELOOP_BACKEND_POLL) < 0)
+		return -1;
+	if (eloop_reuse_test(FAUX_ELOOP_BACKEND_EPOLL) < 0)
+		return -1;
+	if (eloop_reuse_test(FAUX_ELOOP_BACKEND_URING) < 0)
+		return -1;
+
+	return 0;
+}
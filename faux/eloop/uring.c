@@ -0,0 +1,812 @@
+/** @file uring.c
+ * @brief The io_uring backend of event loop.
+ *
+ * The backend uses kernel io_uring interface directly without liburing.
+ * The file descriptors are watched by one-shot poll requests. The requests
+ * are not submitted immediately. They are placed to submission queue and
+ * submitted in a batch by the same io_uring_enter() call that waits for
+ * completions. So adding, changing and removing of watched fds doesn't cost
+ * additional syscalls and each loop iteration costs single syscall. The
+ * completed poll request is re-armed before the next wait if fd is still
+ * watched. So the semantics is level-triggered like poll() has.
+ *
+ * The user data of poll request contains fd and generation of fd's entry.
+ * The generation is changed on every unwatch. So the stale completions of
+ * removed or replaced requests are ignored.
+ *
+ * The fd of async object (see faux_eloop_add_async()) is not polled. It's
+ * served by IORING_OP_READ and IORING_OP_WRITE requests. The completed read
+ * request delivers data and the read data is fed to async object. The write
+ * request is queued by faux_async_out(). So neither readiness notification
+ * nor read()/write() syscalls are needed to transfer data. The user data of
+ * such request is a pointer to request object marked by the high bit. The
+ * request owns its buffer so it can outlive unregistered async object.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#ifdef HAVE_IO_URING
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/time_types.h>
+
+#include "faux/faux.h"
+#include "faux/buf.h"
+#include "faux/async.h"
+#include "faux/eloop.h"
+
+#include "private.h"
+
+// User data of requests whose completions must be ignored
+#define URING_UD_IGNORE UINT64_MAX
+
+// Mark of user data that points to read/write request object
+#define URING_UD_IO (1ull << 63)
+
+// Mark of user data of poll request linked before read/write request. The
+// request objects are aligned so the lowest bit of pointer is free.
+#define URING_UD_IO_POLL 1ull
+
+// Generation of fd's entry within user data of poll request
+#define URING_GEN_MASK 0x7fffffff
+
+// Max time to wait for cancelled requests while freeing io_uring object
+#define URING_CANCEL_TIMEOUT_SEC 1
+
+// Initial number of entries within fd table
+#define URING_FDS_MIN 64
+
+
+/** @brief Makes user data of poll request.
+ *
+ * @param [in] fd File descriptor.
+ * @param [in] gen Generation of fd's entry.
+ * @return User data.
+ */
+static uint64_t uring_ud(int fd, uint32_t gen)
+{
+	return ((uint64_t)(gen & URING_GEN_MASK) << 32) | (uint32_t)fd;
+}
+
+
+/** @brief Makes user data of read/write request.
+ *
+ * @param [in] io Request object.
+ * @return User data.
+ */
+static uint64_t uring_io_ud(faux_eloop_uring_io_t *io)
+{
+	return (uint64_t)(uintptr_t)io | URING_UD_IO;
+}
+
+
+/** @brief Makes user data of poll request linked before read/write request.
+ *
+ * The linked request is not issued until poll request is completed. So it
+ * can be cancelled by cancellation of poll request only.
+ *
+ * @param [in] io Request object.
+ * @return User data.
+ */
+static uint64_t uring_io_poll_ud(faux_eloop_uring_io_t *io)
+{
+	return uring_io_ud(io) | URING_UD_IO_POLL;
+}
+
+
+/** @brief Submits queued requests and optionally waits for completions.
+ *
+ * @param [in] uring The io_uring object.
+ * @param [in] min_complete Number of completions to wait for.
+ * @param [in] flags Flags for io_uring_enter().
+ * @param [in] arg Extended argument. Can be NULL.
+ * @return Number of submitted requests or < 0 on error.
+ */
+static int uring_enter(faux_eloop_uring_t *uring, unsigned int min_complete,
+	unsigned int flags, struct io_uring_getevents_arg *arg)
+{
+	unsigned int to_submit = *uring->sq_tail -
+		__atomic_load_n(uring->sq_head, __ATOMIC_ACQUIRE);
+
+	return (int)syscall(__NR_io_uring_enter, uring->fd, to_submit,
+		min_complete, flags, arg, arg ? sizeof(*arg) : 0);
+}
+
+
+/** @brief Places request to submission queue.
+ *
+ * The request is not submitted. If queue is full then the queued requests
+ * are submitted to free the space.
+ *
+ * @param [in] uring The io_uring object.
+ * @param [in] opcode Operation code.
+ * @param [in] fd File descriptor.
+ * @param [in] events Poll events for IORING_OP_POLL_ADD.
+ * @param [in] addr User data of request to remove for IORING_OP_POLL_REMOVE
+ * and IORING_OP_ASYNC_CANCEL or buffer for IORING_OP_READ, IORING_OP_WRITE.
+ * @param [in] len Length of buffer for IORING_OP_READ, IORING_OP_WRITE.
+ * @param [in] flags Request flags like IOSQE_IO_LINK.
+ * @param [in] user_data User data of new request.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+static bool_t uring_queue(faux_eloop_uring_t *uring, uint8_t opcode, int fd,
+	short events, uint64_t addr, unsigned int len, uint8_t flags,
+	uint64_t user_data)
+{
+	unsigned int tail = *uring->sq_tail;
+	unsigned int index = 0;
+	struct io_uring_sqe *sqe = NULL;
+
+	if ((tail - __atomic_load_n(uring->sq_head, __ATOMIC_ACQUIRE)) >=
+		uring->sq_entries) {
+		if (uring_enter(uring, 0, 0, NULL) < 0)
+			return BOOL_FALSE;
+		if ((tail - __atomic_load_n(uring->sq_head, __ATOMIC_ACQUIRE)) >=
+			uring->sq_entries)
+			return BOOL_FALSE;
+	}
+
+	index = tail & *uring->sq_mask;
+	sqe = &uring->sqes[index];
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = opcode;
+	sqe->flags = flags;
+	sqe->fd = fd;
+	sqe->addr = addr;
+	sqe->len = len;
+	if ((IORING_OP_READ == opcode) || (IORING_OP_WRITE == opcode))
+		sqe->off = (uint64_t)-1; // Current file position
+	else
+		sqe->poll32_events = (unsigned short)events;
+	sqe->user_data = user_data;
+	uring->sq_array[index] = index;
+	__atomic_store_n(uring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Places poll request for fd to submission queue.
+ *
+ * @param [in] uring The io_uring object.
+ * @param [in] fd File descriptor.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+static bool_t uring_arm(faux_eloop_uring_t *uring, int fd)
+{
+	faux_eloop_uring_fd_t *entry = &uring->fds[fd];
+
+	if (!uring_queue(uring, IORING_OP_POLL_ADD, fd, entry->events, 0, 0, 0,
+		uring_ud(fd, entry->gen)))
+		return BOOL_FALSE;
+	entry->armed = BOOL_TRUE;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Places read/write request to submission queue.
+ *
+ * The write request writes data not written yet. If poll is true then
+ * request is linked after poll request. So it's executed when fd is ready.
+ * It's used when the previous request can't be completed without blocking.
+ *
+ * @param [in] uring The io_uring object.
+ * @param [in] io Request object.
+ * @param [in] poll Wait for readiness before request.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+static bool_t uring_io_queue(faux_eloop_uring_t *uring,
+	faux_eloop_uring_io_t *io, bool_t poll)
+{
+	bool_t r = BOOL_FALSE;
+
+	if (poll) {
+		short events = (IORING_OP_READ == io->opcode) ? POLLIN : POLLOUT;
+		// Linked requests must be submitted by the same call
+		if ((*uring->sq_tail - __atomic_load_n(uring->sq_head,
+			__ATOMIC_ACQUIRE)) >= (uring->sq_entries - 1))
+			uring_enter(uring, 0, 0, NULL);
+		if (!uring_queue(uring, IORING_OP_POLL_ADD, io->fd, events,
+			0, 0, IOSQE_IO_LINK, uring_io_poll_ud(io)))
+			return BOOL_FALSE;
+	}
+	if (IORING_OP_READ == io->opcode)
+		r = uring_queue(uring, IORING_OP_READ, io->fd, 0,
+			(uint64_t)(uintptr_t)io->buf, sizeof(io->buf), 0,
+			uring_io_ud(io));
+	else
+		r = uring_queue(uring, IORING_OP_WRITE, io->fd, 0,
+			(uint64_t)(uintptr_t)(io->buf + io->off),
+			io->len - io->off, 0, uring_io_ud(io));
+	if (r)
+		uring->io_num++;
+
+	return r;
+}
+
+
+/** @brief Starts write request for output data of async object.
+ *
+ * Only one write request per fd is active. The next request is started
+ * when the previous one is completed.
+ *
+ * @param [in] uring The io_uring object.
+ * @param [in] fd File descriptor.
+ * @return Length of data taken from output buffer or < 0 on error.
+ */
+static ssize_t uring_write_next(faux_eloop_uring_t *uring, int fd)
+{
+	faux_eloop_uring_fd_t *entry = &uring->fds[fd];
+	faux_buf_t *obuf = NULL;
+	faux_eloop_uring_io_t *io = NULL;
+	ssize_t len = 0;
+
+	if (entry->wr) // Previous write is not completed yet
+		return 0;
+	obuf = faux_async_obuf(entry->async);
+	if (faux_buf_len(obuf) <= 0)
+		return 0;
+
+	io = faux_zmalloc(sizeof(*io));
+	if (!io)
+		return -1;
+	io->async = entry->async;
+	io->fd = fd;
+	io->opcode = IORING_OP_WRITE;
+	len = faux_buf_read(obuf, io->buf, sizeof(io->buf));
+	if (len <= 0) {
+		faux_free(io);
+		return -1;
+	}
+	io->len = len;
+	io->off = 0;
+	if (!uring_io_queue(uring, io, BOOL_FALSE)) {
+		faux_free(io);
+		return -1;
+	}
+	entry->wr = io;
+
+	return len;
+}
+
+
+/** @brief Processes completion of read/write request.
+ *
+ * The read data is fed to async object and request is queued again. The
+ * not completed write is continued. The request of unregistered async
+ * object is freed.
+ *
+ * @param [in] uring The io_uring object.
+ * @param [in] io Request object.
+ * @param [in] res Result of request.
+ * @return Events to report for fd or 0 if nothing to report.
+ */
+static short uring_io_complete(faux_eloop_uring_t *uring,
+	faux_eloop_uring_io_t *io, int res)
+{
+	faux_eloop_uring_fd_t *entry = NULL;
+
+	uring->io_num--;
+	if (!io->async) { // Async object is unregistered
+		faux_free(io);
+		return 0;
+	}
+	entry = &uring->fds[io->fd];
+
+	// Request can't be completed without blocking. Wait for readiness.
+	if ((-EAGAIN == res) || (-EINTR == res)) {
+		if (uring_io_queue(uring, io, BOOL_TRUE))
+			return 0;
+		res = -EIO;
+	}
+
+	if (IORING_OP_READ == io->opcode) {
+		short revents = POLLIN;
+		if (res > 0) {
+			if ((faux_async_feed(io->async, io->buf, res) >= 0) &&
+				uring_io_queue(uring, io, BOOL_FALSE))
+				return POLLIN;
+			revents |= POLLERR;
+		} else if (0 == res) {
+			revents |= POLLHUP;
+		} else {
+			faux_async_feed(io->async, NULL, res);
+			revents |= POLLERR;
+		}
+		entry->rd = NULL;
+		faux_free(io);
+		return revents;
+	}
+
+	// Write
+	if (res > 0) {
+		io->off += res;
+		if ((io->off < io->len) && uring_io_queue(uring, io, BOOL_FALSE))
+			return 0;
+		entry->wr = NULL;
+		if (io->off < io->len) {
+			faux_free(io);
+			return POLLERR;
+		}
+		faux_free(io);
+		if (uring_write_next(uring, entry - uring->fds) < 0)
+			return POLLERR;
+		return 0;
+	}
+	entry->wr = NULL;
+	faux_free(io);
+
+	return POLLERR;
+}
+
+
+/** @brief Grows fd table to fit specified fd.
+ *
+ * @param [in] uring The io_uring object.
+ * @param [in] fd File descriptor.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+static bool_t uring_fds_grow(faux_eloop_uring_t *uring, int fd)
+{
+	size_t new_size = uring->fds_size;
+	faux_eloop_uring_fd_t *new_fds = NULL;
+
+	if ((size_t)fd < uring->fds_size)
+		return BOOL_TRUE;
+
+	if (0 == new_size)
+		new_size = URING_FDS_MIN;
+	while (new_size <= (size_t)fd)
+		new_size *= 2;
+	new_fds = realloc(uring->fds, new_size * sizeof(*new_fds));
+	if (!new_fds)
+		return BOOL_FALSE;
+	memset(new_fds + uring->fds_size, 0,
+		(new_size - uring->fds_size) * sizeof(*new_fds));
+	uring->fds = new_fds;
+	uring->fds_size = new_size;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Creates io_uring object.
+ *
+ * @return Allocated object or NULL on error or if io_uring is unsupported.
+ */
+faux_eloop_uring_t *faux_eloop_uring_new(void)
+{
+	faux_eloop_uring_t *uring = NULL;
+	struct io_uring_params params = {};
+
+	uring = faux_zmalloc(sizeof(*uring));
+	if (!uring)
+		return NULL;
+
+	// Init
+	uring->sq_ptr = MAP_FAILED;
+	uring->cq_ptr = MAP_FAILED;
+	uring->sqes = MAP_FAILED;
+	uring->fds = NULL;
+	uring->fds_size = 0;
+	uring->ready_num = 0;
+
+	uring->fd = (int)syscall(__NR_io_uring_setup, URING_ENTRIES, &params);
+	if (uring->fd < 0) {
+		faux_free(uring);
+		return NULL;
+	}
+	// Timeout and signal mask for wait are required
+	if (!(params.features & IORING_FEAT_EXT_ARG)) {
+		faux_eloop_uring_free(uring);
+		return NULL;
+	}
+
+	uring->sq_size = params.sq_off.array +
+		params.sq_entries * sizeof(unsigned int);
+	uring->cq_size = params.cq_off.cqes +
+		params.cq_entries * sizeof(struct io_uring_cqe);
+	if (params.features & IORING_FEAT_SINGLE_MMAP) {
+		if (uring->cq_size > uring->sq_size)
+			uring->sq_size = uring->cq_size;
+		uring->cq_size = uring->sq_size;
+	}
+	uring->sq_ptr = mmap(NULL, uring->sq_size, PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_SQ_RING);
+	if (MAP_FAILED == uring->sq_ptr) {
+		faux_eloop_uring_free(uring);
+		return NULL;
+	}
+	if (params.features & IORING_FEAT_SINGLE_MMAP) {
+		uring->cq_ptr = uring->sq_ptr;
+	} else {
+		uring->cq_ptr = mmap(NULL, uring->cq_size,
+			PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+			uring->fd, IORING_OFF_CQ_RING);
+		if (MAP_FAILED == uring->cq_ptr) {
+			faux_eloop_uring_free(uring);
+			return NULL;
+		}
+	}
+	uring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+	uring->sqes = mmap(NULL, uring->sqes_size, PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_SQES);
+	if (MAP_FAILED == uring->sqes) {
+		faux_eloop_uring_free(uring);
+		return NULL;
+	}
+
+	uring->sq_head = (unsigned int *)((char *)uring->sq_ptr +
+		params.sq_off.head);
+	uring->sq_tail = (unsigned int *)((char *)uring->sq_ptr +
+		params.sq_off.tail);
+	uring->sq_mask = (unsigned int *)((char *)uring->sq_ptr +
+		params.sq_off.ring_mask);
+	uring->sq_array = (unsigned int *)((char *)uring->sq_ptr +
+		params.sq_off.array);
+	uring->sq_entries = params.sq_entries;
+	uring->cq_head = (unsigned int *)((char *)uring->cq_ptr +
+		params.cq_off.head);
+	uring->cq_tail = (unsigned int *)((char *)uring->cq_ptr +
+		params.cq_off.tail);
+	uring->cq_mask = (unsigned int *)((char *)uring->cq_ptr +
+		params.cq_off.ring_mask);
+	uring->cqes = (struct io_uring_cqe *)((char *)uring->cq_ptr +
+		params.cq_off.cqes);
+
+	return uring;
+}
+
+
+/** @brief Frees io_uring object.
+ *
+ * @param [in] uring The io_uring object.
+ */
+void faux_eloop_uring_free(faux_eloop_uring_t *uring)
+{
+	size_t i = 0;
+
+	if (!uring)
+		return;
+
+	// Kernel can use buffers of read/write requests while they are not
+	// completed. So cancel requests and wait for completions.
+	for (i = 0; i < uring->fds_size; i++) {
+		if (uring->fds[i].async)
+			faux_eloop_uring_del_async(uring, i);
+	}
+	while (uring->io_num > 0) {
+		struct io_uring_getevents_arg arg = {};
+		struct __kernel_timespec ts = {};
+		unsigned int head = 0;
+
+		ts.tv_sec = URING_CANCEL_TIMEOUT_SEC;
+		arg.ts = (uint64_t)(uintptr_t)&ts;
+		if ((uring_enter(uring, 1, IORING_ENTER_GETEVENTS |
+			IORING_ENTER_EXT_ARG, &arg) < 0) && (errno != EINTR))
+			break; // Don't free buffers that can be used by kernel
+		head = *uring->cq_head;
+		while (head != __atomic_load_n(uring->cq_tail,
+			__ATOMIC_ACQUIRE)) {
+			struct io_uring_cqe *cqe =
+				&uring->cqes[head & *uring->cq_mask];
+			head++;
+			if ((URING_UD_IGNORE != cqe->user_data) &&
+				(cqe->user_data & URING_UD_IO) &&
+				!(cqe->user_data & URING_UD_IO_POLL))
+				uring_io_complete(uring,
+					(faux_eloop_uring_io_t *)(uintptr_t)
+					(cqe->user_data & ~URING_UD_IO),
+					cqe->res);
+		}
+		__atomic_store_n(uring->cq_head, head, __ATOMIC_RELEASE);
+	}
+
+	if (uring->sqes != MAP_FAILED)
+		munmap(uring->sqes, uring->sqes_size);
+	if ((uring->cq_ptr != MAP_FAILED) && (uring->cq_ptr != uring->sq_ptr))
+		munmap(uring->cq_ptr, uring->cq_size);
+	if (uring->sq_ptr != MAP_FAILED)
+		munmap(uring->sq_ptr, uring->sq_size);
+	close(uring->fd);
+	faux_free(uring->fds);
+	faux_free(uring);
+}
+
+
+/** @brief Starts to watch fd or changes events mask of watched fd.
+ *
+ * The poll request is queued but not submitted.
+ *
+ * @param [in] uring The io_uring object.
+ * @param [in] fd File descriptor.
+ * @param [in] events File events mask like POLLIN, POLLOUT.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_eloop_uring_watch(faux_eloop_uring_t *uring, int fd, short events)
+{
+	faux_eloop_uring_fd_t *entry = NULL;
+
+	assert(uring);
+	if (!uring || (fd < 0))
+		return BOOL_FALSE;
+
+	if (!uring_fds_grow(uring, fd))
+		return BOOL_FALSE;
+	entry = &uring->fds[fd];
+	if (entry->watched)
+		faux_eloop_uring_unwatch(uring, fd);
+	entry->events = events;
+	entry->watched = BOOL_TRUE;
+
+	return uring_arm(uring, fd);
+}
+
+
+/** @brief Stops to watch fd.
+ *
+ * The removing of active poll request is queued but not submitted.
+ *
+ * @param [in] uring The io_uring object.
+ * @param [in] fd File descriptor.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_eloop_uring_unwatch(faux_eloop_uring_t *uring, int fd)
+{
+	faux_eloop_uring_fd_t *entry = NULL;
+
+	assert(uring);
+	if (!uring || (fd < 0))
+		return BOOL_FALSE;
+	if ((size_t)fd >= uring->fds_size)
+		return BOOL_FALSE;
+
+	entry = &uring->fds[fd];
+	if (!entry->watched)
+		return BOOL_FALSE;
+	if (entry->armed)
+		uring_queue(uring, IORING_OP_POLL_REMOVE, -1, 0,
+			uring_ud(fd, entry->gen), 0, 0, URING_UD_IGNORE);
+	entry->watched = BOOL_FALSE;
+	entry->armed = BOOL_FALSE;
+	entry->gen++;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Submits queued requests and waits for ready fds.
+ *
+ * The fds got by previous wait are re-armed before. The ready fds can be
+ * got from uring->ready array.
+ *
+ * @param [in] uring The io_uring object.
+ * @param [in] timeout Timeout. NULL for infinite timeout.
+ * @param [in] sigmask Signal mask to set while waiting. Can be NULL.
+ * @return Number of ready fds, 0 on timeout, < 0 on error.
+ */
+int faux_eloop_uring_wait(faux_eloop_uring_t *uring,
+	const struct timespec *timeout, const sigset_t *sigmask)
+{
+	struct io_uring_getevents_arg arg = {};
+	struct __kernel_timespec ts = {};
+	unsigned int head = 0;
+	unsigned int min_complete = 1;
+	int i = 0;
+
+	assert(uring);
+	if (!uring)
+		return -1;
+
+	// Level-triggered semantics. Ask for still watched fds again.
+	for (i = 0; i < uring->ready_num; i++) {
+		int fd = uring->ready[i].fd;
+		faux_eloop_uring_fd_t *entry = &uring->fds[fd];
+		if (entry->watched && !entry->armed)
+			uring_arm(uring, fd);
+	}
+	uring->ready_num = 0;
+
+	// Don't wait if there are not processed completions
+	if (*uring->cq_head != __atomic_load_n(uring->cq_tail, __ATOMIC_ACQUIRE))
+		min_complete = 0;
+	if (timeout) {
+		ts.tv_sec = timeout->tv_sec;
+		ts.tv_nsec = timeout->tv_nsec;
+		arg.ts = (uint64_t)(uintptr_t)&ts;
+	}
+	if (sigmask) {
+		arg.sigmask = (uint64_t)(uintptr_t)sigmask;
+		arg.sigmask_sz = _NSIG / 8;
+	}
+	if (uring_enter(uring, min_complete,
+		IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg) < 0) {
+		if ((errno != ETIME) && (errno != EBUSY))
+			return -1;
+	}
+
+	head = *uring->cq_head;
+	while ((head != __atomic_load_n(uring->cq_tail, __ATOMIC_ACQUIRE)) &&
+		(uring->ready_num < URING_EVENTS_NUM)) {
+		struct io_uring_cqe *cqe = &uring->cqes[head & *uring->cq_mask];
+		int fd = (int)(uint32_t)cqe->user_data;
+		uint32_t gen = (uint32_t)(cqe->user_data >> 32);
+		faux_eloop_uring_fd_t *entry = NULL;
+
+		head++;
+		if (URING_UD_IGNORE == cqe->user_data)
+			continue;
+		// Completion of read/write request of async object
+		if (cqe->user_data & URING_UD_IO) {
+			faux_eloop_uring_io_t *io = NULL;
+			int io_fd = -1;
+			short revents = 0;
+			int j = 0;
+			// Linked request reports the result itself
+			if (cqe->user_data & URING_UD_IO_POLL)
+				continue;
+			io = (faux_eloop_uring_io_t *)
+				(uintptr_t)(cqe->user_data & ~URING_UD_IO);
+			io_fd = io->fd;
+			revents = uring_io_complete(uring, io, cqe->res);
+			if (!revents)
+				continue;
+			// Fd can be already reported by previous completion
+			for (j = 0; j < uring->ready_num; j++) {
+				if (uring->ready[j].fd == io_fd)
+					break;
+			}
+			if (j == uring->ready_num) {
+				uring->ready[j].fd = io_fd;
+				uring->ready[j].revents = 0;
+				uring->ready_num++;
+			}
+			uring->ready[j].revents |= revents;
+			continue;
+		}
+		if ((size_t)fd >= uring->fds_size)
+			continue;
+		entry = &uring->fds[fd];
+		if (!entry->watched || !entry->armed ||
+			((entry->gen & URING_GEN_MASK) != gen))
+			continue; // Stale completion
+		entry->armed = BOOL_FALSE;
+		uring->ready[uring->ready_num].fd = fd;
+		uring->ready[uring->ready_num].revents = (cqe->res < 0) ?
+			POLLERR : (short)cqe->res;
+		uring->ready_num++;
+	}
+	__atomic_store_n(uring->cq_head, head, __ATOMIC_RELEASE);
+
+	return uring->ready_num;
+}
+
+
+/** @brief Starts to serve async object by read/write requests.
+ *
+ * The read request is queued but not submitted. The fd must not be watched
+ * by poll requests.
+ *
+ * @param [in] uring The io_uring object.
+ * @param [in] async Async object.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_eloop_uring_add_async(faux_eloop_uring_t *uring,
+	faux_async_t *async)
+{
+	faux_eloop_uring_fd_t *entry = NULL;
+	faux_eloop_uring_io_t *io = NULL;
+	int fd = -1;
+
+	assert(uring);
+	assert(async);
+	if (!uring || !async)
+		return BOOL_FALSE;
+	fd = faux_async_fd(async);
+	if (fd < 0)
+		return BOOL_FALSE;
+
+	if (!uring_fds_grow(uring, fd))
+		return BOOL_FALSE;
+	entry = &uring->fds[fd];
+	if (entry->watched || entry->async)
+		return BOOL_FALSE;
+
+	io = faux_zmalloc(sizeof(*io));
+	if (!io)
+		return BOOL_FALSE;
+	io->async = async;
+	io->fd = fd;
+	io->opcode = IORING_OP_READ;
+	io->len = sizeof(io->buf);
+	if (!uring_io_queue(uring, io, BOOL_FALSE)) {
+		faux_free(io);
+		return BOOL_FALSE;
+	}
+	entry->async = async;
+	entry->rd = io;
+	entry->wr = NULL;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Stops to serve async object.
+ *
+ * The active requests are cancelled. Their completions free them later.
+ * The data not written yet is dropped. The request waiting for readiness
+ * is cancelled through the linked poll request. Then request itself is
+ * completed with -ECANCELED. The cancellation of request that doesn't
+ * exist fails with -ENOENT. Such result is ignored.
+ *
+ * @param [in] uring The io_uring object.
+ * @param [in] fd File descriptor of async object.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_eloop_uring_del_async(faux_eloop_uring_t *uring, int fd)
+{
+	faux_eloop_uring_fd_t *entry = NULL;
+	faux_eloop_uring_io_t *ios[2] = {};
+	unsigned int i = 0;
+
+	assert(uring);
+	if (!uring || (fd < 0))
+		return BOOL_FALSE;
+	if ((size_t)fd >= uring->fds_size)
+		return BOOL_FALSE;
+
+	entry = &uring->fds[fd];
+	if (!entry->async)
+		return BOOL_FALSE;
+	ios[0] = entry->rd;
+	ios[1] = entry->wr;
+	for (i = 0; i < 2; i++) {
+		if (!ios[i])
+			continue;
+		ios[i]->async = NULL;
+		uring_queue(uring, IORING_OP_ASYNC_CANCEL, -1, 0,
+			uring_io_ud(ios[i]), 0, 0, URING_UD_IGNORE);
+		uring_queue(uring, IORING_OP_ASYNC_CANCEL, -1, 0,
+			uring_io_poll_ud(ios[i]), 0, 0, URING_UD_IGNORE);
+	}
+	entry->async = NULL;
+	entry->rd = NULL;
+	entry->wr = NULL;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Takes output data of async object to write.
+ *
+ * It's an engine function for faux_async_out(). The write request is
+ * queued but not submitted.
+ *
+ * @param [in] uring The io_uring object.
+ * @param [in] fd File descriptor of async object.
+ * @return Length of data taken from output buffer or < 0 on error.
+ */
+ssize_t faux_eloop_uring_async_out(faux_eloop_uring_t *uring, int fd)
+{
+	assert(uring);
+	if (!uring || (fd < 0))
+		return -1;
+	if (((size_t)fd >= uring->fds_size) || !uring->fds[fd].async)
+		return -1;
+
+	return uring_write_next(uring, fd);
+}
+
+#endif // HAVE_IO_URING
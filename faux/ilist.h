@@ -0,0 +1,74 @@
+/** @file ilist.h
+ * @brief Public interface for an intrusive bidirectional list.
+ */
+
+#ifndef _faux_ilist_h
+#define _faux_ilist_h
+
+#include <stddef.h>
+
+#include <faux/faux.h>
+#include <faux/list.h>
+
+// List node is embedded into user structure
+typedef struct faux_ilist_node_s faux_ilist_node_t;
+struct faux_ilist_node_s {
+	faux_ilist_node_t *prev;
+	faux_ilist_node_t *next;
+};
+
+typedef struct faux_ilist_s faux_ilist_t;
+
+/** @brief Gets user structure by embedded list node.
+ *
+ * @param [in] node Pointer to embedded list node.
+ * @param [in] type Type of user structure.
+ * @param [in] member Name of list node field within user structure.
+ */
+#define faux_ilist_entry(node, type, member) \
+	((type *)((char *)(node) - offsetof(type, member)))
+
+C_DECL_BEGIN
+
+// ilist_node_t methods
+faux_ilist_node_t *faux_ilist_prev_node(const faux_ilist_node_t *node);
+faux_ilist_node_t *faux_ilist_next_node(const faux_ilist_node_t *node);
+faux_ilist_node_t *faux_ilist_each_node(faux_ilist_node_t **iter);
+faux_ilist_node_t *faux_ilist_eachr_node(faux_ilist_node_t **iter);
+
+// ilist_t methods
+faux_ilist_t *faux_ilist_new(faux_list_sorted_e sorted,
+	faux_list_unique_e unique, size_t offset,
+	faux_list_cmp_fn cmpFn, faux_list_kcmp_fn kcmpFn,
+	faux_list_free_fn freeFn);
+void faux_ilist_free(faux_ilist_t *list);
+
+void *faux_ilist_data(const faux_ilist_t *list, const faux_ilist_node_t *node);
+faux_ilist_node_t *faux_ilist_node(const faux_ilist_t *list, const void *data);
+void *faux_ilist_each(const faux_ilist_t *list, faux_ilist_node_t **iter);
+void *faux_ilist_eachr(const faux_ilist_t *list, faux_ilist_node_t **iter);
+
+faux_ilist_node_t *faux_ilist_head(const faux_ilist_t *list);
+faux_ilist_node_t *faux_ilist_tail(const faux_ilist_t *list);
+size_t faux_ilist_len(const faux_ilist_t *list);
+bool_t faux_ilist_is_empty(const faux_ilist_t *list);
+
+faux_ilist_node_t *faux_ilist_add(faux_ilist_t *list, void *data);
+faux_ilist_node_t *faux_ilist_add_find(faux_ilist_t *list, void *data);
+void *faux_ilist_takeaway(faux_ilist_t *list, faux_ilist_node_t *node);
+bool_t faux_ilist_del(faux_ilist_t *list, faux_ilist_node_t *node);
+bool_t faux_ilist_kdel(faux_ilist_t *list, const void *userkey);
+ssize_t faux_ilist_del_all(faux_ilist_t *list);
+
+faux_ilist_node_t *faux_ilist_find_node(const faux_ilist_t *list,
+	faux_list_kcmp_fn matchFn, const void *userkey);
+faux_ilist_node_t *faux_ilist_kfind_node(const faux_ilist_t *list,
+	const void *userkey);
+void *faux_ilist_find(const faux_ilist_t *list,
+	faux_list_kcmp_fn matchFn, const void *userkey);
+void *faux_ilist_kfind(const faux_ilist_t *list,
+	const void *userkey);
+
+C_DECL_END
+
+#endif				/* _faux_ilist_h */
@@ -11,7 +11,8 @@
 
 typedef enum {
 	FAUX_LIST_SORTED = BOOL_TRUE,
-	FAUX_LIST_UNSORTED = BOOL_FALSE
+	FAUX_LIST_UNSORTED = BOOL_FALSE,
+	FAUX_LIST_SKIPLIST = 2 // Sorted with O(log n) add and key search
 	} faux_list_sorted_e;
 
 typedef enum {
@@ -25,6 +26,8 @@ typedef struct faux_list_s faux_list_t;
 typedef int (*faux_list_cmp_fn)(const void *new_item, const void *list_item);
 typedef int (*faux_list_kcmp_fn)(const void *key, const void *list_item);
 typedef void (*faux_list_free_fn)(void *list_item);
+typedef size_t (*faux_list_hash_fn)(const void *list_item);
+typedef size_t (*faux_list_khash_fn)(const void *key);
 
 C_DECL_BEGIN
 
@@ -41,6 +44,10 @@ void *faux_list_eachr(faux_list_node_t **iter);
 faux_list_t *faux_list_new(faux_list_sorted_e sorted, faux_list_unique_e unique,
 	faux_list_cmp_fn cmpFn, faux_list_kcmp_fn kcmpFn,
 	faux_list_free_fn freeFn);
+faux_list_t *faux_list_new_hash(faux_list_unique_e unique,
+	faux_list_cmp_fn cmpFn, faux_list_kcmp_fn kcmpFn,
+	faux_list_hash_fn hashFn, faux_list_khash_fn khashFn,
+	faux_list_free_fn freeFn);
 void faux_list_free(faux_list_t *list);
 
 faux_list_node_t *faux_list_head(const faux_list_t *list);
@@ -50,6 +57,9 @@ bool_t faux_list_is_empty(const faux_list_t *list);
 
 faux_list_node_t *faux_list_add(faux_list_t *list, void *data);
 faux_list_node_t *faux_list_add_find(faux_list_t *list, void *data);
+ssize_t faux_list_add_bulk(faux_list_t *list, void **data, size_t num);
+bool_t faux_list_sort(faux_list_t *list, faux_list_cmp_fn cmpFn);
+ssize_t faux_list_merge(faux_list_t *list, faux_list_t *other);
 void *faux_list_takeaway(faux_list_t *list, faux_list_node_t *node);
 bool_t faux_list_del(faux_list_t *list, faux_list_node_t *node);
 bool_t faux_list_kdel(faux_list_t *list, const void *userkey);
@@ -75,6 +85,8 @@ void *faux_list_kfind(const faux_list_t *list,
 	const void *userkey);
 faux_list_node_t *faux_list_index_node(const faux_list_t *list, size_t index);
 void *faux_list_index(const faux_list_t *list, size_t index);
+faux_list_node_t *faux_list_seek_node(faux_list_t *list, size_t index);
+void *faux_list_seek(faux_list_t *list, size_t index);
 
 C_DECL_END
 
@@ -0,0 +1,570 @@
+/** @file ilist.c
+ * @brief Implementation of an intrusive bidirectional list.
+ *
+ * Intrusive list doesn't allocate nodes. The node (faux_ilist_node_t) is
+ * embedded into user structure. The list knows offset of node within user
+ * structure so it can get user data by node and vice versa. So adding to
+ * the list doesn't allocate memory at all and there is no pointer chase
+ * from node to data.
+ *
+ * The list has the same sorted/unique semantics and uses the same callback
+ * functions as faux_list_t. Callbacks get pointers to user structures.
+ * User structure can be linked into one list by single embedded node at
+ * the same time.
+ */
+
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+#include "private.h"
+#include "faux/ilist.h"
+
+
+/** @brief Gets previous list node.
+ *
+ * @param [in] node List node.
+ * @return List node previous in list.
+ */
+faux_ilist_node_t *faux_ilist_prev_node(const faux_ilist_node_t *node)
+{
+	assert(node);
+	if (!node)
+		return NULL;
+
+	return node->prev;
+}
+
+
+/** @brief Gets next list node.
+ *
+ * @param [in] node List node.
+ * @return List node next in list.
+ */
+faux_ilist_node_t *faux_ilist_next_node(const faux_ilist_node_t *node)
+{
+	assert(node);
+	if (!node)
+		return NULL;
+
+	return node->next;
+}
+
+
+/** @brief Iterate through each list node.
+ *
+ * On each call to this function the iterator will change its value.
+ * Before function using the iterator must be initialised by list head node.
+ *
+ * @param [in,out] iter List node ptr used as an iterator.
+ * @return List node or NULL if list elements are over.
+ */
+faux_ilist_node_t *faux_ilist_each_node(faux_ilist_node_t **iter)
+{
+	faux_ilist_node_t *current_node = *iter;
+
+	// No assert() on current_node. NULL iterator is normal
+	if (!current_node)
+		return NULL;
+	*iter = current_node->next;
+
+	return current_node;
+}
+
+
+/** @brief Iterate through each list node. Reverse order.
+ *
+ * On each call to this function the iterator will change its value.
+ * Before function using the iterator must be initialised by list tail node.
+ *
+ * @param [in,out] iter List node ptr used as an iterator.
+ * @return List node or NULL if list elements are over.
+ */
+faux_ilist_node_t *faux_ilist_eachr_node(faux_ilist_node_t **iter)
+{
+	faux_ilist_node_t *current_node = *iter;
+
+	// No assert() on current_node. NULL iterator is normal
+	if (!current_node)
+		return NULL;
+	*iter = current_node->prev;
+
+	return current_node;
+}
+
+
+/** @brief Allocate and initialize intrusive bidirectional list.
+ *
+ * The offset is an offset of faux_ilist_node_t field within user structure.
+ * Use offsetof() macro to get it.
+ *
+ * @sa faux_list_new()
+ * @param [in] sorted If list is sorted - FAUX_LIST_SORTED, unsorted - FAUX_LIST_UNSORTED.
+ * @param [in] unique If list entry is unique - FAUX_LIST_UNIQUE, else - FAUX_LIST_NONUNIQUE.
+ * @param [in] offset Offset of list node within user structure.
+ * @param [in] cmpFn Callback function to compare two user data instances
+ * to sort list.
+ * @param [in] kcmpFn Callback function to compare key and user data.
+ * @param [in] freeFn Callback function to free user data.
+ * @return Newly created intrusive list or NULL on error.
+ */
+faux_ilist_t *faux_ilist_new(faux_list_sorted_e sorted,
+	faux_list_unique_e unique, size_t offset,
+	faux_list_cmp_fn cmpFn, faux_list_kcmp_fn kcmpFn,
+	faux_list_free_fn freeFn)
+{
+	faux_ilist_t *list = NULL;
+
+	// Sorted list must have cmpFn
+	if (sorted && !cmpFn)
+		return NULL;
+
+	// Unique list must have cmpFn
+	if (unique && !cmpFn)
+		return NULL;
+
+	list = faux_zmalloc(sizeof(*list));
+	assert(list);
+	if (!list)
+		return NULL;
+
+	// Initialize
+	list->head = NULL;
+	list->tail = NULL;
+	list->sorted = sorted;
+	list->unique = unique;
+	list->offset = offset;
+	list->cmpFn = cmpFn;
+	list->kcmpFn = kcmpFn;
+	list->freeFn = freeFn;
+	list->len = 0;
+
+	return list;
+}
+
+
+/** @brief Free intrusive list.
+ *
+ * Removes all entries and frees user data by freeFn callback. Then frees
+ * the list itself.
+ *
+ * @param [in] list List to free.
+ */
+void faux_ilist_free(faux_ilist_t *list)
+{
+	faux_ilist_del_all(list);
+	faux_free(list);
+}
+
+
+/** @brief Gets user data by list node.
+ *
+ * @param [in] list List.
+ * @param [in] node List node.
+ * @return User data containing list node.
+ */
+void *faux_ilist_data(const faux_ilist_t *list, const faux_ilist_node_t *node)
+{
+	assert(list);
+	if (!list)
+		return NULL;
+	if (!node)
+		return NULL;
+
+	return (char *)node - list->offset;
+}
+
+
+/** @brief Gets list node embedded into user data.
+ *
+ * @param [in] list List.
+ * @param [in] data User data.
+ * @return List node.
+ */
+faux_ilist_node_t *faux_ilist_node(const faux_ilist_t *list, const void *data)
+{
+	assert(list);
+	if (!list)
+		return NULL;
+	if (!data)
+		return NULL;
+
+	return (faux_ilist_node_t *)((char *)data + list->offset);
+}
+
+
+/** @brief Iterate through each list node and returns user data.
+ *
+ * @param [in] list List.
+ * @param [in,out] iter List node ptr used as an iterator.
+ * @return User data or NULL if list elements are over.
+ */
+void *faux_ilist_each(const faux_ilist_t *list, faux_ilist_node_t **iter)
+{
+	return faux_ilist_data(list, faux_ilist_each_node(iter));
+}
+
+
+/** @brief Iterate (reverse order) through each list node and returns user data.
+ *
+ * @param [in] list List.
+ * @param [in,out] iter List node ptr used as an iterator.
+ * @return User data or NULL if list elements are over.
+ */
+void *faux_ilist_eachr(const faux_ilist_t *list, faux_ilist_node_t **iter)
+{
+	return faux_ilist_data(list, faux_ilist_eachr_node(iter));
+}
+
+
+/** @brief Gets head of list.
+ *
+ * @param [in] list List.
+ * @return List node first in list.
+ */
+faux_ilist_node_t *faux_ilist_head(const faux_ilist_t *list)
+{
+	assert(list);
+	if (!list)
+		return NULL;
+
+	return list->head;
+}
+
+
+/** @brief Gets tail of list.
+ *
+ * @param [in] list List.
+ * @return List node last in list.
+ */
+faux_ilist_node_t *faux_ilist_tail(const faux_ilist_t *list)
+{
+	assert(list);
+	if (!list)
+		return NULL;
+
+	return list->tail;
+}
+
+
+/** @brief Gets current length of list.
+ *
+ * @param [in] list List.
+ * @return Current length of list.
+ */
+size_t faux_ilist_len(const faux_ilist_t *list)
+{
+	assert(list);
+	if (!list)
+		return 0;
+
+	return list->len;
+}
+
+
+/** @brief Checks is list empty.
+ *
+ * @param [in] list Allocated list.
+ * @return BOOL_TRUE - empty, BOOL_FALSE - not empty.
+ */
+bool_t faux_ilist_is_empty(const faux_ilist_t *list)
+{
+	assert(list);
+	if (!list)
+		return BOOL_TRUE;
+
+	if (faux_ilist_len(list) == 0)
+		return BOOL_TRUE;
+
+	return BOOL_FALSE;
+}
+
+
+/** @brief Generic static function for adding new list nodes.
+ *
+ * @param [in] list List to add node to.
+ * @param [in] data User data containing list node.
+ * @param [in] find - true/false Function returns list node if there is
+ * identical entry. Or NULL if find is false.
+ * @return Added list node.
+ */
+static faux_ilist_node_t *faux_ilist_add_generic(
+	faux_ilist_t *list, void *data, bool_t find)
+{
+	faux_ilist_node_t *node = NULL;
+	faux_ilist_node_t *iter = NULL;
+
+	assert(list);
+	assert(data);
+	if (!list || !data)
+		return NULL;
+
+	node = faux_ilist_node(list, data);
+	node->prev = NULL;
+	node->next = NULL;
+
+	// Empty list
+	if (!list->head) {
+		list->head = node;
+		list->tail = node;
+		list->len++;
+		return node;
+	}
+
+	// Non-sorted: Insert to tail
+	if (!list->sorted) {
+		// Unique: Search through whole list
+		if (list->unique) {
+			iter = list->tail;
+			while (iter) {
+				int res = list->cmpFn(data,
+					faux_ilist_data(list, iter));
+				if (0 == res) // Already in list
+					return (find ? iter : NULL);
+				iter = iter->prev;
+			}
+		}
+		// Add entry to the tail
+		node->prev = list->tail;
+		list->tail->next = node;
+		list->tail = node;
+		list->len++;
+		return node;
+	}
+
+	// Sorted: Insert from tail
+	iter = list->tail;
+	while (iter) {
+		int res = list->cmpFn(data, faux_ilist_data(list, iter));
+		// Unique: Already exists
+		if (list->unique && (0 == res))
+			return (find ? iter : NULL);
+		// Non-unique: Entry will be inserted after existent one
+		if (res >= 0) {
+			node->next = iter->next;
+			node->prev = iter;
+			iter->next = node;
+			if (node->next)
+				node->next->prev = node;
+			break;
+		}
+		iter = iter->prev;
+	}
+	// Insert node into the list head
+	if (!iter) {
+		node->next = list->head;
+		node->prev = NULL;
+		list->head->prev = node;
+		list->head = node;
+	}
+	if (!node->next)
+		list->tail = node;
+	list->len++;
+
+	return node;
+}
+
+
+/** @brief Adds user data to the list.
+ *
+ * The user data must not be linked into any list by the same node.
+ *
+ * @param [in] list List to add entry to.
+ * @param [in] data User data containing list node.
+ * @return Added list node or NULL on error.
+ */
+faux_ilist_node_t *faux_ilist_add(faux_ilist_t *list, void *data)
+{
+	return faux_ilist_add_generic(list, data, BOOL_FALSE);
+}
+
+
+/** @brief Adds user data (unique) to the list or return equal existent node.
+ *
+ * @sa faux_list_add_find()
+ * @param [in] list List to add entry to.
+ * @param [in] data User data containing list node.
+ * @return Added list node, existent equal node or NULL on error.
+ */
+faux_ilist_node_t *faux_ilist_add_find(faux_ilist_t *list, void *data)
+{
+	assert(list);
+	if (!list)
+		return NULL;
+
+	// See faux_list_add_find()
+	if (!list->unique)
+		return NULL;
+
+	return faux_ilist_add_generic(list, data, BOOL_TRUE);
+}
+
+
+/** Takes away list node from the list.
+ *
+ * Function unlinks list node from the list and returns user data
+ * containing this node. User data is not freed.
+ *
+ * @param [in] list List to take away node from.
+ * @param [in] node List node to take away.
+ * @return User data or NULL on error.
+ */
+void *faux_ilist_takeaway(faux_ilist_t *list, faux_ilist_node_t *node)
+{
+	assert(list);
+	assert(node);
+	if (!list || !node)
+		return NULL;
+
+	if (node->prev)
+		node->prev->next = node->next;
+	else
+		list->head = node->next;
+	if (node->next)
+		node->next->prev = node->prev;
+	else
+		list->tail = node->prev;
+	list->len--;
+	node->prev = NULL;
+	node->next = NULL;
+
+	return faux_ilist_data(list, node);
+}
+
+
+/** @brief Deletes list node from the list.
+ *
+ * Function unlinks node from the list and frees user data by freeFn
+ * callback if it was defined while list creation.
+ *
+ * @param [in] list List to delete node from.
+ * @param [in] node List node to delete.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_ilist_del(faux_ilist_t *list, faux_ilist_node_t *node)
+{
+	void *data = NULL;
+
+	data = faux_ilist_takeaway(list, node);
+	if (!data)
+		return BOOL_FALSE;
+	if (list->freeFn)
+		list->freeFn(data);
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Deletes list node found by key.
+ *
+ * @param [in] list List to delete node from.
+ * @param [in] userkey User defined key to compare list entry to.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error or "not found" case.
+ */
+bool_t faux_ilist_kdel(faux_ilist_t *list, const void *userkey)
+{
+	faux_ilist_node_t *node = NULL;
+
+	node = faux_ilist_kfind_node(list, userkey);
+	if (!node)
+		return BOOL_FALSE;
+
+	return faux_ilist_del(list, node);
+}
+
+
+/** @brief Delete all entries from list
+ *
+ * Unlinks all list entries and frees user data by freeFn callback.
+ *
+ * @param [in] list List to empty.
+ * @return Number of deleted entries or < 0 on error.
+ */
+ssize_t faux_ilist_del_all(faux_ilist_t *list)
+{
+	faux_ilist_node_t *iter = NULL;
+	ssize_t num = 0;
+
+	if (!list)
+		return -1;
+
+	while ((iter = faux_ilist_head(list))) {
+		faux_ilist_del(list, iter);
+		num++;
+	}
+
+	return num;
+}
+
+
+/** @brief Search list for matching (match function).
+ *
+ * @param [in] list List.
+ * @param [in] matchFn User defined matching function.
+ * @param [in] userkey User defined key to compare list entry to.
+ * @return Found list node or NULL.
+ */
+faux_ilist_node_t *faux_ilist_find_node(const faux_ilist_t *list,
+	faux_list_kcmp_fn matchFn, const void *userkey)
+{
+	faux_ilist_node_t *iter = NULL;
+
+	assert(list);
+	assert(matchFn);
+	if (!list || !matchFn)
+		return NULL;
+
+	iter = list->head;
+	while (iter) {
+		if (matchFn(userkey, faux_ilist_data(list, iter)) == 0)
+			return iter;
+		iter = iter->next;
+	}
+
+	return NULL;
+}
+
+
+/** @brief Search list for matching (key cmp function).
+ *
+ * @param [in] list List.
+ * @param [in] userkey User defined key to compare list entry to.
+ * @return Found list node or NULL.
+ */
+faux_ilist_node_t *faux_ilist_kfind_node(const faux_ilist_t *list,
+	const void *userkey)
+{
+	assert(list);
+	if (!list)
+		return NULL;
+
+	return faux_ilist_find_node(list, list->kcmpFn, userkey);
+}
+
+
+/** @brief Search list for matching (match function) and returns user data.
+ *
+ * @param [in] list List.
+ * @param [in] matchFn User defined matching function.
+ * @param [in] userkey User defined key to compare list entry to.
+ * @return Found user data or NULL.
+ */
+void *faux_ilist_find(const faux_ilist_t *list,
+	faux_list_kcmp_fn matchFn, const void *userkey)
+{
+	return faux_ilist_data(list,
+		faux_ilist_find_node(list, matchFn, userkey));
+}
+
+
+/** @brief Search list for matching (key cmp function) and returns user data.
+ *
+ * @param [in] list List.
+ * @param [in] userkey User defined key to compare list entry to.
+ * @return Found user data or NULL.
+ */
+void *faux_ilist_kfind(const faux_ilist_t *list,
+	const void *userkey)
+{
+	return faux_ilist_data(list, faux_ilist_kfind_node(list, userkey));
+}
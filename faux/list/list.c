@@ -9,6 +9,41 @@
  * due to this function return value that indicates "less than",
  * "equal", "greater than". Additionally user may provide another callback
  * function to free user defined data on list freeing.
+ *
+ * The FAUX_LIST_SKIPLIST list is sorted list with skip list index. The base
+ * level of skip list is an ordinary bidirectional list so iteration is the
+ * same. Some nodes have additional "skip" pointers to the next nodes on upper
+ * levels. Node is promoted to the each next level with 1/LIST_SKIP_P chance.
+ * So adding and search by key costs O(log n) instead of O(n). The kcmpFn
+ * must order items the same way as cmpFn. The equal items keep order of
+ * adding. The "skip" pointers are placed at the end of enlarged node (see
+ * faux_list_skip_node_t) so nodes of other lists don't pay for them.
+ *
+ * The unsorted list created by faux_list_new_hash() has side hash table.
+ * The uniqueness check and search by key look through single hash bucket
+ * instead of whole list. The list keeps order of adding. The table grows
+ * twice when number of nodes exceeds number of buckets. The hash and bucket
+ * link are kept within enlarged node (see faux_list_hash_node_t).
+ *
+ * The state of skip list index and hash table (see faux_list_skip_t and
+ * faux_list_hash_t) is allocated separately and only for the lists which
+ * use it. So plain list header stays small.
+ *
+ * The faux_list_seek_node() remembers the found node within the list
+ * (finger). The next seek walks from the nearest of head, tail and finger.
+ * So sequential access by index costs O(1). The finger is dropped by any
+ * list change except adding to the tail. The seek changes the list so it's
+ * not thread-safe even if list is only read. The faux_list_index_node()
+ * doesn't use finger and doesn't change the list. The finger is allocated
+ * by the first seek.
+ *
+ * The nodes are not allocated one by one. List allocates nodes by slabs.
+ * Slab size grows geometrically from LIST_SLAB_MIN to LIST_SLAB_MAX nodes so
+ * short lists don't waste memory. The freed nodes are kept within freelist
+ * and reused. The skip list nodes have different sizes so skip list index
+ * keeps a freelist for each number of levels. The slabs are freed by
+ * faux_list_del_all() or faux_list_free() only. The nodes of list filled at once are adjacent in memory, so
+ * iteration has good locality.
  */
 
 #include <stdlib.h>
@@ -19,24 +54,152 @@
 #include "faux/list.h"
 
 
+/** @brief Gets skip list node by base node.
+ *
+ * Static service function. Node must belong to list with skip list index.
+ *
+ * @param [in] node List node.
+ * @return Skip list node.
+ */
+static faux_list_skip_node_t *faux_list_skip_node(const faux_list_node_t *node)
+{
+	return (faux_list_skip_node_t *)node;
+}
+
+
+/** @brief Gets hashed list node by base node.
+ *
+ * Static service function. Node must belong to list with hash table.
+ *
+ * @param [in] node List node.
+ * @return Hashed list node.
+ */
+static faux_list_hash_node_t *faux_list_hash_node(const faux_list_node_t *node)
+{
+	return (faux_list_hash_node_t *)node;
+}
+
+
+/** @brief Forgets the node got by the last seek.
+ *
+ * Static service function. It's used when indexes of nodes are changed.
+ *
+ * @param [in] list List.
+ */
+static void faux_list_drop_finger(faux_list_t *list)
+{
+	if (list->finger)
+		list->finger->node = NULL;
+}
+
+
+/** @brief Chooses random number of skip list levels for new node.
+ *
+ * Static service function.
+ *
+ * @param [in] list List.
+ * @return Number of levels above the base one.
+ */
+static unsigned int faux_list_skip_levels(faux_list_t *list)
+{
+	unsigned int num = 0;
+
+	// Xorshift generator
+	while (num < LIST_SKIP_LEVELS) {
+		list->skip->rand ^= list->skip->rand << 13;
+		list->skip->rand ^= list->skip->rand >> 17;
+		list->skip->rand ^= list->skip->rand << 5;
+		if ((list->skip->rand % LIST_SKIP_P) != 0)
+			break;
+		num++;
+	}
+
+	return num;
+}
+
+
+/** @brief Gets size of list node without skip list levels.
+ *
+ * Static service function.
+ *
+ * @param [in] list List.
+ * @return Size of node.
+ */
+static size_t faux_list_node_size(const faux_list_t *list)
+{
+	if (list->skip)
+		return sizeof(faux_list_skip_node_t);
+	if (list->hash)
+		return sizeof(faux_list_hash_node_t);
+
+	return sizeof(faux_list_node_t);
+}
+
+
 /** @brief Allocates and initializes new list node instance.
  *
+ * The node is taken from freelist or from the newest slab. New slab is
+ * allocated when there are no free nodes. The node of list with skip list
+ * index gets random number of levels. Such node is taken from freelist of
+ * nodes with the same number of levels.
+ *
+ * @param [in] list List to allocate node for.
  * @param [in] data User defined data to store within node.
  * @return Newly created list node instance or NULL on error.
  */
-static faux_list_node_t *faux_list_new_node(void *data)
+static faux_list_node_t *faux_list_new_node(faux_list_t *list, void *data)
 {
 	faux_list_node_t *node = NULL;
+	faux_list_slab_t *slab = list->slabs;
+	faux_list_node_t **free_nodes = &list->free_nodes;
+	unsigned int skip_num = 0;
+	size_t base_size = faux_list_node_size(list);
+	size_t node_size = base_size;
+
+	if (list->skip) {
+		skip_num = faux_list_skip_levels(list);
+		node_size += skip_num * sizeof(faux_list_node_t *);
+		free_nodes = &list->skip->free_nodes[skip_num];
+	}
 
-	node = faux_zmalloc(sizeof(*node));
-	assert(node);
-	if (!node)
-		return NULL;
+	if (*free_nodes) {
+		node = *free_nodes;
+		*free_nodes = node->next;
+	} else {
+		if (!slab || ((slab->size - slab->used) < node_size)) {
+			size_t size = slab ? (slab->size * 2) :
+				(LIST_SLAB_MIN * base_size);
+			if (size > (LIST_SLAB_MAX * base_size))
+				size = LIST_SLAB_MAX * base_size;
+			if (size < node_size)
+				size = node_size;
+			slab = faux_zmalloc(sizeof(*slab) + size);
+			assert(slab);
+			if (!slab)
+				return NULL;
+			slab->size = size;
+			slab->used = 0;
+			slab->next = list->slabs;
+			list->slabs = slab;
+		}
+		node = (faux_list_node_t *)((char *)slab->nodes + slab->used);
+		slab->used += node_size;
+	}
 
 	// Initialize
 	node->prev = NULL;
 	node->next = NULL;
 	node->data = data;
+	if (list->hash) {
+		faux_list_hash_node_t *hnode = faux_list_hash_node(node);
+		hnode->hash = 0;
+		hnode->hnext = NULL;
+	}
+	if (list->skip) {
+		faux_list_skip_node_t *snode = faux_list_skip_node(node);
+		snode->skip_num = skip_num;
+		faux_bzero(snode->skip, skip_num * sizeof(*snode->skip));
+	}
 
 	return node;
 }
@@ -44,11 +207,22 @@ static faux_list_node_t *faux_list_new_node(void *data)
 
 /** @brief Free list node instance.
  *
+ * The node is returned to list's freelist.
+ *
+ * @param [in] list List the node belongs to.
  * @param [in] node List node instance.
  */
-static void faux_list_free_node(faux_list_node_t *node)
+static void faux_list_free_node(faux_list_t *list, faux_list_node_t *node)
 {
-	faux_free(node);
+	faux_list_node_t **free_nodes = &list->free_nodes;
+
+	if (list->skip)
+		free_nodes = &list->skip->free_nodes[
+			faux_list_skip_node(node)->skip_num];
+	node->prev = NULL;
+	node->data = NULL;
+	node->next = *free_nodes;
+	*free_nodes = node;
 }
 
 
@@ -189,6 +363,7 @@ void *faux_list_eachr(faux_list_node_t **iter)
  * @endcode
  *
  * @param [in] sorted If list is sorted - FAUX_LIST_SORTED, unsorted - FAUX_LIST_UNSORTED.
+ * Sorted list with skip list index - FAUX_LIST_SKIPLIST.
  * @param [in] unique If list entry is unique - FAUX_LIST_UNIQUE, else - FAUX_LIST_NONUNIQUE.
  * @param [in] compareFn Callback function to compare two user data instances
  * to sort list.
@@ -223,6 +398,69 @@ faux_list_t *faux_list_new(faux_list_sorted_e sorted, faux_list_unique_e unique,
 	list->kcmpFn = kcmpFn;
 	list->freeFn = freeFn;
 	list->len = 0;
+	list->slabs = NULL;
+	list->free_nodes = NULL;
+	list->skip = NULL;
+	list->hash = NULL;
+	list->finger = NULL;
+
+	// Skip list index
+	if (FAUX_LIST_SKIPLIST == sorted) {
+		list->skip = faux_zmalloc(sizeof(*list->skip));
+		assert(list->skip);
+		if (!list->skip) {
+			faux_free(list);
+			return NULL;
+		}
+		list->skip->num = 0;
+		list->skip->rand = 0x9e3779b9;
+	}
+
+	return list;
+}
+
+
+/** @brief Allocate and initialize unsorted list with side hash table.
+ *
+ * The hashFn gets hash of list element. The khashFn gets hash of the key
+ * used by kcmpFn. Equal elements and element equal to key must have the
+ * same hash. The uniqueness check uses hashFn and cmpFn. The search by key
+ * (faux_list_kfind() etc.) uses khashFn and kcmpFn. The khashFn can be NULL.
+ * Then search by key is linear.
+ *
+ * @sa faux_list_new()
+ * @param [in] unique If list entry is unique - FAUX_LIST_UNIQUE, else - FAUX_LIST_NONUNIQUE.
+ * @param [in] cmpFn Callback function to compare two user data instances.
+ * @param [in] kcmpFn Callback function to compare key and user data.
+ * @param [in] hashFn Callback function to get hash of user data.
+ * @param [in] khashFn Callback function to get hash of key.
+ * @param [in] freeFn Callback function to free user data.
+ * @return Newly created list or NULL on error.
+ */
+faux_list_t *faux_list_new_hash(faux_list_unique_e unique,
+	faux_list_cmp_fn cmpFn, faux_list_kcmp_fn kcmpFn,
+	faux_list_hash_fn hashFn, faux_list_khash_fn khashFn,
+	faux_list_free_fn freeFn)
+{
+	faux_list_t *list = NULL;
+
+	assert(hashFn);
+	if (!hashFn)
+		return NULL;
+
+	list = faux_list_new(FAUX_LIST_UNSORTED, unique, cmpFn, kcmpFn, freeFn);
+	if (!list)
+		return NULL;
+	list->hash = faux_zmalloc(sizeof(*list->hash));
+	assert(list->hash);
+	if (!list->hash) {
+		faux_list_free(list);
+		return NULL;
+	}
+	list->hash->hashFn = hashFn;
+	list->hash->khashFn = khashFn;
+	list->hash->table = NULL;
+	list->hash->size = 0;
 
 	return list;
 }
@@ -230,7 +468,8 @@ faux_list_t *faux_list_new(faux_list_sorted_e sorted, faux_list_unique_e unique,
 
 /** @brief Delete all entries from list
  *
- * Removes and frees all list entries.
+ * Removes and frees all list entries. The nodes are not freed one by one.
+ * All the slabs are freed at once.
  *
  * @param [in] list List to empty.
  * @return Number of deleted entries or < 0 on error.
@@ -238,15 +477,43 @@ faux_list_t *faux_list_new(faux_list_sorted_e sorted, faux_list_unique_e unique,
 ssize_t faux_list_del_all(faux_list_t *list)
 {
 	faux_list_node_t *iter = NULL;
+	faux_list_slab_t *slab = NULL;
 	ssize_t num = 0;
 
 	if (!list)
 		return -1;
 
-	while ((iter = faux_list_head(list))) {
-		faux_list_del(list, iter);
+	// Detach nodes from list first then free user data
+	iter = list->head;
+	list->head = NULL;
+	list->tail = NULL;
+	list->len = 0;
+	while (iter) {
+		if (list->freeFn)
+			list->freeFn(iter->data);
+		iter = iter->next;
 		num++;
 	}
+	if (list->skip) {
+		faux_bzero(list->skip, sizeof(*list->skip));
+		list->skip->rand = 0x9e3779b9;
+	}
+	if (list->hash) {
+		faux_free(list->hash->table);
+		list->hash->table = NULL;
+		list->hash->size = 0;
+	}
+	faux_list_drop_finger(list);
+
+	// Free slabs
+	slab = list->slabs;
+	while (slab) {
+		faux_list_slab_t *next = slab->next;
+		faux_free(slab);
+		slab = next;
+	}
+	list->slabs = NULL;
+	list->free_nodes = NULL;
 
 	return num;
 }
@@ -263,7 +530,13 @@ ssize_t faux_list_del_all(faux_list_t *list)
  */
 void faux_list_free(faux_list_t *list)
 {
+	if (!list)
+		return;
+
 	faux_list_del_all(list);
+	faux_free(list->skip);
+	faux_free(list->hash);
+	faux_free(list->finger);
 	faux_free(list);
 }
 
@@ -331,6 +604,356 @@ bool_t faux_list_is_empty(const faux_list_t *list)
 }
 
 
+/** @brief Links node into the base level after specified node.
+ *
+ * Static service function.
+ *
+ * @param [in] list List.
+ * @param [in] prev Node to insert after or NULL to insert into the head.
+ * @param [in] node Node to insert.
+ */
+static void faux_list_link_node(faux_list_t *list, faux_list_node_t *prev,
+	faux_list_node_t *node)
+{
+	if (prev != list->tail) // Indexes of following nodes are changed
+		faux_list_drop_finger(list);
+	node->prev = prev;
+	node->next = prev ? prev->next : list->head;
+	if (node->next)
+		node->next->prev = node;
+	else
+		list->tail = node;
+	if (prev)
+		prev->next = node;
+	else
+		list->head = node;
+	list->len++;
+}
+
+
+/** @brief Unlinks node from the base level.
+ *
+ * Static service function.
+ *
+ * @param [in] list List.
+ * @param [in] node Node to unlink.
+ */
+static void faux_list_unlink_node(faux_list_t *list, faux_list_node_t *node)
+{
+	faux_list_drop_finger(list);
+	if (node->prev)
+		node->prev->next = node->next;
+	else
+		list->head = node->next;
+	if (node->next)
+		node->next->prev = node->prev;
+	else
+		list->tail = node->prev;
+	list->len--;
+}
+
+
+/** @brief Gets next node on specified skip list level.
+ *
+ * Static service function. The level 0 is the first level above base one.
+ *
+ * @param [in] list List.
+ * @param [in] node Node or NULL for the head of level.
+ * @param [in] level Level.
+ * @return Next node or NULL.
+ */
+static faux_list_node_t *faux_list_skip_next(const faux_list_t *list,
+	const faux_list_node_t *node, unsigned int level)
+{
+	return node ? faux_list_skip_node(node)->skip[level] :
+		list->skip->head[level];
+}
+
+
+/** @brief Finds the last node with data less (or equal) than key.
+ *
+ * Static service function. If the "equal" is BOOL_TRUE function finds the
+ * last node that is less or equal to the key. Else the last node that is
+ * strictly less than key. Optional "update" array gets the last such node
+ * for each skip list level.
+ *
+ * @param [in] list List.
+ * @param [in] cmpFn Function to compare key and node's data.
+ * @param [in] key Key to compare nodes to.
+ * @param [in] equal Is equal node suitable.
+ * @param [out] update Predecessors on each skip list level. Can be NULL.
+ * @return Found node or NULL if all nodes are greater.
+ */
+static faux_list_node_t *faux_list_skip_search(const faux_list_t *list,
+	faux_list_kcmp_fn cmpFn, const void *key, bool_t equal,
+	faux_list_node_t **update)
+{
+	faux_list_node_t *pred = NULL;
+	faux_list_node_t *next = NULL;
+	unsigned int level = list->skip->num;
+
+	while (level > 0) {
+		level--;
+		while ((next = faux_list_skip_next(list, pred, level))) {
+			int res = cmpFn(key, next->data);
+			if ((res < 0) || (!equal && (0 == res)))
+				break;
+			pred = next;
+		}
+		if (update)
+			update[level] = pred;
+	}
+
+	// Base level
+	while ((next = pred ? pred->next : list->head)) {
+		int res = cmpFn(key, next->data);
+		if ((res < 0) || (!equal && (0 == res)))
+			break;
+		pred = next;
+	}
+
+	return pred;
+}
+
+
+/** @brief Relinks upper levels of skip list by order of base level.
+ *
+ * Static service function. It's used after the base level was reordered.
+ * Nodes keep their number of levels.
+ *
+ * @param [in] list List.
+ */
+static void faux_list_skip_rebuild(faux_list_t *list)
+{
+	faux_list_node_t *last[LIST_SKIP_LEVELS] = {};
+	faux_list_node_t *iter = NULL;
+	unsigned int i = 0;
+
+	faux_bzero(list->skip->head, sizeof(list->skip->head));
+	list->skip->num = 0;
+	for (iter = list->head; iter; iter = iter->next) {
+		faux_list_skip_node_t *snode = faux_list_skip_node(iter);
+		for (i = 0; i < snode->skip_num; i++) {
+			snode->skip[i] = NULL;
+			if (last[i])
+				faux_list_skip_node(last[i])->skip[i] = iter;
+			else
+				list->skip->head[i] = iter;
+			last[i] = iter;
+		}
+		if (snode->skip_num > list->skip->num)
+			list->skip->num = snode->skip_num;
+	}
+}
+
+
+/** @brief Adds node to list with skip list index.
+ *
+ * Static service function. New node is placed after all equal nodes.
+ *
+ * @param [in] list List.
+ * @param [in] node New node.
+ * @param [in] find Return existent equal node for unique list.
+ * @return Added node, existent node or NULL.
+ */
+static faux_list_node_t *faux_list_skip_add(faux_list_t *list,
+	faux_list_node_t *node, bool_t find)
+{
+	faux_list_skip_node_t *snode = faux_list_skip_node(node);
+	faux_list_node_t *update[LIST_SKIP_LEVELS] = {};
+	faux_list_node_t *pred = NULL;
+	unsigned int i = 0;
+
+	pred = faux_list_skip_search(list, (faux_list_kcmp_fn)list->cmpFn,
+		node->data, BOOL_TRUE, update);
+	// Unique: Already exists
+	if (list->unique && pred && (list->cmpFn(node->data, pred->data) == 0)) {
+		faux_list_free_node(list, node);
+		return (find ? pred : NULL);
+	}
+
+	// Link to upper levels. Nodes above current max level have no
+	// predecessors (update[] is NULL).
+	for (i = 0; i < snode->skip_num; i++) {
+		snode->skip[i] = faux_list_skip_next(list, update[i], i);
+		if (update[i])
+			faux_list_skip_node(update[i])->skip[i] = node;
+		else
+			list->skip->head[i] = node;
+	}
+	if (snode->skip_num > list->skip->num)
+		list->skip->num = snode->skip_num;
+
+	faux_list_link_node(list, pred, node);
+
+	return node;
+}
+
+
+/** @brief Unlinks node from upper levels of skip list.
+ *
+ * Static service function.
+ *
+ * @param [in] list List.
+ * @param [in] node Node to unlink.
+ */
+static void faux_list_skip_unlink(faux_list_t *list, faux_list_node_t *node)
+{
+	faux_list_skip_node_t *snode = faux_list_skip_node(node);
+	faux_list_node_t *update[LIST_SKIP_LEVELS] = {};
+	unsigned int i = 0;
+
+	if (0 == snode->skip_num)
+		return;
+
+	// Find the last strictly less nodes. Then go through equal nodes
+	// to find exact predecessors.
+	faux_list_skip_search(list, (faux_list_kcmp_fn)list->cmpFn,
+		node->data, BOOL_FALSE, update);
+	for (i = 0; i < snode->skip_num; i++) {
+		faux_list_node_t *pred = update[i];
+		faux_list_node_t *next = NULL;
+		while ((next = faux_list_skip_next(list, pred, i)) != node)
+			pred = next;
+		if (pred)
+			faux_list_skip_node(pred)->skip[i] = snode->skip[i];
+		else
+			list->skip->head[i] = snode->skip[i];
+	}
+	while ((list->skip->num > 0) && !list->skip->head[list->skip->num - 1])
+		list->skip->num--;
+}
+
+
+/** @brief Gets hash bucket for specified hash.
+ *
+ * Static service function.
+ *
+ * @param [in] list List.
+ * @param [in] hash Hash.
+ * @return Pointer to the head of bucket.
+ */
+static faux_list_node_t **faux_list_hash_bucket(const faux_list_t *list,
+	unsigned int hash)
+{
+	return &list->hash->table[hash & (list->hash->size - 1)];
+}
+
+
+/** @brief Rebuilds hash table with new number of buckets.
+ *
+ * Static service function. The list is iterated in reverse order and nodes
+ * are placed to the bucket heads. So buckets keep list order.
+ *
+ * @param [in] list List.
+ * @param [in] size New number of buckets. Power of 2.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+static bool_t faux_list_hash_resize(faux_list_t *list, size_t size)
+{
+	faux_list_node_t **table = NULL;
+	faux_list_node_t *iter = NULL;
+
+	table = faux_zmalloc(size * sizeof(*table));
+	if (!table)
+		return BOOL_FALSE;
+	faux_free(list->hash->table);
+	list->hash->table = table;
+	list->hash->size = size;
+
+	for (iter = list->tail; iter; iter = iter->prev) {
+		faux_list_hash_node_t *hnode = faux_list_hash_node(iter);
+		faux_list_node_t **bucket = faux_list_hash_bucket(list,
+			hnode->hash);
+		hnode->hnext = *bucket;
+		*bucket = iter;
+	}
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Adds node (already linked to list tail) to hash table.
+ *
+ * Static service function. If table can't be allocated the list stays
+ * without hash table and search is linear.
+ *
+ * @param [in] list List.
+ * @param [in] node Node.
+ */
+static void faux_list_hash_add(faux_list_t *list, faux_list_node_t *node)
+{
+	faux_list_hash_node_t *hnode = faux_list_hash_node(node);
+	faux_list_node_t **bucket = NULL;
+
+	// Rebuild includes new node
+	if (list->len > list->hash->size) {
+		size_t size = list->hash->size ?
+			(list->hash->size * 2) : LIST_HASH_MIN;
+		if (faux_list_hash_resize(list, size))
+			return;
+		if (!list->hash->table)
+			return;
+	}
+
+	// Node is the last one within list so it's the last within bucket
+	hnode->hnext = NULL;
+	bucket = faux_list_hash_bucket(list, hnode->hash);
+	while (*bucket)
+		bucket = &faux_list_hash_node(*bucket)->hnext;
+	*bucket = node;
+}
+
+
+/** @brief Removes node from hash table.
+ *
+ * Static service function.
+ *
+ * @param [in] list List.
+ * @param [in] node Node.
+ */
+static void faux_list_hash_del(faux_list_t *list, faux_list_node_t *node)
+{
+	faux_list_hash_node_t *hnode = faux_list_hash_node(node);
+	faux_list_node_t **bucket = NULL;
+
+	if (!list->hash->table)
+		return;
+	bucket = faux_list_hash_bucket(list, hnode->hash);
+	while (*bucket && (*bucket != node))
+		bucket = &faux_list_hash_node(*bucket)->hnext;
+	if (*bucket)
+		*bucket = hnode->hnext;
+	hnode->hnext = NULL;
+}
+
+
+/** @brief Finds the first node equal to key within hash table.
+ *
+ * Static service function.
+ *
+ * @param [in] list List.
+ * @param [in] cmpFn Function to compare key and node's data.
+ * @param [in] key Key.
+ * @param [in] hash Hash of key.
+ * @return Found node or NULL.
+ */
+static faux_list_node_t *faux_list_hash_find(const faux_list_t *list,
+	faux_list_kcmp_fn cmpFn, const void *key, unsigned int hash)
+{
+	faux_list_node_t *iter = NULL;
+
+	iter = *faux_list_hash_bucket(list, hash);
+	for (; iter; iter = faux_list_hash_node(iter)->hnext) {
+		if ((faux_list_hash_node(iter)->hash == hash) &&
+			(cmpFn(key, iter->data) == 0))
+			return iter;
+	}
+
+	return NULL;
+}
+
+
 /** @brief Generic static function for adding new list nodes.
  *
  * @param [in] list List to add node to.
@@ -351,10 +974,34 @@ static faux_list_node_t *faux_list_add_generic(
 	if (!list || !data)
 		return NULL;
 
-	node = faux_list_new_node(data);
+	node = faux_list_new_node(list, data);
 	if (!node)
 		return NULL;
 
+	// Skip list
+	if (FAUX_LIST_SKIPLIST == list->sorted)
+		return faux_list_skip_add(list, node, find);
+
+	// Hashed list
+	if (list->hash) {
+		unsigned int hash = list->hash->hashFn(data);
+		faux_list_hash_node(node)->hash = hash;
+		if (list->unique) {
+			// Linear search if hash table can't be allocated
+			iter = list->hash->table ? faux_list_hash_find(list,
+				(faux_list_kcmp_fn)list->cmpFn, data, hash) :
+				faux_list_find_node(list,
+				(faux_list_kcmp_fn)list->cmpFn, data);
+			if (iter) { // Already in list
+				faux_list_free_node(list, node);
+				return (find ? iter : NULL);
+			}
+		}
+		faux_list_link_node(list, list->tail, node);
+		faux_list_hash_add(list, node);
+		return node;
+	}
+
 	// Empty list
 	if (!list->head) {
 		list->head = node;
@@ -371,7 +1018,7 @@ static faux_list_node_t *faux_list_add_generic(
 			while (iter) {
 				int res = list->cmpFn(node->data, iter->data);
 				if (0 == res) { // Already in list
-					faux_list_free_node(node);
+					faux_list_free_node(list, node);
 					return (find ? iter : NULL);
 				}
 				iter = iter->prev;
@@ -393,7 +1040,7 @@ static faux_list_node_t *faux_list_add_generic(
 		int res = list->cmpFn(node->data, iter->data);
 		// Unique: Already exists
 		if (list->unique && (0 == res)) {
-			faux_list_free_node(node);
+			faux_list_free_node(list, node);
 			return (find ? iter : NULL);
 		}
 		// Non-unique: Entry will be inserted after existent one
@@ -416,6 +1063,8 @@ static faux_list_node_t *faux_list_add_generic(
 	}
 	if (!node->next)
 		list->tail = node;
+	else
+		faux_list_drop_finger(list);
 	list->len++;
 
 	return node;
@@ -463,6 +1112,273 @@ faux_list_node_t *faux_list_add_find(faux_list_t *list, void *data)
 }
 
 
+/** @brief Sorts chain of nodes by merge sort.
+ *
+ * Static service function. Bottom-up merge sort for linked list. It's
+ * stable, doesn't need additional memory and costs O(n log n).
+ *
+ * @param [in] list List.
+ * @param [in] cmpFn Callback function to compare two user data instances.
+ */
+static void faux_list_msort(faux_list_t *list, faux_list_cmp_fn cmpFn)
+{
+	size_t insize = 1;
+
+	faux_list_drop_finger(list);
+
+	while (list->head) {
+		faux_list_node_t *p = list->head;
+		faux_list_node_t *tail = NULL;
+		size_t nmerges = 0;
+
+		list->head = NULL;
+		while (p) {
+			faux_list_node_t *q = p;
+			size_t psize = 0;
+			size_t qsize = insize;
+
+			// Step "insize" places along from "p"
+			nmerges++;
+			while ((psize < insize) && q) {
+				psize++;
+				q = q->next;
+			}
+
+			// Merge two runs. Equal nodes are taken from "p" first
+			while ((psize > 0) || ((qsize > 0) && q)) {
+				faux_list_node_t *e = NULL;
+				if (0 == psize) {
+					e = q;
+					q = q->next;
+					qsize--;
+				} else if ((0 == qsize) || !q ||
+					(cmpFn(p->data, q->data) <= 0)) {
+					e = p;
+					p = p->next;
+					psize--;
+				} else {
+					e = q;
+					q = q->next;
+					qsize--;
+				}
+				if (tail)
+					tail->next = e;
+				else
+					list->head = e;
+				e->prev = tail;
+				tail = e;
+			}
+			p = q;
+		}
+		tail->next = NULL;
+		list->tail = tail;
+		if (nmerges <= 1)
+			break;
+		insize *= 2;
+	}
+}
+
+
+/** @brief Sorts list.
+ *
+ * The sort is stable i.e. equal items keep their order. It costs
+ * O(n log n). The unsorted list can be sorted by any function. The sorted
+ * list can be sorted only by its own compare function so cmpFn must be
+ * NULL or the same as cmpFn given to faux_list_new().
+ *
+ * @param [in] list List.
+ * @param [in] cmpFn Callback function to compare two user data instances.
+ * NULL means list's own compare function.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_list_sort(faux_list_t *list, faux_list_cmp_fn cmpFn)
+{
+	assert(list);
+	if (!list)
+		return BOOL_FALSE;
+	if (!cmpFn)
+		cmpFn = list->cmpFn;
+	if (!cmpFn)
+		return BOOL_FALSE;
+	// Sorted list can't be reordered by foreign function
+	if (list->sorted && (cmpFn != list->cmpFn))
+		return BOOL_FALSE;
+
+	faux_list_msort(list, cmpFn);
+
+	// Rebuild indexes for new order
+	if (FAUX_LIST_SKIPLIST == list->sorted)
+		faux_list_skip_rebuild(list);
+	if (list->hash && list->hash->table &&
+		!faux_list_hash_resize(list, list->hash->size)) {
+		// Stale order of buckets. Drop table. It will be rebuilt on add
+		faux_free(list->hash->table);
+		list->hash->table = NULL;
+		list->hash->size = 0;
+	}
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Adds a lot of user data items to the list at once.
+ *
+ * For sorted list the items are appended to the tail and then the whole
+ * list is sorted once by merge sort. So adding of N items costs
+ * O(N log N) regardless of items order. The order of equal items is the
+ * same as after faux_list_add() calls for all items. For unsorted list the
+ * items are added one by one.
+ *
+ * Unlike faux_list_add() the list takes ownership of all the items. The
+ * duplicates rejected by unique list (sorted or not) are freed by freeFn
+ * callback if it's defined. The slot of each consumed item (added or freed)
+ * is set to NULL. The NULL slots are skipped. On error (memory allocation)
+ * function stops. The items that are not consumed stay within array and
+ * still belong to caller. The consumed items are within list already.
+ *
+ * @param [in] list List to add entries to.
+ * @param [in,out] data Array of user data. Consumed items are set to NULL.
+ * @param [in] num Number of items within array.
+ * @return Number of added items or < 0 on error.
+ */
+ssize_t faux_list_add_bulk(faux_list_t *list, void **data, size_t num)
+{
+	faux_list_node_t *iter = NULL;
+	size_t i = 0;
+	ssize_t added = 0;
+
+	assert(list);
+	if (!list)
+		return -1;
+	if (0 == num)
+		return 0;
+	assert(data);
+	if (!data)
+		return -1;
+
+	// Unsorted list
+	if (!list->sorted) {
+		for (i = 0; i < num; i++) {
+			size_t len = list->len;
+			if (!data[i])
+				continue;
+			// Returns existent node for duplicate or NULL on error
+			if (!faux_list_add_find(list, data[i]))
+				return -1;
+			if (list->len > len)
+				added++;
+			else if (list->freeFn) // Duplicate
+				list->freeFn(data[i]);
+			data[i] = NULL;
+		}
+		return added;
+	}
+
+	// Sorted list. Append all items then sort.
+	for (i = 0; i < num; i++) {
+		faux_list_node_t *node = NULL;
+		if (!data[i])
+			continue;
+		node = faux_list_new_node(list, data[i]);
+		if (!node)
+			break; // List must be sorted anyway
+		faux_list_link_node(list, list->tail, node);
+		data[i] = NULL;
+		added++;
+	}
+	faux_list_msort(list, list->cmpFn);
+
+	// Remove duplicates. Sort is stable so the first of equal items is
+	// either existent one or first added one.
+	if (list->unique) {
+		iter = list->head;
+		while (iter && iter->next) {
+			faux_list_node_t *next = iter->next;
+			if (list->cmpFn(next->data, iter->data) != 0) {
+				iter = next;
+				continue;
+			}
+			faux_list_unlink_node(list, next);
+			if (list->freeFn)
+				list->freeFn(next->data);
+			faux_list_free_node(list, next);
+			added--;
+		}
+	}
+
+	if (FAUX_LIST_SKIPLIST == list->sorted)
+		faux_list_skip_rebuild(list);
+
+	// Can't allocate node. Items from data[i] are not consumed.
+	if (i < num)
+		return -1;
+
+	return added;
+}
+
+
+/** @brief Merges sorted list into another sorted list.
+ *
+ * Both lists must be sorted by the same compare function. The items of
+ * "other" list are moved to the "list". It costs O(n + m). The items of
+ * "list" go before equal items of "other". For unique list the items that
+ * already exist within "list" are not moved and stay within "other" list.
+ *
+ * @param [in] list List to merge items to.
+ * @param [in] other List to take items from.
+ * @return Number of moved items or < 0 on error.
+ */
+ssize_t faux_list_merge(faux_list_t *list, faux_list_t *other)
+{
+	faux_list_node_t *iter = NULL;
+	faux_list_node_t *onode = NULL;
+	ssize_t moved = 0;
+
+	assert(list);
+	assert(other);
+	if (!list || !other)
+		return -1;
+	if (list == other)
+		return -1;
+	if (!list->sorted || !other->sorted || (list->cmpFn != other->cmpFn))
+		return -1;
+
+	iter = list->head;
+	onode = other->head;
+	while (onode) {
+		faux_list_node_t *onext = onode->next;
+		faux_list_node_t *prev = NULL;
+		faux_list_node_t *node = NULL;
+
+		// Find the first node of "list" greater than current one
+		while (iter && (list->cmpFn(onode->data, iter->data) >= 0))
+			iter = iter->next;
+		prev = iter ? iter->prev : list->tail;
+
+		// Unique: Already exists
+		if (list->unique && prev &&
+			(list->cmpFn(onode->data, prev->data) == 0)) {
+			onode = onext;
+			continue;
+		}
+
+		// Nodes belong to the slabs of their own list so create new one
+		node = faux_list_new_node(list, onode->data);
+		if (!node)
+			break;
+		faux_list_link_node(list, prev, node);
+		faux_list_takeaway(other, onode);
+		moved++;
+		onode = onext;
+	}
+
+	if (FAUX_LIST_SKIPLIST == list->sorted)
+		faux_list_skip_rebuild(list);
+
+	return moved;
+}
+
+
 /** Takes away list node from the list.
  *
  * Function removes list node from the list and returns user data
@@ -481,18 +1397,14 @@ void *faux_list_takeaway(faux_list_t *list, faux_list_node_t *node)
 	if (!list || !node)
 		return NULL;
 
-	if (node->prev)
-		node->prev->next = node->next;
-	else
-		list->head = node->next;
-	if (node->next)
-		node->next->prev = node->prev;
-	else
-		list->tail = node->prev;
-	list->len--;
+	if (FAUX_LIST_SKIPLIST == list->sorted)
+		faux_list_skip_unlink(list, node);
+	if (list->hash)
+		faux_list_hash_del(list, node);
+	faux_list_unlink_node(list, node);
 
 	data = faux_list_data(node);
-	faux_list_free_node(node);
+	faux_list_free_node(list, node);
 
 	return data;
 }
@@ -585,6 +1497,24 @@ faux_list_node_t *faux_list_match_node(const faux_list_t *list,
 	if (!iter || !matchFn || !list)
 		return NULL;
 
+	// Skip list: Jump to the first suitable node
+	if ((FAUX_LIST_SKIPLIST == list->sorted) && (matchFn == list->kcmpFn) &&
+		*iter && (*iter == list->head)) {
+		node = faux_list_skip_search(list, matchFn, userkey,
+			BOOL_FALSE, NULL);
+		*iter = node ? node->next : list->head;
+	}
+
+	// Hashed list: Get the first matching node from hash table
+	if (list->hash && list->hash->table && list->hash->khashFn &&
+		(matchFn == list->kcmpFn) &&
+		*iter && (*iter == list->head)) {
+		node = faux_list_hash_find(list, matchFn, userkey,
+			list->hash->khashFn(userkey));
+		*iter = node ? node->next : NULL;
+		return node;
+	}
+
 	while ((node = faux_list_each_node(iter))) {
 		int res = matchFn(userkey, faux_list_data(node));
 		if (0 == res)
@@ -731,18 +1661,90 @@ void *faux_list_kfind(const faux_list_t *list,
 }
 
 
+/** @brief Walks to the list node by index.
+ *
+ * Static service function. Walks from the nearest of list head, list tail
+ * and specified start node.
+ *
+ * @param [in] list List.
+ * @param [in] index Item's index. Must be less than list length.
+ * @param [in] start Additional start node. Can be NULL.
+ * @param [in] start_index Index of start node.
+ * @return List node by index.
+ */
+static faux_list_node_t *faux_list_walk(const faux_list_t *list, size_t index,
+	faux_list_node_t *start, size_t start_index)
+{
+	faux_list_node_t *iter = NULL;
+	size_t pos = 0;
+
+	// Choose the nearest start point
+	iter = list->head;
+	pos = 0;
+	if ((list->len - 1 - index) < index) {
+		iter = list->tail;
+		pos = list->len - 1;
+	}
+	if (start) {
+		size_t dist = (start_index > index) ?
+			(start_index - index) : (index - start_index);
+		size_t best = (pos > index) ? (pos - index) : (index - pos);
+		if (dist < best) {
+			iter = start;
+			pos = start_index;
+		}
+	}
+
+	while (pos < index) {
+		iter = iter->next;
+		pos++;
+	}
+	while (pos > index) {
+		iter = iter->prev;
+		pos--;
+	}
+
+	return iter;
+}
+
+
 /** @brief Gets list node by index.
  *
- * Note getting item by index is not effective operation for list.
+ * Function walks from the nearest of list head and list tail. So it costs
+ * O(n). Use faux_list_seek_node() for sequential access.
  *
  * @param [in] list List.
  * @param [in] index Item's index.
  * @return List node by index or NULL on error.
  */
 faux_list_node_t *faux_list_index_node(const faux_list_t *list, size_t index)
+{
+	assert(list);
+	if (!list)
+		return NULL;
+	if (index >= list->len)
+		return NULL;
+
+	return faux_list_walk(list, index, NULL, 0);
+}
+
+
+/** @brief Gets list node by index and remembers it.
+ *
+ * Function walks from the nearest of list head, list tail and the node got
+ * by previous seek. So sequential access (forward or backward) costs O(1).
+ * Random access is O(n). The found node is stored within list. So function
+ * changes the list and it's not thread-safe. Don't seek the list shared
+ * by several threads even if they only read it. Use faux_list_index_node()
+ * for such list.
+ *
+ * @param [in] list List.
+ * @param [in] index Item's index.
+ * @return List node by index or NULL on error.
+ */
+faux_list_node_t *faux_list_seek_node(faux_list_t *list, size_t index)
 {
 	faux_list_node_t *iter = NULL;
-	size_t i = 0;
 
 	assert(list);
 	if (!list)
@@ -750,9 +1752,15 @@ faux_list_node_t *faux_list_index_node(const faux_list_t *list, size_t index)
 	if (index >= list->len)
 		return NULL;
 
-	iter = list->head;
-	for (i = 0; i < index; i++)
-		iter = faux_list_next_node(iter);
+	// Finger is allocated on demand. Seek works without it on error.
+	if (!list->finger)
+		list->finger = faux_zmalloc(sizeof(*list->finger));
+	if (!list->finger)
+		return faux_list_walk(list, index, NULL, 0);
+	iter = faux_list_walk(list, index, list->finger->node,
+		list->finger->index);
+	list->finger->node = iter;
+	list->finger->index = index;
 
 	return iter;
 }
@@ -760,7 +1768,7 @@ faux_list_node_t *faux_list_index_node(const faux_list_t *list, size_t index)
 
 /** @brief Gets list item by index.
  *
- * Note getting item by index is not effective operation for list.
+ * See faux_list_index_node().
  *
  * @param [in] list List.
  * @param [in] index Item's index.
@@ -775,3 +1783,22 @@ void *faux_list_index(const faux_list_t *list, size_t index)
 
 	return faux_list_data(res);
 }
+
+
+/** @brief Gets list item by index and remembers its node.
+ *
+ * See faux_list_seek_node(). The function is not thread-safe.
+ *
+ * @param [in] list List.
+ * @param [in] index Item's index.
+ * @return List node's data by index or NULL on error.
+ */
+void *faux_list_seek(faux_list_t *list, size_t index)
+{
+	faux_list_node_t *res =
+		faux_list_seek_node(list, index);
+	if (!res)
+		return NULL;
+
+	return faux_list_data(res);
+}
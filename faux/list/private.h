@@ -1,4 +1,6 @@
 #include "faux/list.h"
+#include "faux/ilist.h"
+#include "faux/ulist.h"
 
 struct faux_list_node_s {
 	faux_list_node_t *prev;
@@ -6,6 +8,64 @@ struct faux_list_node_s {
 	void *data;
 };
 
+// Node of list with hash table index. The base node must be the first field.
+typedef struct faux_list_hash_node_s {
+	faux_list_node_t node;
+	unsigned int hash; // Hash of data
+	faux_list_node_t *hnext; // Next node within hash table bucket
+} faux_list_hash_node_t;
+
+// Node of list with skip list index. The size of node depends on number of
+// levels. The base node must be the first field.
+typedef struct faux_list_skip_node_s {
+	faux_list_node_t node;
+	unsigned int skip_num; // Number of skip list levels above the base one
+	faux_list_node_t *skip[]; // Next nodes on skip list levels
+} faux_list_skip_node_t;
+
+#define LIST_SKIP_LEVELS 16 // Max number of skip list levels above base one
+#define LIST_SKIP_P 4 // Node is promoted to the next level with 1/P chance
+
+#define LIST_HASH_MIN 16 // Initial number of hash table buckets
+
+#define LIST_SLAB_MIN 4 // Number of nodes within the first slab
+#define LIST_SLAB_MAX 256 // Max number of nodes within single slab
+
+// Slab is a block of list nodes allocated at once. The nodes of skip list
+// have different sizes so slab is measured in bytes.
+typedef struct faux_list_slab_s faux_list_slab_t;
+struct faux_list_slab_s {
+	faux_list_slab_t *next;
+	size_t size; // Size of slab's memory for nodes
+	size_t used; // Size of memory ever taken from slab
+	void *nodes[]; // Memory for nodes (unknown length)
+};
+
+// Skip list index. It's allocated for FAUX_LIST_SKIPLIST list only.
+typedef struct faux_list_skip_s {
+	faux_list_node_t *head[LIST_SKIP_LEVELS]; // First nodes of levels
+	unsigned int num; // Number of used skip list levels
+	unsigned int rand; // State of random generator for node levels
+	// Freelists of nodes linked by "next" field. Indexed by number of skip
+	// list levels of node.
+	faux_list_node_t *free_nodes[LIST_SKIP_LEVELS + 1];
+} faux_list_skip_t;
+
+// Hash table index. It's allocated for list created by faux_list_new_hash()
+// only.
+typedef struct faux_list_hash_s {
+	faux_list_hash_fn hashFn; // Function to get hash of list element
+	faux_list_khash_fn khashFn; // Function to get hash of key
+	faux_list_node_t **table; // Buckets. Nodes are in list order
+	size_t size; // Number of buckets. Power of 2
+} faux_list_hash_t;
+
+// Finger. It's allocated by the first faux_list_seek_node().
+typedef struct faux_list_finger_s {
+	faux_list_node_t *node; // Node got by the last seek or NULL
+	size_t index; // Index of finger node
+} faux_list_finger_t;
+
 struct faux_list_s {
 	faux_list_node_t *head;
 	faux_list_node_t *tail;
@@ -15,4 +75,41 @@ struct faux_list_s {
 	faux_list_kcmp_fn kcmpFn; // Function to compare key and list element
 	faux_list_free_fn freeFn; // Function to properly free data field
 	size_t len;
+	faux_list_slab_t *slabs; // Allocated slabs. The newest is the first
+	faux_list_node_t *free_nodes; // Freelist of nodes linked by "next" field
+	faux_list_skip_t *skip; // Skip list index or NULL
+	faux_list_hash_t *hash; // Hash table index or NULL
+	faux_list_finger_t *finger; // Finger or NULL
+};
+
+struct faux_ilist_s {
+	faux_ilist_node_t *head;
+	faux_ilist_node_t *tail;
+	faux_list_sorted_e sorted;
+	faux_list_unique_e unique;
+	size_t offset; // Offset of list node within user structure
+	faux_list_cmp_fn cmpFn; // Function to compare two list elements
+	faux_list_kcmp_fn kcmpFn; // Function to compare key and list element
+	faux_list_free_fn freeFn; // Function to properly free data field
+	size_t len;
+};
+
+#define ULIST_CHUNK_ITEMS 16 // Number of items within unrolled list chunk
+
+struct faux_ulist_chunk_s {
+	faux_ulist_chunk_t *prev;
+	faux_ulist_chunk_t *next;
+	unsigned int num; // Number of used items
+	void *data[ULIST_CHUNK_ITEMS];
+};
+
+struct faux_ulist_s {
+	faux_ulist_chunk_t *head;
+	faux_ulist_chunk_t *tail;
+	faux_list_sorted_e sorted;
+	faux_list_unique_e unique;
+	faux_list_cmp_fn cmpFn; // Function to compare two list elements
+	faux_list_kcmp_fn kcmpFn; // Function to compare key and list element
+	faux_list_free_fn freeFn; // Function to properly free data field
+	size_t len;
 };
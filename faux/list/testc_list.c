@@ -0,0 +1,809 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "faux/list.h"
+#include "faux/ilist.h"
+#include "faux/ulist.h"
+#include "faux/time.h"
+
+#include "private.h"
+
+static int list_cmp(const void *new_item, const void *list_item)
+{
+	int f = *(const int *)new_item;
+	int s = *(const int *)list_item;
+
+	return (f > s) - (f < s);
+}
+
+
+static int list_kcmp(const void *key, const void *list_item)
+{
+	return list_cmp(key, list_item);
+}
+
+
+static unsigned int freed = 0;
+
+static void list_free(void *list_item)
+{
+	freed++;
+	list_item = list_item; // Happy compiler
+}
+
+
+#define LIST_LEN 1000
+int testc_faux_list_slab(void)
+{
+	int items[LIST_LEN] = {};
+	unsigned int i = 0;
+	int ret = -1; // Pessimistic return value
+	faux_list_t *list = NULL;
+	faux_list_node_t *iter = NULL;
+	int *item = NULL;
+
+	// Plain list header doesn't contain state of skip list or hash table
+	if (sizeof(faux_list_t) > (16 * sizeof(void *))) {
+		fprintf(stderr, "Too big list header: %zu\n", sizeof(faux_list_t));
+		goto err;
+	}
+
+	list = faux_list_new(FAUX_LIST_SORTED, FAUX_LIST_UNIQUE,
+		list_cmp, list_kcmp, list_free);
+	if (list->skip || list->hash || list->finger) {
+		fprintf(stderr, "Plain list has side indexes\n");
+		goto err;
+	}
+	for (i = 0; i < LIST_LEN; i++) {
+		items[i] = LIST_LEN - 1 - i;
+		faux_list_add(list, &items[i]);
+	}
+
+	// Duplicate is not added. Its node is returned to freelist.
+	if (faux_list_add(list, &items[0])) {
+		fprintf(stderr, "Duplicate is added to unique list\n");
+		goto err;
+	}
+
+	// Delete odd items and add them again. Freed nodes are reused.
+	iter = faux_list_head(list);
+	while ((item = faux_list_each(&iter))) {
+		if (*item % 2)
+			faux_list_kdel(list, item);
+	}
+	if ((faux_list_len(list) != (LIST_LEN / 2)) || (freed != LIST_LEN / 2)) {
+		fprintf(stderr, "Broken deletion\n");
+		goto err;
+	}
+	for (i = 0; i < LIST_LEN; i++) {
+		if (items[i] % 2)
+			faux_list_add(list, &items[i]);
+	}
+	i = 0;
+	iter = faux_list_head(list);
+	while ((item = faux_list_each(&iter))) {
+		if (*item != (int)i) {
+			fprintf(stderr, "Broken order of items\n");
+			goto err;
+		}
+		i++;
+	}
+	if (i != LIST_LEN) {
+		fprintf(stderr, "Broken number of items\n");
+		goto err;
+	}
+
+	// Delete all. User data is freed for each item.
+	freed = 0;
+	if ((faux_list_del_all(list) != LIST_LEN) || (freed != LIST_LEN) ||
+		!faux_list_is_empty(list) || faux_list_head(list)) {
+		fprintf(stderr, "Broken deletion of all items\n");
+		goto err;
+	}
+
+	// List is usable after deletion of all items
+	faux_list_add(list, &items[0]);
+	if (faux_list_kfind(list, &items[0]) != &items[0]) {
+		fprintf(stderr, "Broken list after deletion of all items\n");
+		goto err;
+	}
+
+	ret = 0;
+err:
+	faux_list_free(list);
+
+	return ret;
+}
+
+
+typedef struct {
+	int key;
+	faux_ilist_node_t node;
+} ilist_item_t;
+
+
+int testc_faux_ilist(void)
+{
+	ilist_item_t items[LIST_LEN] = {};
+	ilist_item_t dup = {};
+	unsigned int i = 0;
+	int key = 0;
+	int ret = -1; // Pessimistic return value
+	faux_ilist_t *list = NULL;
+	faux_ilist_node_t *iter = NULL;
+	ilist_item_t *item = NULL;
+
+	freed = 0;
+	list = faux_ilist_new(FAUX_LIST_SORTED, FAUX_LIST_UNIQUE,
+		offsetof(ilist_item_t, node), list_cmp, list_kcmp, list_free);
+	for (i = 0; i < LIST_LEN; i++) {
+		items[i].key = LIST_LEN - 1 - i;
+		faux_ilist_add(list, &items[i]);
+	}
+
+	// Duplicate is not added. Existent entry is found.
+	dup.key = 0;
+	if (faux_ilist_add(list, &dup) ||
+		(faux_ilist_add_find(list, &dup) != &items[LIST_LEN - 1].node)) {
+		fprintf(stderr, "Broken unique list\n");
+		goto err;
+	}
+
+	// Sorted order. Node is embedded into user structure.
+	i = 0;
+	iter = faux_ilist_head(list);
+	while ((item = faux_ilist_each(list, &iter))) {
+		if ((item->key != (int)i) ||
+			(faux_ilist_entry(&item->node, ilist_item_t, node) != item)) {
+			fprintf(stderr, "Broken order of items\n");
+			goto err;
+		}
+		i++;
+	}
+	if (i != LIST_LEN) {
+		fprintf(stderr, "Broken number of items\n");
+		goto err;
+	}
+
+	// Find and delete
+	key = 10;
+	item = faux_ilist_kfind(list, &key);
+	if (!item || (item->key != key)) {
+		fprintf(stderr, "Can't find item\n");
+		goto err;
+	}
+	if (!faux_ilist_kdel(list, &key) || faux_ilist_kfind(list, &key) ||
+		(freed != 1) || (faux_ilist_len(list) != (LIST_LEN - 1))) {
+		fprintf(stderr, "Broken deletion\n");
+		goto err;
+	}
+
+	// Item can be added again after deletion
+	faux_ilist_add(list, item);
+	if (faux_ilist_kfind(list, &key) != item) {
+		fprintf(stderr, "Can't add deleted item\n");
+		goto err;
+	}
+
+	ret = 0;
+err:
+	faux_ilist_free(list);
+
+	return ret;
+}
+
+
+typedef struct {
+	int key;
+	unsigned int seq; // Order of adding
+} skip_item_t;
+
+
+#define SKIP_LEN 5000
+#define SKIP_KEYS 1000
+int testc_faux_list_skiplist(void)
+{
+	skip_item_t *items = NULL;
+	unsigned int i = 0;
+	unsigned int n = 0;
+	int key = 0;
+	int ret = -1; // Pessimistic return value
+	faux_list_t *list = NULL;
+	faux_list_node_t *iter = NULL;
+	skip_item_t *item = NULL;
+	skip_item_t *prev = NULL;
+
+	items = calloc(SKIP_LEN, sizeof(*items));
+	list = faux_list_new(FAUX_LIST_SKIPLIST, FAUX_LIST_NONUNIQUE,
+		list_cmp, list_kcmp, NULL);
+	srand(1);
+	for (i = 0; i < SKIP_LEN; i++) {
+		items[i].key = rand() % SKIP_KEYS;
+		items[i].seq = i;
+		faux_list_add(list, &items[i]);
+	}
+
+	// Delete some items
+	for (i = 0; i < SKIP_LEN; i += 3) {
+		key = items[i].key;
+		if (!faux_list_kdel(list, &key)) {
+			fprintf(stderr, "Can't delete item\n");
+			goto err;
+		}
+	}
+
+	// Move some items to the end of equal ones. The freed nodes with
+	// their skip list levels are reused.
+	for (i = 0; i < SKIP_KEYS; i += 7) {
+		key = i;
+		iter = faux_list_kfind_node(list, &key);
+		if (!iter)
+			continue;
+		item = faux_list_takeaway(list, iter);
+		item->seq = SKIP_LEN + i;
+		faux_list_add(list, item);
+	}
+	item = NULL;
+
+	// Sorted order. Equal items keep order of adding.
+	iter = faux_list_head(list);
+	while ((item = faux_list_each(&iter))) {
+		if (prev && ((prev->key > item->key) ||
+			((prev->key == item->key) && (prev->seq > item->seq)))) {
+			fprintf(stderr, "Broken order of items\n");
+			goto err;
+		}
+		prev = item;
+		n++;
+	}
+	if (n != faux_list_len(list)) {
+		fprintf(stderr, "Broken number of items\n");
+		goto err;
+	}
+
+	// Search gets the first of equal items. Match iterates all of them.
+	for (key = 0; key < SKIP_KEYS; key++) {
+		unsigned int num = 0;
+		unsigned int found = 0;
+		skip_item_t *first = faux_list_kfind(list, &key);
+		iter = faux_list_head(list);
+		while ((item = faux_list_each(&iter))) {
+			if (item->key != key)
+				continue;
+			if (0 == num && (item != first)) {
+				fprintf(stderr, "Broken search of %d\n", key);
+				goto err;
+			}
+			num++;
+		}
+		iter = faux_list_head(list);
+		while ((item = faux_list_kmatch(list, &key, &iter)))
+			found++;
+		if ((num != found) || (!num && first)) {
+			fprintf(stderr, "Broken match of %d\n", key);
+			goto err;
+		}
+	}
+
+	ret = 0;
+err:
+	faux_list_free(list);
+	free(items);
+
+	return ret;
+}
+
+
+static int list_match(const void *key, const void *list_item)
+{
+	return list_kcmp(key, list_item);
+}
+
+
+static size_t list_hash(const void *list_item)
+{
+	return *(const int *)list_item;
+}
+
+
+static size_t list_khash(const void *key)
+{
+	return *(const int *)key;
+}
+
+
+#define HASH_LEN 10000
+#define HASH_KEYS 3000
+int testc_faux_list_hash(void)
+{
+	int *items = NULL;
+	unsigned int i = 0;
+	unsigned int n = 0;
+	int key = 0;
+	int ret = -1; // Pessimistic return value
+	faux_list_t *list = NULL;
+	faux_list_node_t *iter = NULL;
+	int *item = NULL;
+
+	// Hash fields are within enlarged node only. Plain list doesn't pay.
+	if (sizeof(faux_list_node_t) != (3 * sizeof(void *))) {
+		fprintf(stderr, "Base list node is enlarged\n");
+		return -1;
+	}
+
+	items = calloc(HASH_LEN, sizeof(*items));
+	list = faux_list_new_hash(FAUX_LIST_UNIQUE, list_cmp, list_kcmp,
+		list_hash, list_khash, NULL);
+	srand(1);
+	for (i = 0; i < HASH_LEN; i++) {
+		items[i] = rand() % HASH_KEYS;
+		if (faux_list_add(list, &items[i]))
+			n++;
+	}
+
+	// Unique items keep order of adding
+	if (faux_list_len(list) != n) {
+		fprintf(stderr, "Broken number of items\n");
+		goto err;
+	}
+	i = 0;
+	iter = faux_list_head(list);
+	while ((item = faux_list_each(&iter))) {
+		while (items[i] != *item) // Skip duplicates
+			i++;
+		if (&items[i] != item) {
+			fprintf(stderr, "Broken order of items\n");
+			goto err;
+		}
+		i++;
+	}
+
+	// Delete half of keys then search for all keys
+	for (key = 0; key < HASH_KEYS; key += 2)
+		faux_list_kdel(list, &key);
+	for (key = 0; key < HASH_KEYS; key++) {
+		item = faux_list_kfind(list, &key);
+		if ((key % 2) == 0) {
+			if (item) {
+				fprintf(stderr, "Found deleted item %d\n", key);
+				goto err;
+			}
+			continue;
+		}
+		// Linear search by another function
+		if (item != faux_list_find(list, list_match, &key)) {
+			fprintf(stderr, "Broken search of %d\n", key);
+			goto err;
+		}
+	}
+
+	ret = 0;
+err:
+	faux_list_free(list);
+	free(items);
+
+	return ret;
+}
+
+
+#define BULK_LEN 10000
+#define BULK_KEYS 5000
+int testc_faux_list_bulk(void)
+{
+	skip_item_t *items = NULL;
+	void **data = NULL;
+	unsigned int i = 0;
+	unsigned int n = 0;
+	int ret = -1; // Pessimistic return value
+	faux_list_t *list = NULL;
+	faux_list_t *other = NULL;
+	faux_list_node_t *iter = NULL;
+	skip_item_t *item = NULL;
+	skip_item_t *prev = NULL;
+
+	items = calloc(BULK_LEN, sizeof(*items));
+	data = calloc(BULK_LEN, sizeof(*data));
+	srand(1);
+	for (i = 0; i < BULK_LEN; i++) {
+		items[i].key = rand() % BULK_KEYS;
+		items[i].seq = i;
+		data[i] = &items[i];
+	}
+
+	// Bulk add the first half in reverse order then merge the second one
+	list = faux_list_new(FAUX_LIST_SKIPLIST, FAUX_LIST_NONUNIQUE,
+		list_cmp, list_kcmp, NULL);
+	other = faux_list_new(FAUX_LIST_SORTED, FAUX_LIST_NONUNIQUE,
+		list_cmp, list_kcmp, NULL);
+	for (i = 0; i < (BULK_LEN / 2); i++)
+		data[i] = &items[BULK_LEN / 2 - 1 - i];
+	if (faux_list_add_bulk(list, data, BULK_LEN / 2) != (BULK_LEN / 2)) {
+		fprintf(stderr, "Broken bulk add\n");
+		goto err;
+	}
+	if ((faux_list_add_bulk(other, data + BULK_LEN / 2, BULK_LEN / 2) !=
+		(BULK_LEN / 2)) ||
+		(faux_list_merge(list, other) != (BULK_LEN / 2)) ||
+		!faux_list_is_empty(other)) {
+		fprintf(stderr, "Broken merge\n");
+		goto err;
+	}
+
+	// Sorted order. Equal items of "list" go before items of "other".
+	// Equal items keep order of adding. Note the first half was added
+	// in reverse order.
+	iter = faux_list_head(list);
+	while ((item = faux_list_each(&iter))) {
+		if (prev && (prev->key > item->key)) {
+			fprintf(stderr, "Broken order of items\n");
+			goto err;
+		}
+		if (prev && (prev->key == item->key)) {
+			bool_t pfirst = (prev->seq < (BULK_LEN / 2));
+			bool_t ifirst = (item->seq < (BULK_LEN / 2));
+			if ((!pfirst && ifirst) ||
+				(pfirst && ifirst && (prev->seq < item->seq)) ||
+				(!pfirst && !ifirst && (prev->seq > item->seq))) {
+				fprintf(stderr, "Broken stable order\n");
+				goto err;
+			}
+		}
+		prev = item;
+		n++;
+	}
+	if ((n != BULK_LEN) || (faux_list_len(list) != BULK_LEN)) {
+		fprintf(stderr, "Broken number of items\n");
+		goto err;
+	}
+	// Skip list index is rebuilt
+	for (i = 0; i < BULK_LEN; i += 7) {
+		item = faux_list_kfind(list, &items[i].key);
+		if (!item || (item->key != items[i].key)) {
+			fprintf(stderr, "Broken search after merge\n");
+			goto err;
+		}
+	}
+
+	// Unique list frees duplicates. All the items are consumed.
+	faux_list_free(other);
+	other = faux_list_new(FAUX_LIST_SORTED, FAUX_LIST_UNIQUE,
+		list_cmp, list_kcmp, list_free);
+	for (i = 0; i < BULK_LEN; i++)
+		data[i] = &items[i];
+	freed = 0;
+	n = faux_list_add_bulk(other, data, BULK_LEN);
+	if ((n != faux_list_len(other)) || ((n + freed) != BULK_LEN)) {
+		fprintf(stderr, "Broken bulk add to unique list\n");
+		goto err;
+	}
+	for (i = 0; i < BULK_LEN; i++) {
+		if (data[i]) {
+			fprintf(stderr, "Item is not consumed by bulk add\n");
+			goto err;
+		}
+	}
+	prev = NULL;
+	iter = faux_list_head(other);
+	while ((item = faux_list_each(&iter))) {
+		if (prev && (prev->key >= item->key)) {
+			fprintf(stderr, "Duplicates within unique list\n");
+			goto err;
+		}
+		prev = item;
+	}
+
+	// Unsorted unique list has the same ownership rules
+	faux_list_free(list);
+	list = faux_list_new(FAUX_LIST_UNSORTED, FAUX_LIST_UNIQUE,
+		list_cmp, list_kcmp, list_free);
+	for (i = 0; i < BULK_LEN; i++)
+		data[i] = &items[i];
+	freed = 0;
+	if ((faux_list_add_bulk(list, data, BULK_LEN) != (ssize_t)n) ||
+		(faux_list_len(list) != n) || ((n + freed) != BULK_LEN)) {
+		fprintf(stderr, "Broken bulk add to unsorted unique list\n");
+		goto err;
+	}
+	for (i = 0; i < BULK_LEN; i++) {
+		if (data[i]) {
+			fprintf(stderr, "Item is not consumed by bulk add\n");
+			goto err;
+		}
+	}
+
+	// Sort unsorted list by custom function
+	faux_list_free(list);
+	list = faux_list_new(FAUX_LIST_UNSORTED, FAUX_LIST_NONUNIQUE,
+		NULL, NULL, NULL);
+	for (i = 0; i < BULK_LEN; i++)
+		data[i] = &items[i];
+	faux_list_add_bulk(list, data, BULK_LEN);
+	if (!faux_list_sort(list, list_cmp)) {
+		fprintf(stderr, "Can't sort list\n");
+		goto err;
+	}
+	prev = NULL;
+	iter = faux_list_head(list);
+	while ((item = faux_list_each(&iter))) {
+		if (prev && ((prev->key > item->key) ||
+			((prev->key == item->key) && (prev->seq > item->seq)))) {
+			fprintf(stderr, "Broken sort\n");
+			goto err;
+		}
+		prev = item;
+	}
+	if (faux_list_tail(list) != faux_list_index_node(list, BULK_LEN - 1)) {
+		fprintf(stderr, "Broken tail after sort\n");
+		goto err;
+	}
+
+	ret = 0;
+err:
+	faux_list_free(list);
+	faux_list_free(other);
+	free(data);
+	free(items);
+
+	return ret;
+}
+
+
+#define INDEX_LEN 1000
+int testc_faux_list_index(void)
+{
+	int items[INDEX_LEN] = {};
+	unsigned int i = 0;
+	int ret = -1; // Pessimistic return value
+	faux_list_t *list = NULL;
+	int *item = NULL;
+
+	list = faux_list_new(FAUX_LIST_SORTED, FAUX_LIST_NONUNIQUE,
+		list_cmp, list_kcmp, NULL);
+	for (i = 0; i < INDEX_LEN; i += 2) {
+		items[i] = i;
+		faux_list_add(list, &items[i]);
+	}
+
+	// Forward, backward and random access
+	for (i = 0; i < (INDEX_LEN / 2); i++) {
+		item = faux_list_seek(list, i);
+		if (!item || (*item != (int)(i * 2))) {
+			fprintf(stderr, "Broken forward access\n");
+			goto err;
+		}
+	}
+	for (i = (INDEX_LEN / 2); i > 0; i--) {
+		item = faux_list_seek(list, i - 1);
+		if (!item || (*item != (int)((i - 1) * 2))) {
+			fprintf(stderr, "Broken backward access\n");
+			goto err;
+		}
+	}
+	if (faux_list_seek(list, INDEX_LEN / 2)) {
+		fprintf(stderr, "Broken out-of-range access\n");
+		goto err;
+	}
+	// Const access doesn't use finger
+	for (i = 0; i < (INDEX_LEN / 2); i += 7) {
+		item = faux_list_index(list, i);
+		if (!item || (*item != (int)(i * 2))) {
+			fprintf(stderr, "Broken const access\n");
+			goto err;
+		}
+	}
+
+	// Insertion before cached node changes indexes
+	faux_list_seek(list, 100);
+	items[1] = 1;
+	faux_list_add(list, &items[1]);
+	item = faux_list_seek(list, 100);
+	if (!item || (*item != 198)) {
+		fprintf(stderr, "Broken access after insertion\n");
+		goto err;
+	}
+	faux_list_kdel(list, &items[1]);
+	item = faux_list_seek(list, 100);
+	if (!item || (*item != 200)) {
+		fprintf(stderr, "Broken access after deletion\n");
+		goto err;
+	}
+
+	ret = 0;
+err:
+	faux_list_free(list);
+
+	return ret;
+}
+
+
+#define ULIST_LEN 1000
+int testc_faux_ulist(void)
+{
+	int items[ULIST_LEN] = {};
+	unsigned int i = 0;
+	unsigned int n = 0;
+	int key = 0;
+	int ret = -1; // Pessimistic return value
+	faux_ulist_t *list = NULL;
+	faux_ulist_iter_t iter = {};
+	int *item = NULL;
+	int *prev = NULL;
+
+	freed = 0;
+	list = faux_ulist_new(FAUX_LIST_SORTED, FAUX_LIST_UNIQUE,
+		list_cmp, list_kcmp, list_free);
+	srand(1);
+	for (i = 0; i < ULIST_LEN; i++) {
+		items[i] = rand() % (ULIST_LEN / 2);
+		if (faux_ulist_add(list, &items[i]))
+			n++;
+	}
+	if (faux_ulist_len(list) != n) {
+		fprintf(stderr, "Broken number of items\n");
+		goto err;
+	}
+
+	// Sorted unique order. Forward and reverse.
+	i = 0;
+	faux_ulist_head(list, &iter);
+	while ((item = faux_ulist_each(&iter))) {
+		if ((prev && (*prev >= *item)) ||
+			(faux_ulist_index(list, i) != item)) {
+			fprintf(stderr, "Broken order of items\n");
+			goto err;
+		}
+		prev = item;
+		i++;
+	}
+	faux_ulist_tail(list, &iter);
+	while ((item = faux_ulist_eachr(&iter))) {
+		i--;
+		if (faux_ulist_index(list, i) != item) {
+			fprintf(stderr, "Broken reverse order of items\n");
+			goto err;
+		}
+	}
+	if (i != 0) {
+		fprintf(stderr, "Broken number of iterated items\n");
+		goto err;
+	}
+
+	// Find and delete
+	for (key = 0; key < (ULIST_LEN / 2); key += 2) {
+		item = faux_ulist_kfind(list, &key);
+		if (item && (*item != key)) {
+			fprintf(stderr, "Broken search\n");
+			goto err;
+		}
+		if (item && !faux_ulist_kdel(list, &key)) {
+			fprintf(stderr, "Broken deletion\n");
+			goto err;
+		}
+		if (faux_ulist_kfind(list, &key)) {
+			fprintf(stderr, "Found deleted item\n");
+			goto err;
+		}
+	}
+	if ((faux_ulist_len(list) + freed) != n) {
+		fprintf(stderr, "Broken number of items after deletion\n");
+		goto err;
+	}
+
+	ret = 0;
+err:
+	faux_ulist_free(list);
+
+	return ret;
+}
+
+
+// Number of list items visited by each benchmark step
+#define BENCH_OPS 10000000
+
+static uint64_t bench_time(const struct timespec *start)
+{
+	struct timespec now = {};
+	struct timespec diff = {};
+
+	faux_timespec_now_monotonic(&now);
+	faux_timespec_diff(&diff, &now, start);
+
+	return faux_timespec_to_nsec(&diff);
+}
+
+
+static void bench_print(const char *name, size_t len, const char *op,
+	size_t items, uint64_t nsec)
+{
+	if (0 == nsec)
+		nsec = 1;
+	fprintf(stderr, "%-6s %8zu items %-5s %8.2f Mitems/s\n", name, len, op,
+		(double)items * 1000.0 / (double)nsec);
+}
+
+
+// Compares iteration and find throughput of list and unrolled list. The
+// benchmark always succeeds. Use "testc -d" to see results.
+int testc_faux_ulist_bench(void)
+{
+	const size_t lens[] = { 1000, 100000, 1000000 };
+	unsigned int l = 0;
+	int *items = NULL;
+	int ret = -1; // Pessimistic return value
+
+	items = calloc(lens[2], sizeof(*items));
+	if (!items)
+		goto err;
+
+	for (l = 0; l < (sizeof(lens) / sizeof(lens[0])); l++) {
+		size_t len = lens[l];
+		size_t passes = BENCH_OPS / len;
+		size_t i = 0;
+		size_t p = 0;
+		int key = -1; // Not found. Full scan.
+		size_t sum = 0;
+		struct timespec start = {};
+		faux_list_t *list = NULL;
+		faux_ulist_t *ulist = NULL;
+		faux_list_node_t *iter = NULL;
+		faux_ulist_iter_t uiter = {};
+		int *item = NULL;
+
+		list = faux_list_new(FAUX_LIST_UNSORTED, FAUX_LIST_NONUNIQUE,
+			NULL, list_kcmp, NULL);
+		ulist = faux_ulist_new(FAUX_LIST_UNSORTED, FAUX_LIST_NONUNIQUE,
+			NULL, list_kcmp, NULL);
+		for (i = 0; i < len; i++) {
+			items[i] = i;
+			faux_list_add(list, &items[i]);
+			faux_ulist_add(ulist, &items[i]);
+		}
+
+		// Iteration
+		faux_timespec_now_monotonic(&start);
+		for (p = 0; p < passes; p++) {
+			iter = faux_list_head(list);
+			while ((item = faux_list_each(&iter)))
+				sum += *item;
+		}
+		bench_print("list", len, "each", passes * len,
+			bench_time(&start));
+		faux_timespec_now_monotonic(&start);
+		for (p = 0; p < passes; p++) {
+			faux_ulist_head(ulist, &uiter);
+			while ((item = faux_ulist_each(&uiter)))
+				sum += *item;
+		}
+		bench_print("ulist", len, "each", passes * len,
+			bench_time(&start));
+
+		// Find
+		faux_timespec_now_monotonic(&start);
+		for (p = 0; p < passes; p++) {
+			if (faux_list_kfind(list, &key))
+				sum++;
+		}
+		bench_print("list", len, "find", passes * len,
+			bench_time(&start));
+		faux_timespec_now_monotonic(&start);
+		for (p = 0; p < passes; p++) {
+			if (faux_ulist_kfind(ulist, &key))
+				sum++;
+		}
+		bench_print("ulist", len, "find", passes * len,
+			bench_time(&start));
+
+		faux_list_free(list);
+		faux_ulist_free(ulist);
+		if (0 == sum) // Use result to prevent optimization
+			fprintf(stderr, "Empty lists\n");
+	}
+
+	ret = 0;
+err:
+	free(items);
+
+	return ret;
+}
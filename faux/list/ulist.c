@@ -0,0 +1,612 @@
+/** @file ulist.c
+ * @brief Implementation of an unrolled list.
+ *
+ * Unrolled list stores pointers to user data within chunks. Each chunk
+ * holds up to ULIST_CHUNK_ITEMS pointers in array. Chunks are linked to
+ * each other like nodes of faux_list_t. So iteration reads adjacent memory
+ * and follows a link once per chunk but not once per item.
+ *
+ * The list has the same sorted/unique semantics and callback functions as
+ * faux_list_t. Full chunk is split in half on insertion. Empty chunk is
+ * freed. Search within sorted list skips whole chunks when key is greater
+ * than the last item of chunk.
+ *
+ * The iterator is a position (chunk and index within chunk) but not a
+ * pointer to node. Any list change invalidates iterators.
+ */
+
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+#include "private.h"
+#include "faux/ulist.h"
+
+
+/** @brief Allocate and initialize unrolled list.
+ *
+ * @sa faux_list_new()
+ * @param [in] sorted If list is sorted - FAUX_LIST_SORTED, unsorted - FAUX_LIST_UNSORTED.
+ * @param [in] unique If list entry is unique - FAUX_LIST_UNIQUE, else - FAUX_LIST_NONUNIQUE.
+ * @param [in] cmpFn Callback function to compare two user data instances
+ * to sort list.
+ * @param [in] kcmpFn Callback function to compare key and user data.
+ * @param [in] freeFn Callback function to free user data.
+ * @return Newly created unrolled list or NULL on error.
+ */
+faux_ulist_t *faux_ulist_new(faux_list_sorted_e sorted,
+	faux_list_unique_e unique,
+	faux_list_cmp_fn cmpFn, faux_list_kcmp_fn kcmpFn,
+	faux_list_free_fn freeFn)
+{
+	faux_ulist_t *list = NULL;
+
+	// Sorted list must have cmpFn
+	if (sorted && !cmpFn)
+		return NULL;
+
+	// Unique list must have cmpFn
+	if (unique && !cmpFn)
+		return NULL;
+
+	list = faux_zmalloc(sizeof(*list));
+	assert(list);
+	if (!list)
+		return NULL;
+
+	// Initialize
+	list->head = NULL;
+	list->tail = NULL;
+	list->sorted = sorted;
+	list->unique = unique;
+	list->cmpFn = cmpFn;
+	list->kcmpFn = kcmpFn;
+	list->freeFn = freeFn;
+	list->len = 0;
+
+	return list;
+}
+
+
+/** @brief Free unrolled list.
+ *
+ * Frees all chunks and user data (by freeFn) and then the list itself.
+ *
+ * @param [in] list List to free.
+ */
+void faux_ulist_free(faux_ulist_t *list)
+{
+	faux_ulist_del_all(list);
+	faux_free(list);
+}
+
+
+/** @brief Gets current length of list.
+ *
+ * @param [in] list List.
+ * @return Current length of list.
+ */
+size_t faux_ulist_len(const faux_ulist_t *list)
+{
+	assert(list);
+	if (!list)
+		return 0;
+
+	return list->len;
+}
+
+
+/** @brief Checks is list empty.
+ *
+ * @param [in] list Allocated list.
+ * @return BOOL_TRUE - empty, BOOL_FALSE - not empty.
+ */
+bool_t faux_ulist_is_empty(const faux_ulist_t *list)
+{
+	assert(list);
+	if (!list)
+		return BOOL_TRUE;
+
+	if (faux_ulist_len(list) == 0)
+		return BOOL_TRUE;
+
+	return BOOL_FALSE;
+}
+
+
+/** @brief Initializes iterator by the first item of list.
+ *
+ * @param [in] list List.
+ * @param [out] iter Iterator to initialize.
+ */
+void faux_ulist_head(const faux_ulist_t *list, faux_ulist_iter_t *iter)
+{
+	assert(list);
+	assert(iter);
+	if (!list || !iter)
+		return;
+
+	iter->chunk = list->head;
+	iter->pos = 0;
+}
+
+
+/** @brief Initializes iterator by the last item of list.
+ *
+ * @param [in] list List.
+ * @param [out] iter Iterator to initialize.
+ */
+void faux_ulist_tail(const faux_ulist_t *list, faux_ulist_iter_t *iter)
+{
+	assert(list);
+	assert(iter);
+	if (!list || !iter)
+		return;
+
+	iter->chunk = list->tail;
+	iter->pos = list->tail ? (list->tail->num - 1) : 0;
+}
+
+
+/** @brief Iterate through each list item.
+ *
+ * On each call to this function the iterator will change its value.
+ * Before function using the iterator must be initialised by
+ * faux_ulist_head().
+ *
+ * @param [in,out] iter Iterator.
+ * @return User data or NULL if list elements are over.
+ */
+void *faux_ulist_each(faux_ulist_iter_t *iter)
+{
+	void *data = NULL;
+
+	// No assert() on iter->chunk. NULL iterator is normal
+	if (!iter || !iter->chunk)
+		return NULL;
+
+	data = iter->chunk->data[iter->pos];
+	iter->pos++;
+	if (iter->pos >= iter->chunk->num) {
+		iter->chunk = iter->chunk->next;
+		iter->pos = 0;
+	}
+
+	return data;
+}
+
+
+/** @brief Iterate through each list item. Reverse order.
+ *
+ * On each call to this function the iterator will change its value.
+ * Before function using the iterator must be initialised by
+ * faux_ulist_tail().
+ *
+ * @param [in,out] iter Iterator.
+ * @return User data or NULL if list elements are over.
+ */
+void *faux_ulist_eachr(faux_ulist_iter_t *iter)
+{
+	void *data = NULL;
+
+	// No assert() on iter->chunk. NULL iterator is normal
+	if (!iter || !iter->chunk)
+		return NULL;
+
+	data = iter->chunk->data[iter->pos];
+	if (iter->pos > 0) {
+		iter->pos--;
+	} else {
+		iter->chunk = iter->chunk->prev;
+		iter->pos = iter->chunk ? (iter->chunk->num - 1) : 0;
+	}
+
+	return data;
+}
+
+
+/** @brief Allocates new chunk and links it after specified one.
+ *
+ * Static service function.
+ *
+ * @param [in] list List.
+ * @param [in] prev Chunk to link after or NULL to link into the head.
+ * @return New chunk or NULL on error.
+ */
+static faux_ulist_chunk_t *faux_ulist_new_chunk(faux_ulist_t *list,
+	faux_ulist_chunk_t *prev)
+{
+	faux_ulist_chunk_t *chunk = NULL;
+
+	chunk = faux_zmalloc(sizeof(*chunk));
+	assert(chunk);
+	if (!chunk)
+		return NULL;
+
+	chunk->num = 0;
+	chunk->prev = prev;
+	chunk->next = prev ? prev->next : list->head;
+	if (chunk->next)
+		chunk->next->prev = chunk;
+	else
+		list->tail = chunk;
+	if (prev)
+		prev->next = chunk;
+	else
+		list->head = chunk;
+
+	return chunk;
+}
+
+
+/** @brief Inserts user data to the chunk at specified position.
+ *
+ * Static service function. Full chunk is split in half. But if new item
+ * is added to the end of full chunk then new chunk is created for it.
+ *
+ * @param [in] list List.
+ * @param [in] chunk Chunk.
+ * @param [in] pos Position within chunk.
+ * @param [in] data User data.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+static bool_t faux_ulist_insert(faux_ulist_t *list, faux_ulist_chunk_t *chunk,
+	unsigned int pos, void *data)
+{
+	if (chunk->num == ULIST_CHUNK_ITEMS) {
+		faux_ulist_chunk_t *new_chunk = NULL;
+		unsigned int half = ULIST_CHUNK_ITEMS / 2;
+
+		new_chunk = faux_ulist_new_chunk(list, chunk);
+		if (!new_chunk)
+			return BOOL_FALSE;
+		if (ULIST_CHUNK_ITEMS == pos) {
+			// Append to the end. Don't split to keep chunks full
+			// while adding sorted sequence.
+			chunk = new_chunk;
+			pos = 0;
+		} else {
+			memcpy(new_chunk->data, &chunk->data[half],
+				(ULIST_CHUNK_ITEMS - half) *
+				sizeof(chunk->data[0]));
+			new_chunk->num = ULIST_CHUNK_ITEMS - half;
+			chunk->num = half;
+			if (pos > half) {
+				chunk = new_chunk;
+				pos -= half;
+			}
+		}
+	}
+
+	memmove(&chunk->data[pos + 1], &chunk->data[pos],
+		(chunk->num - pos) * sizeof(chunk->data[0]));
+	chunk->data[pos] = data;
+	chunk->num++;
+	list->len++;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Adds user data to the list.
+ *
+ * The sorted list keeps order. The new item is placed after equal items.
+ * The unique list doesn't add item equal to existent one.
+ *
+ * @param [in] list List to add entry to.
+ * @param [in] data User data.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error or if item exists.
+ */
+bool_t faux_ulist_add(faux_ulist_t *list, void *data)
+{
+	faux_ulist_chunk_t *chunk = NULL;
+	unsigned int pos = 0;
+
+	assert(list);
+	assert(data);
+	if (!list || !data)
+		return BOOL_FALSE;
+
+	// Non-sorted: Insert to tail
+	if (!list->sorted) {
+		// Unique: Search through whole list
+		if (list->unique) {
+			faux_ulist_iter_t iter = {};
+			void *item = NULL;
+			faux_ulist_head(list, &iter);
+			while ((item = faux_ulist_each(&iter))) {
+				if (list->cmpFn(data, item) == 0)
+					return BOOL_FALSE; // Already in list
+			}
+		}
+		chunk = list->tail;
+		if (!chunk) {
+			chunk = faux_ulist_new_chunk(list, NULL);
+			if (!chunk)
+				return BOOL_FALSE;
+		}
+		return faux_ulist_insert(list, chunk, chunk->num, data);
+	}
+
+	// Sorted: Find the last chunk with the first item not greater than new
+	// one. Search from tail.
+	chunk = list->tail;
+	while (chunk && chunk->prev &&
+		(list->cmpFn(data, chunk->data[0]) < 0))
+		chunk = chunk->prev;
+	if (!chunk) { // Empty list
+		chunk = faux_ulist_new_chunk(list, NULL);
+		if (!chunk)
+			return BOOL_FALSE;
+		return faux_ulist_insert(list, chunk, 0, data);
+	}
+
+	// Position after all items not greater than new one
+	pos = chunk->num;
+	while ((pos > 0) && (list->cmpFn(data, chunk->data[pos - 1]) < 0))
+		pos--;
+
+	// Unique: Already exists
+	if (list->unique && (pos > 0) &&
+		(list->cmpFn(data, chunk->data[pos - 1]) == 0))
+		return BOOL_FALSE;
+
+	return faux_ulist_insert(list, chunk, pos, data);
+}
+
+
+/** @brief Removes item from the list by position.
+ *
+ * Static service function. Empty chunk is freed.
+ *
+ * @param [in] list List.
+ * @param [in] chunk Chunk.
+ * @param [in] pos Position within chunk.
+ * @return User data of removed item.
+ */
+static void *faux_ulist_remove(faux_ulist_t *list, faux_ulist_chunk_t *chunk,
+	unsigned int pos)
+{
+	void *data = chunk->data[pos];
+
+	chunk->num--;
+	memmove(&chunk->data[pos], &chunk->data[pos + 1],
+		(chunk->num - pos) * sizeof(chunk->data[0]));
+	list->len--;
+
+	if (0 == chunk->num) {
+		if (chunk->prev)
+			chunk->prev->next = chunk->next;
+		else
+			list->head = chunk->next;
+		if (chunk->next)
+			chunk->next->prev = chunk->prev;
+		else
+			list->tail = chunk->prev;
+		faux_free(chunk);
+	}
+
+	return data;
+}
+
+
+/** @brief Generic static function to search list for matching.
+ *
+ * @sa faux_list_match_node()
+ * @param [in] list List.
+ * @param [in] matchFn User defined matching callback function.
+ * @param [in] userkey User defined data to use in matchFn function.
+ * @param [in,out] iter Iterator.
+ * @param [out] found Position of matched item. Can be NULL.
+ * @return Matched user data or NULL.
+ */
+static void *faux_ulist_match_generic(const faux_ulist_t *list,
+	faux_list_kcmp_fn matchFn, const void *userkey,
+	faux_ulist_iter_t *iter, faux_ulist_iter_t *found)
+{
+	void *data = NULL;
+
+	assert(list);
+	assert(iter);
+	assert(matchFn);
+	if (!iter || !matchFn || !list)
+		return NULL;
+
+	while (iter->chunk) {
+		faux_ulist_chunk_t *chunk = iter->chunk;
+		unsigned int pos = iter->pos;
+		int res = 0;
+
+		// Sorted: Skip whole chunk if the last item is less than key
+		if (list->sorted && (0 == pos) &&
+			(matchFn(userkey, chunk->data[chunk->num - 1]) > 0)) {
+			iter->chunk = chunk->next;
+			continue;
+		}
+
+		// Look through chunk's array
+		for (; pos < chunk->num; pos++) {
+			res = matchFn(userkey, chunk->data[pos]);
+			if ((0 == res) || (list->sorted && (res < 0)))
+				break;
+		}
+		if (pos == chunk->num) {
+			iter->chunk = chunk->next;
+			iter->pos = 0;
+			continue;
+		}
+
+		// Set iterator to the next item
+		iter->pos = pos;
+		data = faux_ulist_each(iter);
+		if (res != 0) // Sorted: No chances to find match
+			return NULL;
+		if (found) {
+			found->chunk = chunk;
+			found->pos = pos;
+		}
+		return data;
+	}
+
+	return NULL;
+}
+
+
+/** @brief Deletes the first item matching the key.
+ *
+ * Function frees user data by freeFn callback if it's defined.
+ *
+ * @param [in] list List to delete item from.
+ * @param [in] userkey User defined key to compare list entry to.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error or "not found" case.
+ */
+bool_t faux_ulist_kdel(faux_ulist_t *list, const void *userkey)
+{
+	faux_ulist_iter_t iter = {};
+	faux_ulist_iter_t found = {};
+	void *data = NULL;
+
+	assert(list);
+	if (!list)
+		return BOOL_FALSE;
+
+	faux_ulist_head(list, &iter);
+	data = faux_ulist_match_generic(list, list->kcmpFn, userkey,
+		&iter, &found);
+	if (!data)
+		return BOOL_FALSE; // Not found
+
+	faux_ulist_remove(list, found.chunk, found.pos);
+	if (list->freeFn)
+		list->freeFn(data);
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Delete all entries from list.
+ *
+ * @param [in] list List to empty.
+ * @return Number of deleted entries or < 0 on error.
+ */
+ssize_t faux_ulist_del_all(faux_ulist_t *list)
+{
+	faux_ulist_chunk_t *chunk = NULL;
+	ssize_t num = 0;
+
+	if (!list)
+		return -1;
+
+	chunk = list->head;
+	while (chunk) {
+		faux_ulist_chunk_t *next = chunk->next;
+		unsigned int i = 0;
+		if (list->freeFn) {
+			for (i = 0; i < chunk->num; i++)
+				list->freeFn(chunk->data[i]);
+		}
+		num += chunk->num;
+		faux_free(chunk);
+		chunk = next;
+	}
+	list->head = NULL;
+	list->tail = NULL;
+	list->len = 0;
+
+	return num;
+}
+
+
+/** @brief Search list for matching (match function).
+ *
+ * @sa faux_list_match_node()
+ * @param [in] list List.
+ * @param [in] matchFn User defined matching callback function.
+ * @param [in] userkey User defined data to use in matchFn function.
+ * @param [in,out] iter Iterator.
+ * @return Matched user data or NULL.
+ */
+void *faux_ulist_match(const faux_ulist_t *list,
+	faux_list_kcmp_fn matchFn, const void *userkey,
+	faux_ulist_iter_t *iter)
+{
+	return faux_ulist_match_generic(list, matchFn, userkey, iter, NULL);
+}
+
+
+/** @brief Search list for matching (key cmp function).
+ *
+ * @sa faux_ulist_match()
+ */
+void *faux_ulist_kmatch(const faux_ulist_t *list,
+	const void *userkey, faux_ulist_iter_t *iter)
+{
+	assert(list);
+	if (!list)
+		return NULL;
+
+	return faux_ulist_match(list, list->kcmpFn, userkey, iter);
+}
+
+
+/** @brief Search list for first matching (match function).
+ *
+ * @sa faux_ulist_match()
+ */
+void *faux_ulist_find(const faux_ulist_t *list,
+	faux_list_kcmp_fn matchFn, const void *userkey)
+{
+	faux_ulist_iter_t iter = {};
+
+	assert(list);
+	if (!list)
+		return NULL;
+
+	faux_ulist_head(list, &iter);
+
+	return faux_ulist_match(list, matchFn, userkey, &iter);
+}
+
+
+/** @brief Search list for first matching (key cmp function).
+ *
+ * @sa faux_ulist_match()
+ */
+void *faux_ulist_kfind(const faux_ulist_t *list,
+	const void *userkey)
+{
+	assert(list);
+	if (!list)
+		return NULL;
+
+	return faux_ulist_find(list, list->kcmpFn, userkey);
+}
+
+
+/** @brief Gets list item by index.
+ *
+ * Function walks through chunks but not items so it costs
+ * O(n / ULIST_CHUNK_ITEMS).
+ *
+ * @param [in] list List.
+ * @param [in] index Item's index.
+ * @return User data by index or NULL on error.
+ */
+void *faux_ulist_index(const faux_ulist_t *list, size_t index)
+{
+	faux_ulist_chunk_t *chunk = NULL;
+
+	assert(list);
+	if (!list)
+		return NULL;
+	if (index >= list->len)
+		return NULL;
+
+	chunk = list->head;
+	while (index >= chunk->num) {
+		index -= chunk->num;
+		chunk = chunk->next;
+	}
+
+	return chunk->data[index];
+}
@@ -504,6 +504,11 @@ faux_phdr_t *faux_msg_get_param_each(faux_list_node_t **node,
 
 
 /** @brief Gets message parameter by the index.
+ *
+ * The list of parameters remembers the last found parameter (see
+ * faux_list_seek_node()). So sequential access by index costs O(1).
+ * Function changes internal state of message so the same message can't be
+ * used by several threads at once.
  *
  * @param [in] msg Allocated faux_msg_t object.
  * @param [in] index Parameter's index.
@@ -516,7 +521,6 @@ faux_phdr_t *faux_msg_get_param_by_index(const faux_msg_t *msg, unsigned int ind
 	uint16_t *param_type, void **param_data, uint32_t *param_len)
 {
 	faux_list_node_t *iter = NULL;
-	unsigned int i = 0;
 
 	assert(msg);
 	assert(msg->hdr);
@@ -525,11 +529,7 @@ faux_phdr_t *faux_msg_get_param_by_index(const faux_msg_t *msg, unsigned int ind
 	if (index >= faux_msg_get_param_num(msg)) // Non-existent entry
 		return NULL;
 
-	iter = faux_msg_init_param_iter(msg);
-	while ((i != index) && iter) {
-		i++;
-		iter = faux_list_next_node(iter);
-	}
+	iter = faux_list_seek_node(msg->params, index);
 
 	return faux_msg_get_param_by_node(iter,
 		param_type, param_data, param_len);
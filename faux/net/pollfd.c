@@ -1,4 +1,15 @@
 /** @file pollfd.c
+ * @brief Vector of "struct pollfd" items.
+ *
+ * The object keeps the fd to index map so search by fd is O(1). The item
+ * is removed by moving the last item to its place so removing is O(1) too.
+ * Note the order of items is not preserved. The items are not moved while
+ * iteration is in progress. The removed item becomes a "tombstone" with
+ * negative fd instead. The poll() ignores such items. The tombstones are
+ * compacted when iteration is finished or on the next iteration start.
+ * The iteration is finished when faux_pollfd_each() reaches the end of
+ * vector. If loop is stopped before the end then iteration must be finished
+ * explicitly by faux_pollfd_fini_iterator().
  */
 
 #include <stdlib.h>
@@ -16,6 +27,8 @@
 #include "faux/vec.h"
 #include "private.h"
 
+#define INDEX_SIZE_MIN 64 // Initial number of entries within fd index
+
 
 /** @brief Callback function to search specified fd within pollfd structures.
  */
@@ -43,6 +56,10 @@ faux_pollfd_t *faux_pollfd_new(void)
 		return NULL;
 
 	faux_pollfd->vec = faux_vec_new(sizeof(struct pollfd), cmp_by_fd);
+	faux_pollfd->index = NULL;
+	faux_pollfd->index_size = 0;
+	faux_pollfd->iterating = BOOL_FALSE;
+	faux_pollfd->tombstones = 0;
 
 	return faux_pollfd;
 }
@@ -57,6 +74,7 @@ void faux_pollfd_free(faux_pollfd_t *faux_pollfd)
 	if (!faux_pollfd)
 		return;
 	faux_vec_free(faux_pollfd->vec);
+	faux_free(faux_pollfd->index);
 	faux_free(faux_pollfd);
 }
 
@@ -79,6 +97,8 @@ struct pollfd *faux_pollfd_vector(faux_pollfd_t *faux_pollfd)
 
 
 /** @brief Returns number of "struct pollfd" items within object.
+ *
+ * The number includes not compacted removed items (with negative fd).
  *
  * @param [in] faux_pollfd Allocated faux_pollfd_t object.
  * @return Number of items.
@@ -109,6 +129,112 @@ struct pollfd *faux_pollfd_item(faux_pollfd_t *faux_pollfd, unsigned int index)
 }
 
 
+/** @brief Gets index of item by fd.
+ *
+ * Static service function.
+ *
+ * @param [in] faux_pollfd Allocated faux_pollfd_t object.
+ * @param [in] fd File descriptor.
+ * @return Index of item or < 0 if not found.
+ */
+static int faux_pollfd_index(const faux_pollfd_t *faux_pollfd, int fd)
+{
+	if ((fd < 0) || ((size_t)fd >= faux_pollfd->index_size))
+		return -1;
+
+	return faux_pollfd->index[fd];
+}
+
+
+/** @brief Sets index of item for fd.
+ *
+ * Static service function. The fd index grows to hold specified fd.
+ *
+ * @param [in] faux_pollfd Allocated faux_pollfd_t object.
+ * @param [in] fd File descriptor.
+ * @param [in] index Index of item or -1 to remove fd.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+static bool_t faux_pollfd_set_index(faux_pollfd_t *faux_pollfd, int fd,
+	int index)
+{
+	if ((size_t)fd >= faux_pollfd->index_size) {
+		size_t new_size = faux_pollfd->index_size ?
+			faux_pollfd->index_size : INDEX_SIZE_MIN;
+		int *new_index = NULL;
+		size_t i = 0;
+
+		if (index < 0)
+			return BOOL_TRUE;
+		while (new_size <= (size_t)fd)
+			new_size *= 2;
+		new_index = realloc(faux_pollfd->index,
+			new_size * sizeof(*new_index));
+		if (!new_index)
+			return BOOL_FALSE;
+		for (i = faux_pollfd->index_size; i < new_size; i++)
+			new_index[i] = -1;
+		faux_pollfd->index = new_index;
+		faux_pollfd->index_size = new_size;
+	}
+	faux_pollfd->index[fd] = index;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Removes item by moving the last item to its place.
+ *
+ * Static service function.
+ *
+ * @param [in] faux_pollfd Allocated faux_pollfd_t object.
+ * @param [in] index Index of item to remove.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+static bool_t faux_pollfd_swap_del(faux_pollfd_t *faux_pollfd,
+	unsigned int index)
+{
+	unsigned int last = faux_vec_len(faux_pollfd->vec) - 1;
+	struct pollfd *pollfd = faux_pollfd_item(faux_pollfd, index);
+
+	if (index != last) {
+		struct pollfd *last_pollfd = faux_pollfd_item(faux_pollfd, last);
+		*pollfd = *last_pollfd;
+		if (pollfd->fd >= 0)
+			faux_pollfd_set_index(faux_pollfd, pollfd->fd, index);
+	}
+	if (faux_vec_del(faux_pollfd->vec, last) < 0)
+		return BOOL_FALSE;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Removes all tombstones.
+ *
+ * Static service function.
+ *
+ * @param [in] faux_pollfd Allocated faux_pollfd_t object.
+ */
+static void faux_pollfd_compact(faux_pollfd_t *faux_pollfd)
+{
+	unsigned int i = 0;
+
+	while ((faux_pollfd->tombstones > 0) &&
+		(i < faux_vec_len(faux_pollfd->vec))) {
+		struct pollfd *pollfd = faux_pollfd_item(faux_pollfd, i);
+		if (pollfd->fd >= 0) {
+			i++;
+			continue;
+		}
+		// The moved item will be checked on the next step
+		faux_pollfd_swap_del(faux_pollfd, i);
+		faux_pollfd->tombstones--;
+	}
+	faux_pollfd->tombstones = 0;
+}
+
+
 /** @brief Finds item with specified fd value.
  *
  * File descriptor is a key for array. Object can contain the only one item
@@ -129,7 +255,7 @@ struct pollfd *faux_pollfd_find(faux_pollfd_t *faux_pollfd, int fd)
 	if (fd < 0)
 		return NULL;
 
-	index = faux_vec_find(faux_pollfd->vec, &fd, 0);
+	index = faux_pollfd_index(faux_pollfd, fd);
 	if (index < 0)
 		return NULL;
 
@@ -163,10 +289,15 @@ struct pollfd *faux_pollfd_add(faux_pollfd_t *faux_pollfd, int fd, short events)
 	pollfd = faux_pollfd_find(faux_pollfd, fd);
 	if (!pollfd) {
 		// Create new item
+		if (!faux_pollfd_set_index(faux_pollfd, fd,
+			faux_vec_len(faux_pollfd->vec)))
+			return NULL;
 		pollfd = faux_vec_add(faux_pollfd->vec);
 		assert(pollfd);
-		if (!pollfd)
+		if (!pollfd) {
+			faux_pollfd_set_index(faux_pollfd, fd, -1);
 			return NULL;
+		}
 		pollfd->fd = fd;
 	}
 
@@ -178,6 +309,10 @@ struct pollfd *faux_pollfd_add(faux_pollfd_t *faux_pollfd, int fd, short events)
 
 
 /** @brief Removes item specified by fd.
+ *
+ * The last item takes place of removed one. While iteration is in progress
+ * the removed item becomes a tombstone (negative fd) and it's compacted
+ * later. So iteration is not broken.
  *
  * @param [in] faux_pollfd Allocated faux_pollfd_t object.
  * @param [in] fd File descriptor to remove.
@@ -194,18 +329,17 @@ bool_t faux_pollfd_del_by_fd(faux_pollfd_t *faux_pollfd, int fd)
 	if (fd < 0)
 		return BOOL_FALSE;
 
-	index = faux_vec_find(faux_pollfd->vec, &fd, 0);
+	index = faux_pollfd_index(faux_pollfd, fd);
 	if (index < 0) // Not found
 		return BOOL_FALSE;
 
-	if (faux_vec_del(faux_pollfd->vec, index) < 0)
-		return BOOL_FALSE;
-
-	return BOOL_TRUE;
+	return faux_pollfd_del_by_index(faux_pollfd, index);
 }
 
 
 /** @brief Removes item specified by index.
+ *
+ * See faux_pollfd_del_by_fd().
  *
  * @param [in] faux_pollfd Allocated faux_pollfd_t object.
  * @param [in] index Index of item to remove.
@@ -213,21 +347,38 @@ bool_t faux_pollfd_del_by_fd(faux_pollfd_t *faux_pollfd, int fd)
  */
 bool_t faux_pollfd_del_by_index(faux_pollfd_t *faux_pollfd, unsigned int index)
 {
+	struct pollfd *pollfd = NULL;
+
 	assert(faux_pollfd);
 	if (!faux_pollfd)
 		return BOOL_FALSE;
 
-	if (faux_vec_del(faux_pollfd->vec, index) < 0)
+	pollfd = faux_pollfd_item(faux_pollfd, index);
+	if (!pollfd || (pollfd->fd < 0))
 		return BOOL_FALSE;
+	faux_pollfd_set_index(faux_pollfd, pollfd->fd, -1);
+
+	// Don't move items while iteration
+	if (faux_pollfd->iterating) {
+		pollfd->fd = -1;
+		pollfd->revents = 0;
+		faux_pollfd->tombstones++;
+		return BOOL_TRUE;
+	}
 
-	return BOOL_TRUE;
+	return faux_pollfd_swap_del(faux_pollfd, index);
 }
 
 
 /** @brief Initilizes iterator to iterate through all the vector.
+ *
+ * The tombstones left by previous iteration are compacted. The items are
+ * not moved until the end of iteration. The iteration that is stopped
+ * before the end of vector must be finished by faux_pollfd_fini_iterator().
  *
  * @sa faux_pollfd_each()
  * @sa faux_pollfd_each_active()
+ * @sa faux_pollfd_fini_iterator()
  * @param [in] faux_pollfd Allocated faux_pollfd_t object.
  * @param [out] iterator Iterator to initialize.
  */
@@ -238,6 +389,8 @@ void faux_pollfd_init_iterator(faux_pollfd_t *faux_pollfd, faux_pollfd_iterator_
 		return;
 	if (!iterator)
 		return;
+	faux_pollfd_compact(faux_pollfd);
+	faux_pollfd->iterating = BOOL_TRUE;
 	*iterator = 0;
 }
 
@@ -245,6 +398,7 @@ void faux_pollfd_init_iterator(faux_pollfd_t *faux_pollfd, faux_pollfd_iterator_
 /** @brief Iterate through all the vector.
  *
  * The iterator must be initialized first by faux_pollfd_init_iterator().
+ * The tombstones are skipped.
  *
  * @param [in] faux_pollfd Allocated faux_pollfd_t object.
  * @param [out] iterator Initialized iterator.
@@ -260,10 +414,47 @@ struct pollfd *faux_pollfd_each(faux_pollfd_t *faux_pollfd, faux_pollfd_iterator
 	if (!iterator)
 		return NULL;
 
-	old_iterator = *iterator;
-	(*iterator)++;
+	while (1) {
+		struct pollfd *pollfd = NULL;
+
+		old_iterator = *iterator;
+		(*iterator)++;
+		pollfd = faux_pollfd_item(faux_pollfd, old_iterator);
+		if (!pollfd)
+			break;
+		if (pollfd->fd >= 0)
+			return pollfd;
+	}
+
+	// End of iteration
+	faux_pollfd->iterating = BOOL_FALSE;
+	faux_pollfd_compact(faux_pollfd);
+
+	return NULL;
+}
+
+
+/** @brief Finishes iteration.
+ *
+ * The removed items are compacted. It's not necessary to call function if
+ * faux_pollfd_each() or faux_pollfd_each_active() has returned NULL i.e.
+ * iteration has reached the end of vector. But it's harmless. The iterator
+ * can't be used after that.
+ *
+ * @param [in] faux_pollfd Allocated faux_pollfd_t object.
+ * @param [in] iterator Initialized iterator.
+ */
+void faux_pollfd_fini_iterator(faux_pollfd_t *faux_pollfd, faux_pollfd_iterator_t *iterator)
+{
+	assert(faux_pollfd);
+	if (!faux_pollfd)
+		return;
+	if (!iterator)
+		return;
 
-	return faux_pollfd_item(faux_pollfd, old_iterator);
+	faux_pollfd->iterating = BOOL_FALSE;
+	faux_pollfd_compact(faux_pollfd);
+	*iterator = faux_pollfd_len(faux_pollfd);
 }
 
 
@@ -308,6 +499,10 @@ bool_t faux_pollfd_del_all(faux_pollfd_t *faux_pollfd)
 		return BOOL_FALSE;
 
 	faux_vec_del_all(faux_pollfd->vec);
+	faux_free(faux_pollfd->index);
+	faux_pollfd->index = NULL;
+	faux_pollfd->index_size = 0;
+	faux_pollfd->tombstones = 0;
 
 	return BOOL_TRUE;
 }
@@ -15,4 +15,8 @@ struct faux_net_s {
 
 struct faux_pollfd_s {
 	faux_vec_t *vec;
+	int *index; // Index of item within vector. Indexed by fd. -1 if absent
+	size_t index_size; // Number of allocated entries within index
+	bool_t iterating; // Iteration is in progress. Items are not moved
+	size_t tombstones; // Number of removed but not compacted items
 };
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <poll.h>
+
+#include "faux/net.h"
+
+#define POLLFD_NUM 10
+int testc_faux_pollfd(void)
+{
+	unsigned int i = 0;
+	unsigned int n = 0;
+	int ret = -1; // Pessimistic return value
+	faux_pollfd_t *pollfds = NULL;
+	faux_pollfd_iterator_t iter;
+	struct pollfd *pollfd = NULL;
+	unsigned int seen[POLLFD_NUM] = {};
+
+	pollfds = faux_pollfd_new();
+	for (i = 0; i < POLLFD_NUM; i++)
+		faux_pollfd_add(pollfds, i, POLLIN);
+	// Big fd value grows index
+	faux_pollfd_add(pollfds, 1000, POLLIN);
+
+	// Find
+	pollfd = faux_pollfd_find(pollfds, 1000);
+	if (!pollfd || (pollfd->fd != 1000)) {
+		fprintf(stderr, "Can't find item by fd\n");
+		goto err;
+	}
+	if (faux_pollfd_find(pollfds, POLLFD_NUM)) {
+		fprintf(stderr, "Found unexistent item\n");
+		goto err;
+	}
+
+	// Remove. The last item takes place of removed one.
+	if (!faux_pollfd_del_by_fd(pollfds, 0) ||
+		faux_pollfd_del_by_fd(pollfds, 0)) {
+		fprintf(stderr, "Broken removing by fd\n");
+		goto err;
+	}
+	pollfd = faux_pollfd_find(pollfds, 1000);
+	if (!pollfd || (pollfd->fd != 1000) ||
+		(faux_pollfd_len(pollfds) != POLLFD_NUM)) {
+		fprintf(stderr, "Can't find moved item\n");
+		goto err;
+	}
+
+	// Remove items while iteration. Each active item must be got once.
+	faux_pollfd_del_all(pollfds);
+	for (i = 0; i < POLLFD_NUM; i++)
+		faux_pollfd_add(pollfds, i, POLLIN)->revents = POLLIN;
+	faux_pollfd_init_iterator(pollfds, &iter);
+	while ((pollfd = faux_pollfd_each_active(pollfds, &iter))) {
+		int fd = pollfd->fd;
+		seen[fd]++;
+		n++;
+		faux_pollfd_del_by_fd(pollfds, fd);
+		// Remove not yet iterated item too
+		if (fd == 0)
+			faux_pollfd_del_by_fd(pollfds, POLLFD_NUM - 1);
+	}
+	if (n != (POLLFD_NUM - 1)) {
+		fprintf(stderr, "Broken iteration with removing: %u\n", n);
+		goto err;
+	}
+	for (i = 0; i < (POLLFD_NUM - 1); i++) {
+		if (seen[i] != 1) {
+			fprintf(stderr, "Item %u is got %u times\n", i, seen[i]);
+			goto err;
+		}
+	}
+	// The tombstones are compacted at the end of iteration
+	if (faux_pollfd_len(pollfds) != 0) {
+		fprintf(stderr, "Removed items are not compacted\n");
+		goto err;
+	}
+
+	// Stop iteration before the end. The explicit finish compacts items.
+	for (i = 0; i < POLLFD_NUM; i++)
+		faux_pollfd_add(pollfds, i, POLLIN);
+	faux_pollfd_init_iterator(pollfds, &iter);
+	pollfd = faux_pollfd_each(pollfds, &iter);
+	faux_pollfd_del_by_fd(pollfds, pollfd->fd);
+	if (faux_pollfd_len(pollfds) != POLLFD_NUM) {
+		fprintf(stderr, "Item is moved while iteration\n");
+		goto err;
+	}
+	faux_pollfd_fini_iterator(pollfds, &iter);
+	if (faux_pollfd_len(pollfds) != (POLLFD_NUM - 1)) {
+		fprintf(stderr, "Removed item is not compacted by finish\n");
+		goto err;
+	}
+	faux_pollfd_del_by_fd(pollfds, 1);
+	if (faux_pollfd_len(pollfds) != (POLLFD_NUM - 2)) {
+		fprintf(stderr, "Iteration is not finished\n");
+		goto err;
+	}
+
+	ret = 0;
+err:
+	faux_pollfd_free(pollfds);
+
+	return ret;
+}
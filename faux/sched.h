@@ -17,6 +17,12 @@ typedef enum {
 	FAUX_SCHED_ONCE = BOOL_FALSE
 	} faux_sched_periodic_e;
 
+// Optional indexes to speed up search of scheduled events
+typedef enum {
+	FAUX_SCHED_INDEX_ID = 0, // Index by event ID
+	FAUX_SCHED_INDEX_DATA = 1 // Index by data pointer
+	} faux_sched_index_e;
+
 typedef struct faux_ev_s faux_ev_t;
 typedef struct faux_sched_s faux_sched_t;
 typedef faux_list_node_t faux_sched_node_t;
@@ -31,6 +37,8 @@ bool_t faux_ev_is_busy(const faux_ev_t *ev);
 void faux_ev_set_free_data_cb(faux_ev_t *ev, faux_list_free_fn free_data_cb);
 bool_t faux_ev_set_time(faux_ev_t *ev, const struct timespec *new_time);
 const struct timespec *faux_ev_time(const faux_ev_t *ev);
+bool_t faux_ev_set_slack(faux_ev_t *ev, const struct timespec *slack);
+const struct timespec *faux_ev_slack(const faux_ev_t *ev);
 bool_t faux_ev_set_periodic(faux_ev_t *ev,
 	const struct timespec *interval, unsigned int cycle_num);
 faux_sched_periodic_e faux_ev_is_periodic(const faux_ev_t *ev);
@@ -40,6 +48,11 @@ void *faux_ev_data(const faux_ev_t *ev);
 
 // Time event scheduler
 faux_sched_t *faux_sched_new(void);
+faux_sched_t *faux_sched_new_wheel(const struct timespec *resolution);
+faux_sched_t *faux_sched_new_heap(void);
+bool_t faux_sched_add_index(faux_sched_t *sched, faux_sched_index_e index);
+bool_t faux_sched_set_clock(faux_sched_t *sched, clockid_t clock);
+void faux_sched_set_now(faux_sched_t *sched, const struct timespec *now);
 void faux_sched_free(faux_sched_t *sched);
 bool_t faux_sched_add(faux_sched_t *sched, faux_ev_t *ev);
 faux_ev_t *faux_sched_once(
@@ -55,7 +68,14 @@ faux_ev_t *faux_sched_periodic_delayed(
 bool_t faux_sched_next_interval(const faux_sched_t *sched, struct timespec *interval);
 void faux_sched_del_all(faux_sched_t *sched);
 faux_ev_t *faux_sched_pop(faux_sched_t *sched);
+ssize_t faux_sched_lateness(const faux_sched_t *sched,
+	struct timespec *avg, struct timespec *max);
+void faux_sched_reset_lateness(faux_sched_t *sched);
+void faux_sched_start_pass(faux_sched_t *sched);
+ssize_t faux_sched_saved_wakeups(const faux_sched_t *sched);
 ssize_t faux_sched_del(faux_sched_t *sched, faux_ev_t *ev);
+bool_t faux_sched_reschedule(faux_sched_t *sched, faux_ev_t *ev,
+	const struct timespec *time);
 ssize_t faux_sched_del_by_id(faux_sched_t *sched, int id);
 ssize_t faux_sched_del_by_data(faux_sched_t *sched, void *data);
 faux_list_node_t *faux_sched_init_ev_iter(faux_sched_t *sched);
@@ -111,8 +111,14 @@ faux_ev_t *faux_ev_new(int ev_id, void *data)
 	ev->periodic = FAUX_SCHED_ONCE; // Not periodic by default
 	ev->cycle_num = 0;
 	faux_nsec_to_timespec(&(ev->period), 0l);
+	ev->clock = CLOCK_REALTIME;
+	faux_nsec_to_timespec(&(ev->slack), 0l);
 	faux_ev_reschedule(ev, FAUX_SCHED_NOW);
 	ev->busy = BOOL_FALSE;
+	ev->node = NULL;
+	ev->sched = NULL;
+	ev->id_node = NULL;
+	ev->data_node = NULL;
 
 	return ev;
 }
@@ -302,6 +308,48 @@ bool_t faux_ev_set_time(faux_ev_t *ev, const struct timespec *new_time)
 }
 
 
+/** @brief Sets slack of event.
+ *
+ * Slack is an allowed delay of event. The scheduler can pop event later
+ * than planned time but not later than (time + slack) to process several
+ * events with overlapped windows by single wakeup. Zero slack by default.
+ * The slack can be changed for busy event too. The new value is used since
+ * next faux_sched_next_interval() call.
+ *
+ * @param [in] ev Allocated and initialized event object.
+ * @param [in] slack Allowed delay. NULL for zero slack.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_ev_set_slack(faux_ev_t *ev, const struct timespec *slack)
+{
+	assert(ev);
+	if (!ev)
+		return BOOL_FALSE;
+
+	if (slack)
+		ev->slack = *slack;
+	else
+		faux_nsec_to_timespec(&(ev->slack), 0l);
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Returns slack of event object.
+ *
+ * @param [in] ev Allocated and initialized ev object.
+ * @return Pointer to static timespec.
+ */
+const struct timespec *faux_ev_slack(const faux_ev_t *ev)
+{
+	assert(ev);
+	if (!ev)
+		return NULL;
+
+	return &(ev->slack);
+}
+
+
 /** Returns time of event object.
  *
  * @param [in] ev Allocated and initialized ev object.
@@ -335,7 +383,7 @@ bool_t faux_ev_reschedule(faux_ev_t *ev, const struct timespec *new_time)
 	if (new_time) {
 		ev->time = *new_time;
 	} else { // Time isn't given so use "NOW"
-		faux_timespec_now(&(ev->time));
+		clock_gettime(ev->clock, &(ev->time));
 	}
 
 	return BOOL_TRUE;
@@ -375,6 +423,9 @@ bool_t faux_ev_reschedule_period(faux_ev_t *ev)
 
 
 /** @brief Calculates time left from now to the event.
+ *
+ * The current time is measured by the clock of scheduler the event
+ * belongs to.
  *
  * @param [in] ev Allocated and initialized ev object.
  * @param [out] left Calculated time left.
@@ -389,7 +440,7 @@ bool_t faux_ev_time_left(const faux_ev_t *ev, struct timespec *left)
 	if (!ev || !left)
 		return BOOL_FALSE;
 
-	faux_timespec_now(&now);
+	clock_gettime(ev->clock, &now);
 	if (faux_timespec_cmp(&now, &(ev->time)) > 0) { // Already happened
 		faux_nsec_to_timespec(left, 0l);
 		return BOOL_TRUE;
@@ -0,0 +1,313 @@
+/** @file heap.c
+ * @brief Indexed 4-ary min-heap to order scheduled events.
+ *
+ * The heap is stored in a flat array of event pointers. The earliest event
+ * is at the array head. Each event knows its own index within array so the
+ * event can be removed or moved after time change in O(log n) without
+ * search. The events with equal time are ordered by the adding sequence.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "private.h"
+#include "faux/faux.h"
+#include "faux/time.h"
+#include "faux/sched.h"
+
+#define HEAP_ARITY 4 // Number of children for each heap node
+#define HEAP_MIN 64 // Initial number of array items
+
+
+/** @brief Compares two events by time and adding sequence.
+ *
+ * @param [in] a First event.
+ * @param [in] b Second event.
+ * @return BOOL_TRUE if first event must be popped earlier than second one.
+ */
+static bool_t heap_less(const faux_ev_t *a, const faux_ev_t *b)
+{
+	int r = faux_timespec_cmp(&a->time, &b->time);
+
+	if (r != 0)
+		return (r < 0) ? BOOL_TRUE : BOOL_FALSE;
+
+	return (a->seq < b->seq) ? BOOL_TRUE : BOOL_FALSE;
+}
+
+
+/** @brief Places event to the heap array and updates event's index.
+ *
+ * @param [in] heap Heap.
+ * @param [in] index Array index.
+ * @param [in] ev Event.
+ */
+static void heap_set(faux_sched_heap_t *heap, size_t index, faux_ev_t *ev)
+{
+	heap->evs[index] = ev;
+	ev->heap_index = index;
+}
+
+
+/** @brief Moves event up to the heap root while it's earlier than parent.
+ *
+ * @param [in] heap Heap.
+ * @param [in] index Index of event to move.
+ */
+static void heap_sift_up(faux_sched_heap_t *heap, size_t index)
+{
+	faux_ev_t *ev = heap->evs[index];
+
+	while (index > 0) {
+		size_t parent = (index - 1) / HEAP_ARITY;
+		if (!heap_less(ev, heap->evs[parent]))
+			break;
+		heap_set(heap, index, heap->evs[parent]);
+		index = parent;
+	}
+	heap_set(heap, index, ev);
+}
+
+
+/** @brief Moves event down while it's later than the earliest child.
+ *
+ * @param [in] heap Heap.
+ * @param [in] index Index of event to move.
+ */
+static void heap_sift_down(faux_sched_heap_t *heap, size_t index)
+{
+	faux_ev_t *ev = heap->evs[index];
+
+	while (1) {
+		size_t first = index * HEAP_ARITY + 1;
+		size_t last = first + HEAP_ARITY;
+		size_t best = first;
+		size_t child = 0;
+
+		if (first >= heap->len)
+			break;
+		if (last > heap->len)
+			last = heap->len;
+		for (child = first + 1; child < last; child++) {
+			if (heap_less(heap->evs[child], heap->evs[best]))
+				best = child;
+		}
+		if (!heap_less(heap->evs[best], ev))
+			break;
+		heap_set(heap, index, heap->evs[best]);
+		index = best;
+	}
+	heap_set(heap, index, ev);
+}
+
+
+/** @brief Allocates new heap.
+ *
+ * @return Allocated heap or NULL on error.
+ */
+faux_sched_heap_t *faux_sched_heap_new(void)
+{
+	faux_sched_heap_t *heap = NULL;
+
+	heap = faux_zmalloc(sizeof(*heap));
+	if (!heap)
+		return NULL;
+
+	// Init
+	heap->evs = NULL;
+	heap->len = 0;
+	heap->size = 0;
+	heap->seq = 0;
+
+	return heap;
+}
+
+
+/** @brief Frees heap.
+ *
+ * Doesn't free events.
+ *
+ * @param [in] heap Heap.
+ */
+void faux_sched_heap_free(faux_sched_heap_t *heap)
+{
+	if (!heap)
+		return;
+
+	faux_free(heap->evs);
+	faux_free(heap);
+}
+
+
+/** @brief Forgets all events stored within heap.
+ *
+ * Doesn't free events.
+ *
+ * @param [in] heap Heap.
+ */
+void faux_sched_heap_clear(faux_sched_heap_t *heap)
+{
+	assert(heap);
+	if (!heap)
+		return;
+
+	heap->len = 0;
+}
+
+
+/** @brief Adds event to heap.
+ *
+ * @param [in] heap Heap.
+ * @param [in] ev Event to add.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_sched_heap_add(faux_sched_heap_t *heap, faux_ev_t *ev)
+{
+	assert(heap);
+	assert(ev);
+	if (!heap || !ev)
+		return BOOL_FALSE;
+
+	if (heap->len == heap->size) {
+		size_t new_size = heap->size ? (heap->size * 2) : HEAP_MIN;
+		faux_ev_t **new_evs = NULL;
+
+		new_evs = realloc(heap->evs, new_size * sizeof(*new_evs));
+		if (!new_evs)
+			return BOOL_FALSE;
+		heap->evs = new_evs;
+		heap->size = new_size;
+	}
+
+	ev->seq = heap->seq++;
+	heap_set(heap, heap->len, ev);
+	heap->len++;
+	heap_sift_up(heap, ev->heap_index);
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Restores heap order after event's time change.
+ *
+ * @param [in] heap Heap.
+ * @param [in] ev Event stored within heap.
+ */
+void faux_sched_heap_update(faux_sched_heap_t *heap, faux_ev_t *ev)
+{
+	size_t index = 0;
+
+	assert(heap);
+	assert(ev);
+	if (!heap || !ev)
+		return;
+
+	index = ev->heap_index;
+	if ((index > 0) &&
+		heap_less(ev, heap->evs[(index - 1) / HEAP_ARITY]))
+		heap_sift_up(heap, index);
+	else
+		heap_sift_down(heap, index);
+}
+
+
+/** @brief Removes event from heap.
+ *
+ * The last array item takes place of removed event.
+ *
+ * @param [in] heap Heap.
+ * @param [in] ev Event stored within heap.
+ */
+void faux_sched_heap_del(faux_sched_heap_t *heap, faux_ev_t *ev)
+{
+	size_t index = 0;
+	faux_ev_t *last = NULL;
+
+	assert(heap);
+	assert(ev);
+	if (!heap || !ev)
+		return;
+
+	index = ev->heap_index;
+	heap->len--;
+	if (index == heap->len)
+		return;
+	last = heap->evs[heap->len];
+	heap_set(heap, index, last);
+	faux_sched_heap_update(heap, last);
+}
+
+
+/** @brief Gets the earliest event.
+ *
+ * @param [in] heap Heap.
+ * @return The earliest event or NULL if heap is empty.
+ */
+faux_ev_t *faux_sched_heap_top(const faux_sched_heap_t *heap)
+{
+	assert(heap);
+	if (!heap)
+		return NULL;
+	if (0 == heap->len)
+		return NULL;
+
+	return heap->evs[0];
+}
+
+
+/** @brief Finds the latest deadline of subtree within coalescing window.
+ *
+ * The events of subtree which are later than current deadline can't
+ * decrease it. So such subtrees are skipped.
+ *
+ * @param [in] heap Heap.
+ * @param [in] index Index of subtree root.
+ * @param [in,out] deadline Current deadline.
+ */
+static void heap_deadline(const faux_sched_heap_t *heap, size_t index,
+	struct timespec *deadline)
+{
+	const faux_ev_t *ev = heap->evs[index];
+	struct timespec ev_deadline = {};
+	size_t child = 0;
+
+	if (faux_timespec_cmp(&ev->time, deadline) > 0)
+		return;
+	faux_timespec_sum(&ev_deadline, &ev->time, &ev->slack);
+	if (faux_timespec_cmp(&ev_deadline, deadline) < 0)
+		*deadline = ev_deadline;
+	for (child = index * HEAP_ARITY + 1;
+		(child <= index * HEAP_ARITY + HEAP_ARITY) && (child < heap->len);
+		child++)
+		heap_deadline(heap, child, deadline);
+}
+
+
+/** @brief Gets the latest time to process the earliest event.
+ *
+ * It's the minimal (time + slack) of events. Only the events which are
+ * earlier than found deadline are inspected.
+ *
+ * @param [in] heap Heap.
+ * @param [out] deadline Found deadline.
+ * @return BOOL_TRUE if found, BOOL_FALSE if heap is empty.
+ */
+bool_t faux_sched_heap_deadline(const faux_sched_heap_t *heap,
+	struct timespec *deadline)
+{
+	const faux_ev_t *ev = NULL;
+
+	assert(heap);
+	assert(deadline);
+	if (!heap || !deadline)
+		return BOOL_FALSE;
+	if (0 == heap->len)
+		return BOOL_FALSE;
+
+	ev = heap->evs[0];
+	faux_timespec_sum(deadline, &ev->time, &ev->slack);
+	heap_deadline(heap, 0, deadline);
+
+	return BOOL_TRUE;
+}
@@ -0,0 +1,307 @@
+/** @file index.c
+ * @brief Hash index of scheduled events by ID or by data pointer.
+ *
+ * The index is a hash table with chaining. Each entry of table contains
+ * the key (event ID or data pointer) and the list of events with such key.
+ * Each event stores its node within such list so event removing is O(1)
+ * on average. The entry is removed when its list becomes empty. The table
+ * doubles its size when number of keys exceeds number of buckets.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "private.h"
+#include "faux/faux.h"
+#include "faux/list.h"
+#include "faux/sched.h"
+
+#define INDEX_SIZE_MIN 64 // Initial number of buckets
+
+
+/** @brief Gets the key of event.
+ *
+ * @param [in] index Index.
+ * @param [in] ev Event.
+ * @return Key value.
+ */
+static uintptr_t index_key(const faux_sched_index_t *index,
+	const faux_ev_t *ev)
+{
+	if (FAUX_SCHED_INDEX_DATA == index->type)
+		return (uintptr_t)ev->data;
+
+	return (uintptr_t)(unsigned int)ev->id;
+}
+
+
+/** @brief Gets the pointer to event's node within index list.
+ *
+ * @param [in] index Index.
+ * @param [in] ev Event.
+ * @return Pointer to node field of event.
+ */
+static faux_list_node_t **index_node(const faux_sched_index_t *index,
+	faux_ev_t *ev)
+{
+	if (FAUX_SCHED_INDEX_DATA == index->type)
+		return &ev->data_node;
+
+	return &ev->id_node;
+}
+
+
+/** @brief Gets the bucket number for the key.
+ *
+ * @param [in] key Key value.
+ * @param [in] size Number of buckets. Power of two.
+ * @return Bucket number.
+ */
+static size_t index_bucket(uintptr_t key, size_t size)
+{
+	uint64_t hash = (uint64_t)key * 0x9e3779b97f4a7c15ull;
+
+	hash ^= hash >> 32;
+
+	return hash & (size - 1);
+}
+
+
+/** @brief Doubles the number of buckets.
+ *
+ * @param [in] index Index.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+static bool_t index_grow(faux_sched_index_t *index)
+{
+	size_t new_size = index->size ? (index->size * 2) : INDEX_SIZE_MIN;
+	faux_sched_index_entry_t **new_buckets = NULL;
+	size_t i = 0;
+
+	new_buckets = faux_zmalloc(new_size * sizeof(*new_buckets));
+	if (!new_buckets)
+		return BOOL_FALSE;
+	for (i = 0; i < index->size; i++) {
+		faux_sched_index_entry_t *entry = index->buckets[i];
+		while (entry) {
+			faux_sched_index_entry_t *next = entry->next;
+			size_t b = index_bucket(entry->key, new_size);
+			entry->next = new_buckets[b];
+			new_buckets[b] = entry;
+			entry = next;
+		}
+	}
+	faux_free(index->buckets);
+	index->buckets = new_buckets;
+	index->size = new_size;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Finds the entry by key.
+ *
+ * @param [in] index Index.
+ * @param [in] key Key value.
+ * @return Found entry or NULL.
+ */
+static faux_sched_index_entry_t *index_find(const faux_sched_index_t *index,
+	uintptr_t key)
+{
+	faux_sched_index_entry_t *entry = NULL;
+
+	if (0 == index->size)
+		return NULL;
+	entry = index->buckets[index_bucket(key, index->size)];
+	while (entry && (entry->key != key))
+		entry = entry->next;
+
+	return entry;
+}
+
+
+/** @brief Allocates new index.
+ *
+ * @param [in] type Type of index.
+ * @return Allocated index or NULL on error.
+ */
+faux_sched_index_t *faux_sched_index_new(faux_sched_index_e type)
+{
+	faux_sched_index_t *index = NULL;
+
+	index = faux_zmalloc(sizeof(*index));
+	if (!index)
+		return NULL;
+
+	// Init
+	index->type = type;
+	index->buckets = NULL;
+	index->size = 0;
+	index->len = 0;
+
+	return index;
+}
+
+
+/** @brief Frees index.
+ *
+ * Doesn't free events.
+ *
+ * @param [in] index Index.
+ */
+void faux_sched_index_free(faux_sched_index_t *index)
+{
+	if (!index)
+		return;
+
+	faux_sched_index_clear(index);
+	faux_free(index->buckets);
+	faux_free(index);
+}
+
+
+/** @brief Removes all entries from index.
+ *
+ * Doesn't free events.
+ *
+ * @param [in] index Index.
+ */
+void faux_sched_index_clear(faux_sched_index_t *index)
+{
+	size_t i = 0;
+
+	assert(index);
+	if (!index)
+		return;
+
+	for (i = 0; i < index->size; i++) {
+		faux_sched_index_entry_t *entry = index->buckets[i];
+		while (entry) {
+			faux_sched_index_entry_t *next = entry->next;
+			faux_list_free(entry->evs);
+			faux_free(entry);
+			entry = next;
+		}
+		index->buckets[i] = NULL;
+	}
+	index->len = 0;
+}
+
+
+/** @brief Adds event to index.
+ *
+ * @param [in] index Index.
+ * @param [in] ev Event.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_sched_index_add(faux_sched_index_t *index, faux_ev_t *ev)
+{
+	uintptr_t key = 0;
+	faux_sched_index_entry_t *entry = NULL;
+	faux_list_node_t *node = NULL;
+
+	assert(index);
+	assert(ev);
+	if (!index || !ev)
+		return BOOL_FALSE;
+
+	key = index_key(index, ev);
+	entry = index_find(index, key);
+	if (!entry) {
+		size_t b = 0;
+		if ((index->len >= index->size) && !index_grow(index))
+			return BOOL_FALSE;
+		entry = faux_zmalloc(sizeof(*entry));
+		if (!entry)
+			return BOOL_FALSE;
+		entry->key = key;
+		entry->evs = faux_list_new(FAUX_LIST_UNSORTED,
+			FAUX_LIST_NONUNIQUE, NULL, NULL, NULL);
+		if (!entry->evs) {
+			faux_free(entry);
+			return BOOL_FALSE;
+		}
+		b = index_bucket(key, index->size);
+		entry->next = index->buckets[b];
+		index->buckets[b] = entry;
+		index->len++;
+	}
+
+	node = faux_list_add(entry->evs, ev);
+	if (!node) {
+		*index_node(index, ev) = NULL;
+		if (faux_list_is_empty(entry->evs))
+			faux_sched_index_del(index, ev);
+		return BOOL_FALSE;
+	}
+	*index_node(index, ev) = node;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Removes event from index.
+ *
+ * @param [in] index Index.
+ * @param [in] ev Event.
+ */
+void faux_sched_index_del(faux_sched_index_t *index, faux_ev_t *ev)
+{
+	uintptr_t key = 0;
+	faux_sched_index_entry_t **entry_p = NULL;
+	faux_sched_index_entry_t *entry = NULL;
+	faux_list_node_t **node = NULL;
+
+	assert(index);
+	assert(ev);
+	if (!index || !ev)
+		return;
+	if (0 == index->size)
+		return;
+
+	key = index_key(index, ev);
+	entry_p = &index->buckets[index_bucket(key, index->size)];
+	while (*entry_p && ((*entry_p)->key != key))
+		entry_p = &(*entry_p)->next;
+	entry = *entry_p;
+	if (!entry)
+		return;
+
+	node = index_node(index, ev);
+	if (*node) {
+		faux_list_del(entry->evs, *node);
+		*node = NULL;
+	}
+	if (!faux_list_is_empty(entry->evs))
+		return;
+
+	// Remove empty entry
+	*entry_p = entry->next;
+	faux_list_free(entry->evs);
+	faux_free(entry);
+	index->len--;
+}
+
+
+/** @brief Gets the first node of list of events with specified key.
+ *
+ * @param [in] index Index.
+ * @param [in] key Event ID or data pointer casted to uintptr_t.
+ * @return List node (data is faux_ev_t) or NULL if not found.
+ */
+faux_list_node_t *faux_sched_index_first(const faux_sched_index_t *index,
+	uintptr_t key)
+{
+	faux_sched_index_entry_t *entry = NULL;
+
+	assert(index);
+	if (!index)
+		return NULL;
+
+	entry = index_find(index, key);
+	if (!entry)
+		return NULL;
+
+	return faux_list_head(entry->evs);
+}
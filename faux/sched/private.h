@@ -3,6 +3,21 @@
 #include "faux/time.h"
 #include "faux/sched.h"
 
+// Hierarchical timing wheel geometry
+#define WHEEL_BITS 6 // Number of bits of tick for single level
+#define WHEEL_SIZE (1 << WHEEL_BITS) // Number of slots within level
+#define WHEEL_MASK (WHEEL_SIZE - 1)
+#define WHEEL_LEVELS 8 // Wheel covers (WHEEL_BITS * WHEEL_LEVELS) bits of tick
+#define WHEEL_READY WHEEL_LEVELS // Pseudo-level for already expired events
+
+
+// Link to organize events into intrusive bidirectional circular lists
+typedef struct faux_sched_link_s faux_sched_link_t;
+struct faux_sched_link_s {
+	faux_sched_link_t *prev;
+	faux_sched_link_t *next;
+};
+
 
 struct faux_ev_s {
 	struct timespec time; // Planned time of event
@@ -13,11 +28,78 @@ struct faux_ev_s {
 	void *data; // Arbitrary data linked to event
 	faux_list_free_fn free_data_cb; // Callback to free user data
 	bool_t busy;
+	faux_list_node_t *node; // Node within sched list. Valid for busy event
+	faux_sched_t *sched; // Owner sched. Valid for busy event
+	faux_sched_link_t link; // Link within timing wheel slot
+	uint64_t tick; // Expiration tick for timing wheel
+	unsigned int level; // Timing wheel level (WHEEL_READY for expired)
+	unsigned int slot; // Slot within timing wheel level
+	size_t heap_index; // Index within heap array
+	uint64_t seq; // Sequence number to order equal events within heap
+	faux_list_node_t *id_node; // Node within ID index list
+	faux_list_node_t *data_node; // Node within data index list
+	clockid_t clock; // Clock to measure time of event
+	struct timespec slack; // Allowed delay to coalesce wakeups
 };
 
 
+typedef enum {
+	FAUX_SCHED_BACKEND_LIST = 0, // Sorted list
+	FAUX_SCHED_BACKEND_WHEEL = 1, // Hierarchical timing wheel
+	FAUX_SCHED_BACKEND_HEAP = 2 // Indexed min-heap
+} faux_sched_backend_e;
+
+
+typedef struct faux_sched_wheel_s {
+	uint64_t resolution; // Length of tick (nsec)
+	uint64_t tick; // Next tick to process
+	uint64_t bitmap[WHEEL_LEVELS]; // Bit is set for non-empty slot
+	faux_sched_link_t slots[WHEEL_LEVELS][WHEEL_SIZE];
+	faux_sched_link_t ready; // Expired events
+} faux_sched_wheel_t;
+
+
+typedef struct faux_sched_heap_s {
+	faux_ev_t **evs; // Heap array
+	size_t len; // Number of events within heap
+	size_t size; // Number of allocated array items
+	uint64_t seq; // Sequence number for next added event
+} faux_sched_heap_t;
+
+
+typedef struct faux_sched_index_entry_s faux_sched_index_entry_t;
+struct faux_sched_index_entry_s {
+	uintptr_t key; // Event ID or data pointer
+	faux_list_t *evs; // Events with the key
+	faux_sched_index_entry_t *next; // Next entry within bucket
+};
+
+
+typedef struct faux_sched_index_s {
+	faux_sched_index_e type; // Index by ID or by data
+	faux_sched_index_entry_t **buckets; // Hash table
+	size_t size; // Number of buckets. Power of two.
+	size_t len; // Number of entries (keys)
+} faux_sched_index_t;
+
+
 struct faux_sched_s {
-	faux_list_t *list;
+	faux_sched_backend_e backend; // Mechanism to order events
+	clockid_t clock; // Clock to measure time of events
+	struct timespec now; // Cached current time
+	bool_t now_cached; // Use cached time instead of clock reading
+	faux_list_t *list; // All scheduled events. Sorted for list backend
+	faux_sched_wheel_t *wheel; // Timing wheel for wheel backend
+	faux_sched_heap_t *heap; // Heap for heap backend
+	faux_sched_index_t *id_index; // Optional index by event ID
+	faux_sched_index_t *data_index; // Optional index by data pointer
+	uint64_t popped; // Number of popped events
+	uint64_t lateness_sum; // Sum of popped events lateness (nsec)
+	uint64_t lateness_max; // Max lateness of popped event (nsec)
+	uint64_t saved_wakeups; // Number of wakeups saved by coalescing
+	bool_t batch; // Events are popped within the same wakeup
+	bool_t batch_slack; // Some event of current batch has slack
+	struct timespec batch_time; // Time of last popped event of batch
 };
 
 
@@ -34,4 +116,34 @@ FAUX_HIDDEN bool_t faux_ev_dec_cycles(faux_ev_t *ev, unsigned int *new_cycle_num
 FAUX_HIDDEN bool_t faux_ev_reschedule(faux_ev_t *ev, const struct timespec *new_time);
 FAUX_HIDDEN bool_t faux_ev_reschedule_period(faux_ev_t *ev);
 
+FAUX_HIDDEN faux_sched_wheel_t *faux_sched_wheel_new(
+	const struct timespec *resolution, const struct timespec *now);
+FAUX_HIDDEN void faux_sched_wheel_free(faux_sched_wheel_t *wheel);
+FAUX_HIDDEN void faux_sched_wheel_clear(faux_sched_wheel_t *wheel);
+FAUX_HIDDEN void faux_sched_wheel_add(faux_sched_wheel_t *wheel, faux_ev_t *ev);
+FAUX_HIDDEN void faux_sched_wheel_del(faux_sched_wheel_t *wheel, faux_ev_t *ev);
+FAUX_HIDDEN faux_ev_t *faux_sched_wheel_pop(faux_sched_wheel_t *wheel,
+	const struct timespec *now);
+FAUX_HIDDEN bool_t faux_sched_wheel_next(const faux_sched_wheel_t *wheel,
+	struct timespec *time);
+
+
+FAUX_HIDDEN faux_sched_heap_t *faux_sched_heap_new(void);
+FAUX_HIDDEN void faux_sched_heap_free(faux_sched_heap_t *heap);
+FAUX_HIDDEN void faux_sched_heap_clear(faux_sched_heap_t *heap);
+FAUX_HIDDEN bool_t faux_sched_heap_add(faux_sched_heap_t *heap, faux_ev_t *ev);
+FAUX_HIDDEN void faux_sched_heap_update(faux_sched_heap_t *heap, faux_ev_t *ev);
+FAUX_HIDDEN void faux_sched_heap_del(faux_sched_heap_t *heap, faux_ev_t *ev);
+FAUX_HIDDEN faux_ev_t *faux_sched_heap_top(const faux_sched_heap_t *heap);
+FAUX_HIDDEN bool_t faux_sched_heap_deadline(const faux_sched_heap_t *heap,
+	struct timespec *deadline);
+
+FAUX_HIDDEN faux_sched_index_t *faux_sched_index_new(faux_sched_index_e type);
+FAUX_HIDDEN void faux_sched_index_free(faux_sched_index_t *index);
+FAUX_HIDDEN void faux_sched_index_clear(faux_sched_index_t *index);
+FAUX_HIDDEN bool_t faux_sched_index_add(faux_sched_index_t *index, faux_ev_t *ev);
+FAUX_HIDDEN void faux_sched_index_del(faux_sched_index_t *index, faux_ev_t *ev);
+FAUX_HIDDEN faux_list_node_t *faux_sched_index_first(
+	const faux_sched_index_t *index, uintptr_t key);
+
 C_DECL_END
@@ -13,6 +13,13 @@
  * Each scheduled event can has arbitrary ID and pointer to arbitrary data
  * linked to this event. The ID can be used for type of event for
  * example or something else. The linked data can be a service structure.
+ *
+ * The sched object created by faux_sched_new_wheel() uses hierarchical
+ * timing wheel (see wheel.c) instead of sorted list to order events. The
+ * faux_sched_new_heap() creates sched object based on indexed min-heap
+ * (see heap.c). The list contains all scheduled events too but it's not
+ * sorted. So iteration over events doesn't follow the order of time in
+ * these cases.
  */
 
 #include <sys/time.h>
@@ -28,6 +35,24 @@
 #include "faux/sched.h"
 
 
+/** @brief Gets current time for scheduler.
+ *
+ * Static function. It's a cached time if it was set by faux_sched_set_now()
+ * or the current time of scheduler's clock else.
+ *
+ * @param [in] sched Allocated and initialized sched object.
+ * @param [out] now Current time.
+ */
+static void faux_sched_now(const faux_sched_t *sched, struct timespec *now)
+{
+	if (sched->now_cached) {
+		*now = sched->now;
+		return;
+	}
+	clock_gettime(sched->clock, now);
+}
+
+
 /** @brief Allocates new sched object.
  *
  * Before working with sched object it must be allocated and initialized.
@@ -43,13 +68,244 @@ faux_sched_t *faux_sched_new(void)
 		return NULL;
 
 	// Init
+	sched->backend = FAUX_SCHED_BACKEND_LIST;
+	sched->clock = CLOCK_REALTIME;
+	sched->now_cached = BOOL_FALSE;
 	sched->list = faux_list_new(FAUX_LIST_SORTED, FAUX_LIST_NONUNIQUE,
 		faux_ev_compare, NULL, faux_ev_free_forced);
+	sched->wheel = NULL;
+	sched->heap = NULL;
+	sched->id_index = NULL;
+	sched->data_index = NULL;
+	sched->popped = 0;
+	sched->lateness_sum = 0;
+	sched->lateness_max = 0;
+	sched->saved_wakeups = 0;
+	sched->batch = BOOL_FALSE;
+	sched->batch_slack = BOOL_FALSE;
+	faux_nsec_to_timespec(&sched->batch_time, 0);
+
+	return sched;
+}
+
+
+/** @brief Allocates new sched object based on timing wheel.
+ *
+ * The timing wheel makes add, delete and expire operations O(1). It's
+ * useful for big number of events especially if most of them are deleted
+ * before expiration. The events are popped not earlier than planned time
+ * but can be late up to single resolution interval. The order of events
+ * within the same resolution interval is undefined.
+ *
+ * @param [in] resolution Resolution of timing wheel. Must be non-zero.
+ * @return Allocated and initialized sched object or NULL on error.
+ */
+faux_sched_t *faux_sched_new_wheel(const struct timespec *resolution)
+{
+	faux_sched_t *sched = NULL;
+	struct timespec now = {};
+
+	assert(resolution);
+	if (!resolution)
+		return NULL;
+
+	sched = faux_zmalloc(sizeof(*sched));
+	if (!sched)
+		return NULL;
+
+	// Init
+	sched->backend = FAUX_SCHED_BACKEND_WHEEL;
+	sched->list = faux_list_new(FAUX_LIST_UNSORTED, FAUX_LIST_NONUNIQUE,
+		NULL, NULL, faux_ev_free_forced);
+	sched->clock = CLOCK_REALTIME;
+	sched->now_cached = BOOL_FALSE;
+	faux_sched_now(sched, &now);
+	sched->wheel = faux_sched_wheel_new(resolution, &now);
+	if (!sched->wheel) {
+		faux_sched_free(sched);
+		return NULL;
+	}
+	sched->heap = NULL;
+	sched->id_index = NULL;
+	sched->data_index = NULL;
+	sched->popped = 0;
+	sched->lateness_sum = 0;
+	sched->lateness_max = 0;
+	sched->saved_wakeups = 0;
+	sched->batch = BOOL_FALSE;
+	sched->batch_slack = BOOL_FALSE;
+	faux_nsec_to_timespec(&sched->batch_time, 0);
+
+	return sched;
+}
+
+
+/** @brief Allocates new sched object based on indexed min-heap.
+ *
+ * The heap makes add, delete and reschedule operations O(log n) and
+ * getting of the earliest event O(1). Unlike timing wheel the heap doesn't
+ * lose time precision. The events with equal time are popped in the order
+ * of adding.
+ *
+ * @return Allocated and initialized sched object or NULL on error.
+ */
+faux_sched_t *faux_sched_new_heap(void)
+{
+	faux_sched_t *sched = NULL;
+
+	sched = faux_zmalloc(sizeof(*sched));
+	if (!sched)
+		return NULL;
+
+	// Init
+	sched->backend = FAUX_SCHED_BACKEND_HEAP;
+	sched->clock = CLOCK_REALTIME;
+	sched->now_cached = BOOL_FALSE;
+	sched->list = faux_list_new(FAUX_LIST_UNSORTED, FAUX_LIST_NONUNIQUE,
+		NULL, NULL, faux_ev_free_forced);
+	sched->wheel = NULL;
+	sched->heap = faux_sched_heap_new();
+	if (!sched->heap) {
+		faux_sched_free(sched);
+		return NULL;
+	}
+	sched->id_index = NULL;
+	sched->data_index = NULL;
+	sched->popped = 0;
+	sched->lateness_sum = 0;
+	sched->lateness_max = 0;
+	sched->saved_wakeups = 0;
+	sched->batch = BOOL_FALSE;
+	sched->batch_slack = BOOL_FALSE;
+	faux_nsec_to_timespec(&sched->batch_time, 0);
 
 	return sched;
 }
 
 
+/** @brief Adds optional index to speed up search of events.
+ *
+ * The index by event ID speeds up faux_sched_get_by_id() and
+ * faux_sched_del_by_id(). The index by data pointer speeds up
+ * faux_sched_get_by_data() and faux_sched_del_by_data(). These functions
+ * become O(1) on average. The index is kept in sync automatically. It
+ * costs memory and some time on each event adding and removing. The
+ * already scheduled events are indexed too.
+ *
+ * @param [in] sched Allocated and initialized sched object.
+ * @param [in] index Type of index.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_sched_add_index(faux_sched_t *sched, faux_sched_index_e index)
+{
+	faux_sched_index_t **index_p = NULL;
+	faux_sched_index_t *new_index = NULL;
+	faux_list_node_t *iter = NULL;
+	faux_ev_t *ev = NULL;
+
+	assert(sched);
+	if (!sched)
+		return BOOL_FALSE;
+
+	switch (index) {
+	case FAUX_SCHED_INDEX_ID:
+		index_p = &sched->id_index;
+		break;
+	case FAUX_SCHED_INDEX_DATA:
+		index_p = &sched->data_index;
+		break;
+	default:
+		return BOOL_FALSE;
+	}
+	if (*index_p)
+		return BOOL_TRUE; // Already indexed
+
+	new_index = faux_sched_index_new(index);
+	if (!new_index)
+		return BOOL_FALSE;
+	iter = faux_list_head(sched->list);
+	while ((ev = (faux_ev_t *)faux_list_each(&iter))) {
+		if (!faux_sched_index_add(new_index, ev)) {
+			// Drop references to index lists from events
+			iter = faux_list_head(sched->list);
+			while ((ev = (faux_ev_t *)faux_list_each(&iter)))
+				faux_sched_index_del(new_index, ev);
+			faux_sched_index_free(new_index);
+			return BOOL_FALSE;
+		}
+	}
+	*index_p = new_index;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Sets clock to use by scheduler.
+ *
+ * The default clock is CLOCK_REALTIME. All absolute times of events
+ * scheduled within sched object are measured by this clock. The
+ * CLOCK_MONOTONIC is not affected by wall-clock changes. The clock can be
+ * changed only while there are no scheduled events.
+ *
+ * @param [in] sched Allocated and initialized sched object.
+ * @param [in] clock Clock ID. See clock_gettime().
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_sched_set_clock(faux_sched_t *sched, clockid_t clock)
+{
+	struct timespec now = {};
+	struct timespec ts = {};
+
+	assert(sched);
+	if (!sched)
+		return BOOL_FALSE;
+	if (!faux_list_is_empty(sched->list))
+		return BOOL_FALSE;
+	if (clock_gettime(clock, &ts) < 0)
+		return BOOL_FALSE; // Unsupported clock
+
+	sched->clock = clock;
+	sched->now_cached = BOOL_FALSE;
+	if (FAUX_SCHED_BACKEND_WHEEL == sched->backend) {
+		faux_sched_wheel_t *wheel = NULL;
+		faux_nsec_to_timespec(&ts, sched->wheel->resolution);
+		faux_sched_now(sched, &now);
+		wheel = faux_sched_wheel_new(&ts, &now);
+		if (!wheel)
+			return BOOL_FALSE;
+		faux_sched_wheel_free(sched->wheel);
+		sched->wheel = wheel;
+	}
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Sets cached current time for scheduler.
+ *
+ * Scheduler reads the clock every time it needs current time. The owner
+ * of scheduler (event loop for example) can read the clock once and set
+ * cached time. Then scheduler will use cached time until it will be
+ * changed or dropped. The time must be measured by scheduler's clock.
+ *
+ * @param [in] sched Allocated and initialized sched object.
+ * @param [in] now Current time or NULL to drop cached time.
+ */
+void faux_sched_set_now(faux_sched_t *sched, const struct timespec *now)
+{
+	assert(sched);
+	if (!sched)
+		return;
+
+	if (!now) {
+		sched->now_cached = BOOL_FALSE;
+		return;
+	}
+	sched->now = *now;
+	sched->now_cached = BOOL_TRUE;
+}
+
+
 /** @brief Frees the sched object.
  *
  * After using the sched object must be freed. Function frees object itself
@@ -61,10 +317,49 @@ void faux_sched_free(faux_sched_t *sched)
 		return;
 
 	faux_list_free(sched->list);
+	faux_sched_wheel_free(sched->wheel);
+	faux_sched_heap_free(sched->heap);
+	faux_sched_index_free(sched->id_index);
+	faux_sched_index_free(sched->data_index);
 	faux_free(sched);
 }
 
 
+/** @brief Adds event to optional indexes.
+ *
+ * Static function.
+ *
+ * @param [in] sched Allocated and initialized sched object.
+ * @param [in] ev Event.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+static bool_t faux_sched_index_ev(faux_sched_t *sched, faux_ev_t *ev)
+{
+	if (sched->id_index && !faux_sched_index_add(sched->id_index, ev))
+		return BOOL_FALSE;
+	if (sched->data_index && !faux_sched_index_add(sched->data_index, ev))
+		return BOOL_FALSE;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Removes event from optional indexes.
+ *
+ * Static function. It's safe to remove event that is not indexed.
+ *
+ * @param [in] sched Allocated and initialized sched object.
+ * @param [in] ev Event.
+ */
+static void faux_sched_unindex_ev(faux_sched_t *sched, faux_ev_t *ev)
+{
+	if (sched->id_index)
+		faux_sched_index_del(sched->id_index, ev);
+	if (sched->data_index)
+		faux_sched_index_del(sched->data_index, ev);
+}
+
+
 /** @brief Adds time event (faux_ev_t) to scheduling list.
  *
  * @param [in] sched Allocated and initialized sched object.
@@ -85,12 +380,53 @@ bool_t faux_sched_add(faux_sched_t *sched, faux_ev_t *ev)
 	node = faux_list_add(sched->list, ev);
 	if (!node) // Something went wrong
 		return BOOL_FALSE;
+	ev->node = node;
+	ev->sched = sched;
+	ev->clock = sched->clock;
+	if (!faux_sched_index_ev(sched, ev) ||
+		((FAUX_SCHED_BACKEND_HEAP == sched->backend) &&
+		!faux_sched_heap_add(sched->heap, ev))) {
+		faux_sched_unindex_ev(sched, ev);
+		faux_list_takeaway(sched->list, node);
+		ev->node = NULL;
+		ev->sched = NULL;
+		return BOOL_FALSE;
+	}
+	if (FAUX_SCHED_BACKEND_WHEEL == sched->backend)
+		faux_sched_wheel_add(sched->wheel, ev);
 	faux_ev_set_busy(ev, BOOL_TRUE);
 
 	return BOOL_TRUE;
 }
 
 
+/** @brief Takes away event from scheduling list.
+ *
+ * Static function. Doesn't free event.
+ *
+ * @param [in] sched Allocated and initialized sched object.
+ * @param [in] ev Scheduled event.
+ */
+static void faux_sched_takeaway(faux_sched_t *sched, faux_ev_t *ev)
+{
+	switch (sched->backend) {
+	case FAUX_SCHED_BACKEND_WHEEL:
+		faux_sched_wheel_del(sched->wheel, ev);
+		break;
+	case FAUX_SCHED_BACKEND_HEAP:
+		faux_sched_heap_del(sched->heap, ev);
+		break;
+	default:
+		break;
+	}
+	faux_sched_unindex_ev(sched, ev);
+	faux_list_takeaway(sched->list, ev->node);
+	ev->node = NULL;
+	ev->sched = NULL;
+	faux_ev_set_busy(ev, BOOL_FALSE);
+}
+
+
 /** @brief Internal function to add constructed event to scheduling list.
  *
  * @param [in] sched Allocated and initialized sched object.
@@ -112,7 +448,14 @@ static faux_ev_t *_sched(faux_sched_t *sched, const struct timespec *time,
 	assert(ev);
 	if (!ev)
 		return NULL;
-	faux_ev_set_time(ev, time);
+	ev->clock = sched->clock;
+	if (time) {
+		faux_ev_set_time(ev, time);
+	} else { // Time isn't given so use "NOW"
+		struct timespec now = {};
+		faux_sched_now(sched, &now);
+		faux_ev_set_time(ev, &now);
+	}
 	if (FAUX_SCHED_PERIODIC == periodic)
 		faux_ev_set_periodic(ev, period, cycle_num);
 
@@ -164,7 +507,7 @@ faux_ev_t *faux_sched_once_delayed(faux_sched_t *sched,
 
 	if (!interval)
 		return faux_sched_once(sched, FAUX_SCHED_NOW, ev_id, data);
-	faux_timespec_now(&now);
+	faux_sched_now(sched, &now);
 	faux_timespec_sum(&plan, &now, interval);
 
 	return faux_sched_once(sched, &plan, ev_id, data);
@@ -211,7 +554,7 @@ faux_ev_t *faux_sched_periodic_delayed(
 	if (!sched || !period)
 		return NULL;
 
-	faux_timespec_now(&now);
+	faux_sched_now(sched, &now);
 	faux_timespec_sum(&plan, &now, period);
 	return faux_sched_periodic(sched, &plan, ev_id, data,
 		period, cycle_num);
@@ -222,6 +565,9 @@ faux_ev_t *faux_sched_periodic_delayed(
  *
  * If event is in the past then return null interval.
  * If no events was scheduled then return BOOL_FALSE.
+ * The events with slack (see faux_ev_set_slack()) allow to postpone the
+ * wakeup up to the earliest (time + slack) of events. So all events planned
+ * before such moment will be popped by single wakeup.
  *
  * @param [in] sched Allocated and initialized sched object.
  * @param [out] interval Calculated interval.
@@ -231,19 +577,47 @@ bool_t faux_sched_next_interval(const faux_sched_t *sched, struct timespec *inte
 {
 	faux_ev_t *ev = NULL;
 	faux_list_node_t *iter = NULL;
+	struct timespec next = {};
+	struct timespec now = {};
 
 	assert(sched);
 	assert(interval);
 	if (!sched || !interval)
 		return BOOL_FALSE;
 
-	iter = faux_list_head(sched->list);
-	if (!iter)
-		return BOOL_FALSE;
-	ev = (faux_ev_t *)faux_list_data(iter);
+	switch (sched->backend) {
+	case FAUX_SCHED_BACKEND_WHEEL:
+		// The wheel coalesces events within a tick by itself
+		if (!faux_sched_wheel_next(sched->wheel, &next))
+			return BOOL_FALSE;
+		break;
+	case FAUX_SCHED_BACKEND_HEAP:
+		if (!faux_sched_heap_deadline(sched->heap, &next))
+			return BOOL_FALSE;
+		break;
+	default:
+		iter = faux_list_head(sched->list);
+		if (!iter)
+			return BOOL_FALSE;
+		ev = (faux_ev_t *)faux_list_data(iter);
+		faux_timespec_sum(&next, &ev->time, &ev->slack);
+		// The sorted list allows to stop on the first event that is
+		// later than found deadline
+		while ((iter = faux_list_next_node(iter))) {
+			struct timespec deadline = {};
+			ev = (faux_ev_t *)faux_list_data(iter);
+			if (faux_timespec_cmp(&ev->time, &next) > 0)
+				break;
+			faux_timespec_sum(&deadline, &ev->time, &ev->slack);
+			if (faux_timespec_cmp(&deadline, &next) < 0)
+				next = deadline;
+		}
+		break;
+	}
 
-	if (!faux_ev_time_left(ev, interval))
-		return BOOL_FALSE;
+	faux_sched_now(sched, &now);
+	if (!faux_timespec_diff(interval, &next, &now)) // Already happened
+		faux_nsec_to_timespec(interval, 0);
 
 	return BOOL_TRUE;
 }
@@ -259,6 +633,14 @@ void faux_sched_del_all(faux_sched_t *sched)
 	if (!sched)
 		return;
 
+	if (FAUX_SCHED_BACKEND_WHEEL == sched->backend)
+		faux_sched_wheel_clear(sched->wheel);
+	else if (FAUX_SCHED_BACKEND_HEAP == sched->backend)
+		faux_sched_heap_clear(sched->heap);
+	if (sched->id_index)
+		faux_sched_index_clear(sched->id_index);
+	if (sched->data_index)
+		faux_sched_index_clear(sched->data_index);
 	faux_list_del_all(sched->list);
 }
 
@@ -280,19 +662,59 @@ faux_ev_t *faux_sched_pop(faux_sched_t *sched)
 {
 	faux_list_node_t *iter = NULL;
 	faux_ev_t *ev = NULL;
+	struct timespec now = {};
+	struct timespec lateness = {};
+	uint64_t lateness_nsec = 0;
 
 	assert(sched);
 	if (!sched)
 		return NULL;
 
-	iter = faux_list_head(sched->list);
-	if (!iter)
+	faux_sched_now(sched, &now);
+	switch (sched->backend) {
+	case FAUX_SCHED_BACKEND_WHEEL:
+		ev = faux_sched_wheel_pop(sched->wheel, &now);
+		break;
+	case FAUX_SCHED_BACKEND_HEAP:
+		ev = faux_sched_heap_top(sched->heap);
+		break;
+	default:
+		iter = faux_list_head(sched->list);
+		if (iter)
+			ev = (faux_ev_t *)faux_list_data(iter);
+		break;
+	}
+	if (!ev || (faux_timespec_cmp(&now, faux_ev_time(ev)) < 0)) {
+		// The wheel has unlinked event already. It's possible when the
+		// current time goes backwards. Return event to the wheel.
+		if (ev && (FAUX_SCHED_BACKEND_WHEEL == sched->backend))
+			faux_sched_wheel_add(sched->wheel, ev);
+		sched->batch = BOOL_FALSE; // No more events for this wakeup
 		return NULL;
-	ev = (faux_ev_t *)faux_list_data(iter);
-	if (!faux_timespec_before_now(faux_ev_time(ev)))
-		return NULL; // No events for this time
-	faux_list_takeaway(sched->list, iter); // Remove entry from list
-	faux_ev_set_busy(ev, BOOL_FALSE);
+	}
+	faux_sched_takeaway(sched, ev); // Remove entry from list
+
+	// Statistics. The event popped by the same wakeup as earlier event
+	// with slack saves separate wakeup.
+	if (!sched->batch) {
+		sched->batch = BOOL_TRUE;
+		sched->batch_slack = BOOL_FALSE;
+		sched->batch_time = ev->time;
+	} else if (faux_timespec_cmp(&ev->time, &sched->batch_time) > 0) {
+		if (sched->batch_slack)
+			sched->saved_wakeups++;
+		sched->batch_time = ev->time;
+	}
+	if (faux_timespec_to_nsec(&ev->slack) > 0)
+		sched->batch_slack = BOOL_TRUE;
+
+	// Statistics. How late the event is popped.
+	faux_timespec_diff(&lateness, &now, faux_ev_time(ev));
+	lateness_nsec = faux_timespec_to_nsec(&lateness);
+	sched->popped++;
+	sched->lateness_sum += lateness_nsec;
+	if (lateness_nsec > sched->lateness_max)
+		sched->lateness_max = lateness_nsec;
 
 	if (faux_ev_reschedule_period(ev))
 		faux_sched_add(sched, ev);
@@ -301,6 +723,91 @@ faux_ev_t *faux_sched_pop(faux_sched_t *sched)
 }
 
 
+/** @brief Gets lateness of popped events.
+ *
+ * Lateness is an interval between planned time of event and the moment
+ * when event is really popped by faux_sched_pop(). Lateness is accounted
+ * since sched object creation or since last faux_sched_reset_lateness().
+ *
+ * @param [in] sched Allocated and initialized sched object.
+ * @param [out] avg Average lateness. Can be NULL.
+ * @param [out] max Max lateness. Can be NULL.
+ * @return Number of popped events or < 0 on error.
+ */
+ssize_t faux_sched_lateness(const faux_sched_t *sched,
+	struct timespec *avg, struct timespec *max)
+{
+	assert(sched);
+	if (!sched)
+		return -1;
+
+	if (avg)
+		faux_nsec_to_timespec(avg, sched->popped ?
+			(sched->lateness_sum / sched->popped) : 0);
+	if (max)
+		faux_nsec_to_timespec(max, sched->lateness_max);
+
+	return sched->popped;
+}
+
+
+/** @brief Resets lateness statistics.
+ *
+ * @param [in] sched Allocated and initialized sched object.
+ */
+void faux_sched_reset_lateness(faux_sched_t *sched)
+{
+	assert(sched);
+	if (!sched)
+		return;
+
+	sched->popped = 0;
+	sched->lateness_sum = 0;
+	sched->lateness_max = 0;
+}
+
+
+/** @brief Starts new pass of popping events.
+ *
+ * The owner of scheduler (event loop for example) can pop only limited
+ * number of events per wakeup. So the series of faux_sched_pop() calls is
+ * not finished by NULL return value. The function tells scheduler that the
+ * following events are popped by new wakeup. It's used by statistics only.
+ *
+ * @param [in] sched Allocated and initialized sched object.
+ */
+void faux_sched_start_pass(faux_sched_t *sched)
+{
+	assert(sched);
+	if (!sched)
+		return;
+
+	sched->batch = BOOL_FALSE;
+}
+
+
+/** @brief Gets number of wakeups saved by coalescing.
+ *
+ * The wakeup can be postponed due to slack of the earliest events. So later
+ * events are popped by the same wakeup. Every such event that is planned
+ * later than previous event of the same wakeup saves one wakeup. The wakeup
+ * is a series of faux_sched_pop() calls started by faux_sched_start_pass()
+ * or finished by NULL return value. The number is accounted since sched
+ * object creation.
+ *
+ * @param [in] sched Allocated and initialized sched object.
+ * @return Number of saved wakeups or < 0 on error.
+ */
+ssize_t faux_sched_saved_wakeups(const faux_sched_t *sched)
+{
+	assert(sched);
+	if (!sched)
+		return -1;
+
+	return sched->saved_wakeups;
+}
+
+
 /** @brief Deletes all events with specified value from list.
  *
  * Static function.
@@ -308,10 +815,12 @@ faux_ev_t *faux_sched_pop(faux_sched_t *sched)
  * @param [in] sched Allocated and initialized sched object.
  * @param [in] value Pointer to key value.
  * @param [in] cmp_f Callback to compare key and entry.
+ * @param [in] index Index to use instead of list search. Can be NULL.
+ * @param [in] key Key value for index search.
  * @return Number of removed entries or < 0 on error.
  */
 static ssize_t faux_sched_del_by_something(faux_sched_t *sched, void *value,
-	faux_list_kcmp_fn cmp_f)
+	faux_list_kcmp_fn cmp_f, faux_sched_index_t *index, uintptr_t key)
 {
 	faux_list_node_t *node = NULL;
 	faux_list_node_t *saved = NULL;
@@ -321,10 +830,22 @@ static ssize_t faux_sched_del_by_something(faux_sched_t *sched, void *value,
 	if (!sched)
 		return -1;
 
+	if (index) {
+		while ((node = faux_sched_index_first(index, key))) {
+			faux_ev_t *ev = (faux_ev_t *)faux_list_data(node);
+			faux_sched_takeaway(sched, ev);
+			faux_ev_free_forced(ev);
+			nodes_deleted++;
+		}
+		return nodes_deleted;
+	}
+
 	saved = faux_list_head(sched->list);
 	while ((node = faux_list_match_node(sched->list, cmp_f,
 		value, &saved))) {
-		faux_list_del(sched->list, node);
+		faux_ev_t *ev = (faux_ev_t *)faux_list_data(node);
+		faux_sched_takeaway(sched, ev);
+		faux_ev_free_forced(ev);
 		nodes_deleted++;
 	}
 
@@ -333,6 +854,10 @@ static ssize_t faux_sched_del_by_something(faux_sched_t *sched, void *value,
 
 
 /** @brief Delete event from list.
+ *
+ * The event knows its own position and owner so the search is not needed.
+ * The event that is not busy or is scheduled within another sched object
+ * is not removed.
  *
  * @param [in] sched Allocated and initialized sched object.
  * @param [in] ptr Pointer to event object.
@@ -340,7 +865,77 @@ static ssize_t faux_sched_del_by_something(faux_sched_t *sched, void *value,
  */
 ssize_t faux_sched_del(faux_sched_t *sched, faux_ev_t *ev)
 {
-	return faux_sched_del_by_something(sched, ev, faux_ev_compare_ptr);
+	assert(sched);
+	assert(ev);
+	if (!sched || !ev)
+		return -1;
+	if (!faux_ev_is_busy(ev) || !ev->node)
+		return 0; // Not scheduled
+	if (ev->sched != sched)
+		return 0; // Scheduled within another sched
+
+	faux_sched_takeaway(sched, ev);
+	faux_ev_free_forced(ev);
+
+	return 1;
+}
+
+
+/** @brief Changes time of already scheduled event.
+ *
+ * The event must be scheduled within specified sched object. The event
+ * keeps its place within the list of all events (for unsorted backends) so
+ * iterators stay valid. The heap backend makes it in O(log n), timing
+ * wheel in O(1).
+ *
+ * @param [in] sched Allocated and initialized sched object.
+ * @param [in] ev Scheduled event.
+ * @param [in] time New absolute time of event (FAUX_SCHED_NOW for now).
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_sched_reschedule(faux_sched_t *sched, faux_ev_t *ev,
+	const struct timespec *time)
+{
+	faux_list_node_t *node = NULL;
+	struct timespec now = {};
+
+	assert(sched);
+	assert(ev);
+	if (!sched || !ev)
+		return BOOL_FALSE;
+	if (!faux_ev_is_busy(ev) || !ev->node)
+		return BOOL_FALSE; // Not scheduled
+	if (ev->sched != sched)
+		return BOOL_FALSE; // Scheduled within another sched
+	if (!time) { // Time isn't given so use "NOW"
+		faux_sched_now(sched, &now);
+		time = &now;
+	}
+
+	switch (sched->backend) {
+	case FAUX_SCHED_BACKEND_WHEEL:
+		faux_sched_wheel_del(sched->wheel, ev);
+		faux_ev_reschedule(ev, time);
+		faux_sched_wheel_add(sched->wheel, ev);
+		break;
+	case FAUX_SCHED_BACKEND_HEAP:
+		faux_ev_reschedule(ev, time);
+		faux_sched_heap_update(sched->heap, ev);
+		break;
+	default:
+		faux_list_takeaway(sched->list, ev->node);
+		faux_ev_reschedule(ev, time);
+		node = faux_list_add(sched->list, ev);
+		ev->node = node;
+		if (!node) { // Something went wrong. Event is not scheduled now.
+			ev->sched = NULL;
+			faux_ev_set_busy(ev, BOOL_FALSE);
+			return BOOL_FALSE;
+		}
+		break;
+	}
+
+	return BOOL_TRUE;
 }
 
 
@@ -352,7 +947,12 @@ ssize_t faux_sched_del(faux_sched_t *sched, faux_ev_t *ev)
  */
 ssize_t faux_sched_del_by_id(faux_sched_t *sched, int id)
 {
-	return faux_sched_del_by_something(sched, &id, faux_ev_compare_id);
+	assert(sched);
+	if (!sched)
+		return -1;
+
+	return faux_sched_del_by_something(sched, &id, faux_ev_compare_id,
+		sched->id_index, (uintptr_t)(unsigned int)id);
 }
 
 
@@ -364,7 +964,12 @@ ssize_t faux_sched_del_by_id(faux_sched_t *sched, int id)
  */
 ssize_t faux_sched_del_by_data(faux_sched_t *sched, void *data)
 {
-	return faux_sched_del_by_something(sched, data, faux_ev_compare_data);
+	assert(sched);
+	if (!sched)
+		return -1;
+
+	return faux_sched_del_by_something(sched, data, faux_ev_compare_data,
+		sched->data_index, (uintptr_t)data);
 }
 
 
@@ -387,23 +992,42 @@ faux_list_node_t *faux_sched_init_ev_iter(faux_sched_t *sched)
  *
  * Static function.
  * Saved iterator 'saved' must be initialized to list head before usage.
+ * If index is used then iterator walks through index list of events with
+ * specified key after first call. The index list nodes are never equal to
+ * the head of sched list so the first call is easily detected.
  *
  * @param [in] sched Allocated and initialized sched object.
  * @param [in] value Value to search for.
  * @param [in] cmp_f Callback to compare key and entry.
+ * @param [in] index Index to use instead of list search. Can be NULL.
+ * @param [in] key Key value for index search.
  * @param [in,out] saved Iterator.
  * @return Event (faux_ev_t) pointer or NULL on error or not found.
  */
 static faux_ev_t *faux_sched_get_by_something(faux_sched_t *sched, void *value,
-	faux_list_kcmp_fn cmp_f, faux_list_node_t **saved)
+	faux_list_kcmp_fn cmp_f, faux_sched_index_t *index, uintptr_t key,
+	faux_list_node_t **saved)
 {
 	faux_list_node_t *node = NULL;
 	faux_ev_t *ev = NULL;
 
 	assert(sched);
-	if (!sched)
+	assert(saved);
+	if (!sched || !saved)
 		return NULL;
 
+	if (index) {
+		node = *saved;
+		if (node && (node == faux_list_head(sched->list)))
+			node = faux_sched_index_first(index, key);
+		if (!node) {
+			*saved = NULL;
+			return NULL;
+		}
+		*saved = faux_list_next_node(node);
+		return (faux_ev_t *)faux_list_data(node);
+	}
+
 	node = faux_list_match_node(sched->list, cmp_f, value, saved);
 	if (!node)
 		return NULL;
@@ -426,8 +1050,12 @@ static faux_ev_t *faux_sched_get_by_something(faux_sched_t *sched, void *value,
 faux_ev_t *faux_sched_get_by_id(faux_sched_t *sched, int ev_id,
 	faux_list_node_t **saved)
 {
-	return faux_sched_get_by_something(sched, &ev_id,
-		faux_ev_compare_id, saved);
+	assert(sched);
+	if (!sched)
+		return NULL;
+
+	return faux_sched_get_by_something(sched, &ev_id, faux_ev_compare_id,
+		sched->id_index, (uintptr_t)(unsigned int)ev_id, saved);
 }
 
 
@@ -443,6 +1071,10 @@ faux_ev_t *faux_sched_get_by_id(faux_sched_t *sched, int ev_id,
 faux_ev_t *faux_sched_get_by_data(faux_sched_t *sched, void *data,
 	faux_list_node_t **saved)
 {
-	return faux_sched_get_by_something(sched, data,
-		faux_ev_compare_data, saved);
+	assert(sched);
+	if (!sched)
+		return NULL;
+
+	return faux_sched_get_by_something(sched, data, faux_ev_compare_data,
+		sched->data_index, (uintptr_t)data, saved);
 }
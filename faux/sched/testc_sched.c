@@ -195,3 +195,426 @@ int testc_faux_sched_infinite(void)
 
 	return 0;
 }
+
+
+int testc_faux_sched_wheel(void)
+{
+	faux_sched_t *sched = NULL;
+	struct timespec res = {}; // Resolution is 1 msec
+	struct timespec now = {};
+	struct timespec t = {};
+	struct timespec offset = {};
+	struct timespec twait = {};
+	struct timespec max = {};
+	struct timespec max_allowed = {};
+	unsigned int ev_num = 1000;
+	unsigned int i = 0;
+	unsigned int popped = 0;
+	faux_ev_t *ev = NULL;
+	faux_ev_t *cancelled = NULL;
+
+	faux_nsec_to_timespec(&res, 1000000l);
+	faux_nsec_to_timespec(&max_allowed, 100000000l);
+	sched = faux_sched_new_wheel(&res);
+	if (!sched)
+		return -1;
+
+	// Events within 300 msec. It's enough to fill few levels of wheel.
+	// The odd events are cancelled.
+	faux_timespec_now(&now);
+	for (i = 0; i < ev_num; i++) {
+		faux_nsec_to_timespec(&offset, (i * 7919l % 300) * 1000000l);
+		faux_timespec_sum(&t, &now, &offset);
+		if (!(ev = faux_sched_once(sched, &t, i, NULL)))
+			return -1;
+		if (i % 2)
+			faux_sched_del(sched, ev);
+	}
+	// Far event
+	cancelled = faux_sched_once_delayed(sched,
+		&(struct timespec){3600, 0}, -1, NULL);
+	if (!cancelled)
+		return -1;
+
+	while (popped < (ev_num / 2)) {
+		if (!faux_sched_next_interval(sched, &twait)) {
+			printf("faux_sched_next_interval: No events\n");
+			return -1;
+		}
+		nanosleep(&twait, NULL);
+		while ((ev = faux_sched_pop(sched))) {
+			faux_timespec_now(&now);
+			if (faux_ev_id(ev) % 2) {
+				printf("faux_sched_pop: Cancelled event\n");
+				return -1;
+			}
+			if (faux_timespec_cmp(&now, faux_ev_time(ev)) < 0) {
+				printf("faux_sched_pop: Early event\n");
+				return -1;
+			}
+			faux_ev_free(ev);
+			popped++;
+		}
+	}
+	faux_sched_lateness(sched, NULL, &max);
+	if (faux_timespec_cmp(&max, &max_allowed) > 0) {
+		printf("faux_sched_lateness: Too late events\n");
+		return -1;
+	}
+
+	// Only far event is in the sched
+	if (faux_sched_del_by_id(sched, -1) != 1) {
+		printf("faux_sched_del_by_id: Can't delete far event\n");
+		return -1;
+	}
+	if (faux_sched_next_interval(sched, &twait)) {
+		printf("faux_sched_next_interval: Unexpected event\n");
+		return -1;
+	}
+
+	faux_sched_free(sched);
+
+	return 0;
+}
+
+
+int testc_faux_sched_heap(void)
+{
+	faux_sched_t *sched = NULL;
+	struct timespec now = {};
+	struct timespec t = {};
+	struct timespec offset = {};
+	struct timespec prev = {};
+	struct timespec twait = {};
+	unsigned int ev_num = 1000;
+	unsigned int i = 0;
+	unsigned int popped = 0;
+	int prev_id = -1;
+	faux_ev_t *ev = NULL;
+	faux_ev_t *evs[1000] = {};
+
+	sched = faux_sched_new_heap();
+	if (!sched)
+		return -1;
+
+	// Future events in shuffled order. Some events have equal time.
+	faux_timespec_now(&now);
+	for (i = 0; i < ev_num; i++) {
+		faux_nsec_to_timespec(&offset,
+			(1 + (i * 7919l % 100)) * 1000000000l);
+		faux_timespec_sum(&t, &now, &offset);
+		if (!(evs[i] = faux_sched_once(sched, &t, i, NULL)))
+			return -1;
+	}
+	if (!faux_sched_next_interval(sched, &twait))
+		return -1;
+	if (faux_timespec_cmp(&twait, &(struct timespec){0, 0}) <= 0) {
+		printf("faux_sched_next_interval: Wrong interval\n");
+		return -1;
+	}
+	// Cancel odd events and move the rest to the past
+	for (i = 0; i < ev_num; i++) {
+		if (i % 2) {
+			faux_sched_del(sched, evs[i]);
+			continue;
+		}
+		faux_timespec_diff(&t, faux_ev_time(evs[i]), &offset);
+		faux_nsec_to_timespec(&offset, 1000000000000l);
+		faux_timespec_diff(&t, &now, &offset);
+		faux_nsec_to_timespec(&offset, (i * 7919l % 100) * 1000l);
+		faux_timespec_sum(&t, &t, &offset);
+		if (!faux_sched_reschedule(sched, evs[i], &t)) {
+			printf("faux_sched_reschedule: Can't reschedule\n");
+			return -1;
+		}
+	}
+
+	// Events must be popped in order of time. Equal events are popped
+	// in order of adding.
+	while ((ev = faux_sched_pop(sched))) {
+		int id = faux_ev_id(ev);
+		int cmp = faux_timespec_cmp(&prev, faux_ev_time(ev));
+		if (id % 2) {
+			printf("faux_sched_pop: Cancelled event\n");
+			return -1;
+		}
+		if ((popped > 0) && ((cmp > 0) || ((0 == cmp) && (id < prev_id)))) {
+			printf("faux_sched_pop: Wrong order\n");
+			return -1;
+		}
+		prev = *faux_ev_time(ev);
+		prev_id = id;
+		faux_ev_free(ev);
+		popped++;
+	}
+	if (popped != (ev_num / 2)) {
+		printf("faux_sched_pop: Popped %u events\n", popped);
+		return -1;
+	}
+	if (faux_sched_next_interval(sched, &twait)) {
+		printf("faux_sched_next_interval: Unexpected event\n");
+		return -1;
+	}
+
+	faux_sched_free(sched);
+
+	return 0;
+}
+
+
+
+int testc_faux_sched_index(void)
+{
+	faux_sched_t *sched = NULL;
+	faux_list_node_t *saved = NULL;
+	unsigned int ev_num = 1000;
+	unsigned int i = 0;
+	unsigned int found = 0;
+	faux_ev_t *ev = NULL;
+	char data[10] = {};
+
+	sched = faux_sched_new_heap();
+	if (!sched)
+		return -1;
+
+	// Some events are scheduled before index creation
+	for (i = 0; i < ev_num; i++) {
+		if (i == (ev_num / 2)) {
+			if (!faux_sched_add_index(sched, FAUX_SCHED_INDEX_ID) ||
+				!faux_sched_add_index(sched, FAUX_SCHED_INDEX_DATA)) {
+				printf("faux_sched_add_index: Can't add index\n");
+				return -1;
+			}
+		}
+		if (!faux_sched_once_delayed(sched, &(struct timespec){3600, 0},
+			i % 10, &data[i % 7]))
+			return -1;
+	}
+
+	// Get events by ID
+	saved = faux_sched_init_ev_iter(sched);
+	while ((ev = faux_sched_get_by_id(sched, 3, &saved))) {
+		if (faux_ev_id(ev) != 3) {
+			printf("faux_sched_get_by_id: Wrong event\n");
+			return -1;
+		}
+		found++;
+	}
+	if (found != (ev_num / 10)) {
+		printf("faux_sched_get_by_id: Found %u events\n", found);
+		return -1;
+	}
+
+	// Delete events by data
+	if (faux_sched_del_by_data(sched, &data[2]) != 143) {
+		printf("faux_sched_del_by_data: Wrong number of events\n");
+		return -1;
+	}
+	found = 0;
+	saved = faux_sched_init_ev_iter(sched);
+	while ((ev = faux_sched_get_by_data(sched, &data[2], &saved)))
+		found++;
+	if (found != 0) {
+		printf("faux_sched_get_by_data: Deleted events are found\n");
+		return -1;
+	}
+
+	// Delete events by ID. Some of them are already deleted by data.
+	if (faux_sched_del_by_id(sched, 2) != 85) {
+		printf("faux_sched_del_by_id: Wrong number of events\n");
+		return -1;
+	}
+	if (faux_sched_del_by_id(sched, 2) != 0) {
+		printf("faux_sched_del_by_id: Events are deleted twice\n");
+		return -1;
+	}
+
+	// Event scheduled within another sched is not deleted
+	{
+		faux_sched_t *other = faux_sched_new_heap();
+		faux_ev_t *foreign = faux_sched_once_delayed(other,
+			&(struct timespec){3600, 0}, 1, NULL);
+
+		if (faux_sched_del(sched, foreign) != 0) {
+			printf("faux_sched_del: Foreign event is deleted\n");
+			return -1;
+		}
+		if (faux_sched_del(other, foreign) != 1) {
+			printf("faux_sched_del: Can't delete event\n");
+			return -1;
+		}
+		faux_sched_free(other);
+	}
+
+	faux_sched_del_all(sched);
+	saved = faux_sched_init_ev_iter(sched);
+	if (faux_sched_get_by_id(sched, 3, &saved)) {
+		printf("faux_sched_get_by_id: Event after empty operation\n");
+		return -1;
+	}
+
+	faux_sched_free(sched);
+
+	return 0;
+}
+
+
+static int sched_slack_test(faux_sched_t *sched)
+{
+	struct timespec now = {1000, 0};
+	struct timespec t = {};
+	struct timespec twait = {};
+	faux_ev_t *ev = NULL;
+	unsigned int popped = 0;
+
+	faux_sched_set_now(sched, &now);
+	// Events at +1s, +2s and +3s. The first one can be delayed up to 2.5s
+	// so the first and second events are popped by single wakeup.
+	ev = faux_sched_once_delayed(sched, &(struct timespec){1, 0}, 1, NULL);
+	faux_ev_set_slack(ev, &(struct timespec){2, 500000000l});
+	faux_sched_once_delayed(sched, &(struct timespec){2, 0}, 2, NULL);
+	faux_sched_once_delayed(sched, &(struct timespec){3, 0}, 3, NULL);
+
+	if (!faux_sched_next_interval(sched, &twait))
+		return -1;
+	if (faux_timespec_cmp(&twait, &(struct timespec){2, 0}) != 0) {
+		printf("faux_sched_next_interval: Wrong interval %ld.%09ld\n",
+			(long)twait.tv_sec, twait.tv_nsec);
+		return -1;
+	}
+	faux_timespec_sum(&t, &now, &twait);
+	faux_sched_set_now(sched, &t);
+	while ((ev = faux_sched_pop(sched))) {
+		faux_ev_free(ev);
+		popped++;
+	}
+	if (popped != 2) {
+		printf("faux_sched_pop: Popped %u events\n", popped);
+		return -1;
+	}
+	if (faux_sched_saved_wakeups(sched) != 1) {
+		printf("faux_sched_saved_wakeups: Wrong number\n");
+		return -1;
+	}
+	// The last event has no slack
+	if (!faux_sched_next_interval(sched, &twait) ||
+		(faux_timespec_cmp(&twait, &(struct timespec){1, 0}) != 0)) {
+		printf("faux_sched_next_interval: Wrong interval\n");
+		return -1;
+	}
+
+	// Limited number of events per pass. Every pass is separate wakeup.
+	ev = faux_sched_once_delayed(sched, &(struct timespec){4, 0}, 4, NULL);
+	faux_ev_set_slack(ev, &(struct timespec){5, 0});
+	faux_sched_once_delayed(sched, &(struct timespec){5, 0}, 5, NULL);
+	faux_sched_set_now(sched, &(struct timespec){1010, 0});
+	popped = 0;
+	faux_sched_start_pass(sched);
+	while ((ev = faux_sched_pop(sched))) {
+		faux_ev_free(ev);
+		popped++;
+		faux_sched_start_pass(sched);
+	}
+	if (popped != 3) {
+		printf("faux_sched_pop: Popped %u events\n", popped);
+		return -1;
+	}
+	if (faux_sched_saved_wakeups(sched) != 1) {
+		printf("faux_sched_saved_wakeups: Wrong number after passes\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+
+int testc_faux_sched_slack(void)
+{
+	faux_sched_t *sched = NULL;
+	int ret = 0;
+
+	sched = faux_sched_new();
+	if (sched_slack_test(sched) < 0)
+		ret = -1;
+	faux_sched_free(sched);
+
+	sched = faux_sched_new_heap();
+	if (sched_slack_test(sched) < 0)
+		ret = -1;
+	faux_sched_free(sched);
+
+	return ret;
+}
+
+
+static int sched_backwards_test(faux_sched_t *sched)
+{
+	faux_ev_t *ev = NULL;
+	faux_ev_t *ev2 = NULL;
+	faux_list_node_t *saved = NULL;
+
+	faux_sched_set_now(sched, &(struct timespec){1000, 0});
+	faux_sched_once_delayed(sched, &(struct timespec){1, 0}, 1, NULL);
+	ev2 = faux_sched_once_delayed(sched, &(struct timespec){2, 0}, 2, NULL);
+
+	// Both events are expired but only the first one is popped
+	faux_sched_set_now(sched, &(struct timespec){1003, 0});
+	ev = faux_sched_pop(sched);
+	if (!ev || (faux_ev_id(ev) != 1)) {
+		printf("faux_sched_pop: Can't pop the first event\n");
+		return -1;
+	}
+	faux_ev_free(ev);
+
+	// Time goes backwards. The second event is not expired now.
+	faux_sched_set_now(sched, &(struct timespec){1000, 0});
+	if (faux_sched_pop(sched)) {
+		printf("faux_sched_pop: Early event\n");
+		return -1;
+	}
+	saved = faux_sched_init_ev_iter(sched);
+	if (!faux_ev_is_busy(ev2) ||
+		(faux_sched_get_by_id(sched, 2, &saved) != ev2)) {
+		printf("faux_sched_pop: Event is lost\n");
+		return -1;
+	}
+
+	// Event is still scheduled
+	faux_sched_set_now(sched, &(struct timespec){1003, 0});
+	ev = faux_sched_pop(sched);
+	if (ev != ev2) {
+		printf("faux_sched_pop: Can't pop the second event\n");
+		return -1;
+	}
+	faux_ev_free(ev);
+	if (faux_sched_pop(sched)) {
+		printf("faux_sched_pop: Unexpected event\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+
+int testc_faux_sched_backwards(void)
+{
+	faux_sched_t *sched = NULL;
+	int ret = 0;
+
+	sched = faux_sched_new();
+	if (sched_backwards_test(sched) < 0)
+		ret = -1;
+	faux_sched_free(sched);
+
+	sched = faux_sched_new_heap();
+	if (sched_backwards_test(sched) < 0)
+		ret = -1;
+	faux_sched_free(sched);
+
+	sched = faux_sched_new_wheel(&(struct timespec){0, 1000000l});
+	if (sched_backwards_test(sched) < 0)
+		ret = -1;
+	faux_sched_free(sched);
+
+	return ret;
+}
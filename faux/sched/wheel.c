@@ -0,0 +1,403 @@
+/** @file wheel.c
+ * @brief Hierarchical timing wheel to order scheduled events.
+ *
+ * The time is divided into ticks. The length of tick (resolution) is
+ * specified by user. The wheel consists of WHEEL_LEVELS levels. Each level
+ * has WHEEL_SIZE slots. The slot of level 0 is a single tick. The slot of
+ * level N covers WHEEL_SIZE slots of level (N - 1). Each slot is a list of
+ * events. When the lower level makes a full turn the appropriate slot of
+ * upper level is cascaded i.e. its events are redistributed to lower levels.
+ * The events from the current slot of level 0 are moved to the "ready" list.
+ *
+ * The add, delete and expire operations are O(1). The bitmap of non-empty
+ * slots for each level allows to find next non-empty slot quickly. The
+ * event is never popped before its planned time but it can be late up to
+ * single resolution tick. The events within the same tick are not ordered.
+ */
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "private.h"
+#include "faux/faux.h"
+#include "faux/time.h"
+#include "faux/sched.h"
+
+
+/** @brief Inits empty circular list.
+ *
+ * @param [in] head List head.
+ */
+static void link_init(faux_sched_link_t *head)
+{
+	head->prev = head;
+	head->next = head;
+}
+
+
+/** @brief Checks if circular list is empty.
+ *
+ * @param [in] head List head.
+ * @return BOOL_TRUE if list is empty, BOOL_FALSE else.
+ */
+static bool_t link_is_empty(const faux_sched_link_t *head)
+{
+	return (head->next == head) ? BOOL_TRUE : BOOL_FALSE;
+}
+
+
+/** @brief Adds link to the tail of circular list.
+ *
+ * @param [in] head List head.
+ * @param [in] link Link to add.
+ */
+static void link_add_tail(faux_sched_link_t *head, faux_sched_link_t *link)
+{
+	link->prev = head->prev;
+	link->next = head;
+	head->prev->next = link;
+	head->prev = link;
+}
+
+
+/** @brief Removes link from circular list.
+ *
+ * @param [in] link Link to remove.
+ */
+static void link_del(faux_sched_link_t *link)
+{
+	link->prev->next = link->next;
+	link->next->prev = link->prev;
+	link->prev = link;
+	link->next = link;
+}
+
+
+/** @brief Gets event by its link.
+ *
+ * @param [in] link Link embedded into event.
+ * @return Event.
+ */
+static faux_ev_t *link_ev(faux_sched_link_t *link)
+{
+	return (faux_ev_t *)((char *)link - offsetof(faux_ev_t, link));
+}
+
+
+/** @brief Converts timespec to ticks.
+ *
+ * @param [in] wheel Timing wheel.
+ * @param [in] ts Time.
+ * @param [in] round_up Round up if BOOL_TRUE or round down else.
+ * @return Number of ticks.
+ */
+static uint64_t wheel_ticks(const faux_sched_wheel_t *wheel,
+	const struct timespec *ts, bool_t round_up)
+{
+	uint64_t nsec = faux_timespec_to_nsec(ts);
+
+	if (round_up)
+		return (nsec / wheel->resolution) +
+			((nsec % wheel->resolution) ? 1 : 0);
+
+	return nsec / wheel->resolution;
+}
+
+
+/** @brief Allocates new timing wheel.
+ *
+ * @param [in] resolution Length of tick. Must be non-zero.
+ * @param [in] now Current time.
+ * @return Allocated timing wheel or NULL on error.
+ */
+faux_sched_wheel_t *faux_sched_wheel_new(
+	const struct timespec *resolution, const struct timespec *now)
+{
+	faux_sched_wheel_t *wheel = NULL;
+
+	assert(resolution);
+	assert(now);
+	if (!resolution || !now)
+		return NULL;
+	if (faux_timespec_to_nsec(resolution) == 0)
+		return NULL;
+
+	wheel = faux_zmalloc(sizeof(*wheel));
+	if (!wheel)
+		return NULL;
+
+	// Init
+	wheel->resolution = faux_timespec_to_nsec(resolution);
+	faux_sched_wheel_clear(wheel);
+	wheel->tick = wheel_ticks(wheel, now, BOOL_FALSE);
+
+	return wheel;
+}
+
+
+/** @brief Frees timing wheel.
+ *
+ * Doesn't free events.
+ *
+ * @param [in] wheel Timing wheel.
+ */
+void faux_sched_wheel_free(faux_sched_wheel_t *wheel)
+{
+	if (!wheel)
+		return;
+
+	faux_free(wheel);
+}
+
+
+/** @brief Forgets all events linked to timing wheel.
+ *
+ * Doesn't free events.
+ *
+ * @param [in] wheel Timing wheel.
+ */
+void faux_sched_wheel_clear(faux_sched_wheel_t *wheel)
+{
+	unsigned int level = 0;
+	unsigned int slot = 0;
+
+	assert(wheel);
+	if (!wheel)
+		return;
+
+	for (level = 0; level < WHEEL_LEVELS; level++) {
+		wheel->bitmap[level] = 0;
+		for (slot = 0; slot < WHEEL_SIZE; slot++)
+			link_init(&wheel->slots[level][slot]);
+	}
+	link_init(&wheel->ready);
+}
+
+
+/** @brief Links event to timing wheel.
+ *
+ * The slot is chosen by the distance between current tick and the
+ * event's tick. The already expired event goes to "ready" list.
+ *
+ * @param [in] wheel Timing wheel.
+ * @param [in] ev Event to add.
+ */
+void faux_sched_wheel_add(faux_sched_wheel_t *wheel, faux_ev_t *ev)
+{
+	uint64_t delta = 0;
+	uint64_t tick = 0;
+	unsigned int level = 0;
+
+	assert(wheel);
+	assert(ev);
+	if (!wheel || !ev)
+		return;
+
+	// Event can't be popped before planned time so round up
+	ev->tick = wheel_ticks(wheel, faux_ev_time(ev), BOOL_TRUE);
+	if (ev->tick < wheel->tick) {
+		ev->level = WHEEL_READY;
+		link_add_tail(&wheel->ready, &ev->link);
+		return;
+	}
+
+	delta = ev->tick - wheel->tick;
+	tick = ev->tick;
+	for (level = 0; level < (WHEEL_LEVELS - 1); level++) {
+		if (delta < (1ull << (WHEEL_BITS * (level + 1))))
+			break;
+	}
+	// Too far event. It will be cascaded to the same level
+	// again and again until the distance become reachable.
+	if (delta >= (1ull << (WHEEL_BITS * WHEEL_LEVELS)))
+		tick = wheel->tick + (1ull << (WHEEL_BITS * WHEEL_LEVELS)) - 1;
+
+	ev->level = level;
+	ev->slot = (tick >> (WHEEL_BITS * level)) & WHEEL_MASK;
+	link_add_tail(&wheel->slots[level][ev->slot], &ev->link);
+	wheel->bitmap[level] |= (1ull << ev->slot);
+}
+
+
+/** @brief Unlinks event from timing wheel.
+ *
+ * @param [in] wheel Timing wheel.
+ * @param [in] ev Event to remove.
+ */
+void faux_sched_wheel_del(faux_sched_wheel_t *wheel, faux_ev_t *ev)
+{
+	assert(wheel);
+	assert(ev);
+	if (!wheel || !ev)
+		return;
+
+	link_del(&ev->link);
+	if (ev->level == WHEEL_READY)
+		return;
+	if (link_is_empty(&wheel->slots[ev->level][ev->slot]))
+		wheel->bitmap[ev->level] &= ~(1ull << ev->slot);
+}
+
+
+/** @brief Processes current tick and moves wheel forward by one tick.
+ *
+ * Cascades upper levels slots if lower levels make a full turn. Then moves
+ * events of current level 0 slot to "ready" list.
+ *
+ * @param [in] wheel Timing wheel.
+ */
+static void wheel_process_tick(faux_sched_wheel_t *wheel)
+{
+	uint64_t tick = wheel->tick;
+	unsigned int level = 0;
+	unsigned int slot = 0;
+	faux_sched_link_t *head = NULL;
+
+	for (level = 1; level < WHEEL_LEVELS; level++) {
+		if (tick & ((1ull << (WHEEL_BITS * level)) - 1))
+			break; // Lower level doesn't make a full turn
+		slot = (tick >> (WHEEL_BITS * level)) & WHEEL_MASK;
+		head = &wheel->slots[level][slot];
+		wheel->bitmap[level] &= ~(1ull << slot);
+		while (!link_is_empty(head)) {
+			faux_ev_t *ev = link_ev(head->next);
+			link_del(&ev->link);
+			faux_sched_wheel_add(wheel, ev);
+		}
+	}
+
+	slot = tick & WHEEL_MASK;
+	head = &wheel->slots[0][slot];
+	wheel->bitmap[0] &= ~(1ull << slot);
+	while (!link_is_empty(head)) {
+		faux_ev_t *ev = link_ev(head->next);
+		link_del(&ev->link);
+		ev->level = WHEEL_READY;
+		link_add_tail(&wheel->ready, &ev->link);
+	}
+
+	wheel->tick++;
+}
+
+
+/** @brief Finds the nearest tick when something must be done.
+ *
+ * It's the tick of the nearest non-empty level 0 slot or the tick of the
+ * nearest cascading of non-empty upper level slot. Anyway the events can't
+ * expire earlier than found tick.
+ *
+ * @param [in] wheel Timing wheel.
+ * @param [out] next Found tick.
+ * @return BOOL_TRUE if found, BOOL_FALSE if wheel has no events.
+ */
+static bool_t wheel_next_tick(const faux_sched_wheel_t *wheel, uint64_t *next)
+{
+	unsigned int level = 0;
+	bool_t found = BOOL_FALSE;
+
+	for (level = 0; level < WHEEL_LEVELS; level++) {
+		unsigned int shift = WHEEL_BITS * level;
+		unsigned int cur = (wheel->tick >> shift) & WHEEL_MASK;
+		uint64_t bitmap = wheel->bitmap[level];
+		uint64_t tick = 0;
+		unsigned int dist = 0;
+
+		if (!bitmap)
+			continue;
+		// Rotate bitmap to make current slot the bit 0
+		if (cur)
+			bitmap = (bitmap >> cur) | (bitmap << (WHEEL_SIZE - cur));
+		dist = __builtin_ctzll(bitmap);
+		if (0 == level) {
+			tick = wheel->tick + dist;
+		} else {
+			// The current slot of upper level contains events for
+			// the next turn if its cascading moment is gone.
+			if ((0 == dist) &&
+				(wheel->tick & ((1ull << shift) - 1))) {
+				bitmap &= ~1ull;
+				dist = bitmap ? __builtin_ctzll(bitmap) :
+					WHEEL_SIZE;
+			}
+			tick = ((wheel->tick >> shift) + dist) << shift;
+		}
+		if (!found || (tick < *next)) {
+			*next = tick;
+			found = BOOL_TRUE;
+		}
+	}
+
+	return found;
+}
+
+
+/** @brief Pops expired event from timing wheel.
+ *
+ * Moves wheel forward up to current time while there are no expired events.
+ * The empty ticks are skipped without processing.
+ *
+ * @param [in] wheel Timing wheel.
+ * @param [in] now Current time.
+ * @return Expired event unlinked from the wheel or NULL.
+ */
+faux_ev_t *faux_sched_wheel_pop(faux_sched_wheel_t *wheel,
+	const struct timespec *now)
+{
+	uint64_t now_tick = 0;
+	faux_ev_t *ev = NULL;
+
+	assert(wheel);
+	assert(now);
+	if (!wheel || !now)
+		return NULL;
+
+	now_tick = wheel_ticks(wheel, now, BOOL_FALSE);
+	while (link_is_empty(&wheel->ready)) {
+		uint64_t next = 0;
+
+		if (wheel->tick > now_tick)
+			return NULL;
+		if (!wheel_next_tick(wheel, &next) || (next > now_tick)) {
+			wheel->tick = now_tick + 1; // Nothing to do till now
+			return NULL;
+		}
+		if (next > wheel->tick)
+			wheel->tick = next; // Skip empty ticks
+		wheel_process_tick(wheel);
+	}
+
+	ev = link_ev(wheel->ready.next);
+	link_del(&ev->link);
+
+	return ev;
+}
+
+
+/** @brief Gets the earliest time when event can expire.
+ *
+ * @param [in] wheel Timing wheel.
+ * @param [out] time Time of the nearest event.
+ * @return BOOL_TRUE if found, BOOL_FALSE if wheel has no events.
+ */
+bool_t faux_sched_wheel_next(const faux_sched_wheel_t *wheel,
+	struct timespec *time)
+{
+	uint64_t next = 0;
+
+	assert(wheel);
+	assert(time);
+	if (!wheel || !time)
+		return BOOL_FALSE;
+
+	if (!link_is_empty(&wheel->ready)) {
+		faux_nsec_to_timespec(time, 0);
+		return BOOL_TRUE;
+	}
+	if (!wheel_next_tick(wheel, &next))
+		return BOOL_FALSE;
+	faux_nsec_to_timespec(time, next * wheel->resolution);
+
+	return BOOL_TRUE;
+}
@@ -26,6 +26,7 @@ const char *testc_module[][2] = {
 	{"testc_faux_argv_parse", "Parse string to arguments"},
 	{"testc_faux_argv_is_continuable", "Is line continuable"},
 	{"testc_faux_argv_index", "Get argument by index"},
+	{"testc_faux_argv_index_seq", "Sequential access to large argv by index"},
 
 	// time
 	{"testc_faux_nsec_timespec_conversion", "Converts nsec from/to struct timespec"},
@@ -37,17 +38,56 @@ const char *testc_module[][2] = {
 	{"testc_faux_sched_once", "Schedule once event. Simple and delayed ones."},
 	{"testc_faux_sched_periodic", "Schedule periodic event."},
 	{"testc_faux_sched_infinite", "Schedule infinite number of events."},
+	{"testc_faux_sched_wheel", "Timing wheel based scheduler."},
+	{"testc_faux_sched_heap", "Heap based scheduler."},
+	{"testc_faux_sched_index", "Scheduler indexes by ID and data."},
+	{"testc_faux_sched_slack", "Timer coalescing with event slack."},
+	{"testc_faux_sched_backwards", "Current time goes backwards."},
 
 	// log
 	{"testc_faux_log_facility_id", "Converts syslog facility string to id"},
 	{"testc_faux_log_facility_str", "Converts syslog facility id to string"},
 
+	// list
+	{"testc_faux_list_slab", "List with nodes allocated by slabs"},
+	{"testc_faux_list_skiplist", "Sorted list with skip list index"},
+	{"testc_faux_list_hash", "Unsorted list with hash table"},
+	{"testc_faux_list_bulk", "Bulk add, sort and merge of lists"},
+	{"testc_faux_list_index", "Access to list items by index"},
+	{"testc_faux_ulist", "Unrolled list"},
+	{"testc_faux_ulist_bench", "Benchmark of list and unrolled list"},
+	{"testc_faux_ilist", "Intrusive list"},
+
 	// vec
 	{"testc_faux_vec", "Complex test of variable length vector"},
+	{"testc_faux_vec_capacity", "Capacity of variable length vector"},
+	{"testc_faux_vec_sorted", "Sorted variable length vector"},
+
+	// net
+	{"testc_faux_pollfd", "Vector of pollfd items"},
+
+	// eloop
+	{"testc_faux_eloop_poll", "Event loop. The poll() backend"},
+	{"testc_faux_eloop_epoll", "Event loop. The epoll() backend"},
+	{"testc_faux_eloop_uring", "Event loop. The io_uring backend"},
+	{"testc_faux_eloop_uring_async", "Event loop. Async I/O by io_uring completions"},
+	{"testc_faux_eloop_uring_async_del", "Event loop. Deletion of idle io_uring async fd"},
+	{"testc_faux_eloop_busy_fd", "Event loop. Scheduled events and busy fd"},
+	{"testc_faux_eloop_stats", "Event loop. Statistics"},
+	{"testc_faux_eloop_now", "Event loop. Cached loop time"},
+	{"testc_faux_eloop_abs_time", "Event loop. Absolute time of event added by callback"},
+	{"testc_faux_eloop_post", "Event loop. Tasks posted by other threads"},
+	{"testc_faux_eloop_defer", "Event loop. Deferred and idle calls"},
+	{"testc_faux_eloop_busy_poll", "Event loop. Adaptive busy poll"},
+	{"testc_faux_eloop_prio", "Event loop. Fd priorities and requeue"},
+	{"testc_faux_eloop_prio_change", "Event loop. Priority change within dispatch pass"},
+	{"testc_faux_eloop_reuse_fd", "Event loop. Fd number reused within dispatch pass"},
+	{"testc_faux_eloop_group", "Event loop. Group of loops within threads"},
 
 	// async
 	{"testc_faux_async_write", "Async write operations"},
 	{"testc_faux_async_read", "Async read operations"},
+	{"testc_faux_async_read_budget", "Async read with budget"},
 
 	// buf
 	{"testc_faux_buf", "Dynamic buffer"},
@@ -0,0 +1,55 @@
+/** @file ulist.h
+ * @brief Public interface for an unrolled list.
+ */
+
+#ifndef _faux_ulist_h
+#define _faux_ulist_h
+
+#include <stddef.h>
+
+#include <faux/faux.h>
+#include <faux/list.h>
+
+typedef struct faux_ulist_chunk_s faux_ulist_chunk_t;
+typedef struct faux_ulist_s faux_ulist_t;
+
+// Iterator. Position of item within unrolled list.
+typedef struct faux_ulist_iter_s {
+	faux_ulist_chunk_t *chunk;
+	unsigned int pos;
+} faux_ulist_iter_t;
+
+C_DECL_BEGIN
+
+faux_ulist_t *faux_ulist_new(faux_list_sorted_e sorted,
+	faux_list_unique_e unique,
+	faux_list_cmp_fn cmpFn, faux_list_kcmp_fn kcmpFn,
+	faux_list_free_fn freeFn);
+void faux_ulist_free(faux_ulist_t *list);
+
+size_t faux_ulist_len(const faux_ulist_t *list);
+bool_t faux_ulist_is_empty(const faux_ulist_t *list);
+
+void faux_ulist_head(const faux_ulist_t *list, faux_ulist_iter_t *iter);
+void faux_ulist_tail(const faux_ulist_t *list, faux_ulist_iter_t *iter);
+void *faux_ulist_each(faux_ulist_iter_t *iter);
+void *faux_ulist_eachr(faux_ulist_iter_t *iter);
+
+bool_t faux_ulist_add(faux_ulist_t *list, void *data);
+bool_t faux_ulist_kdel(faux_ulist_t *list, const void *userkey);
+ssize_t faux_ulist_del_all(faux_ulist_t *list);
+
+void *faux_ulist_match(const faux_ulist_t *list,
+	faux_list_kcmp_fn matchFn, const void *userkey,
+	faux_ulist_iter_t *iter);
+void *faux_ulist_kmatch(const faux_ulist_t *list,
+	const void *userkey, faux_ulist_iter_t *iter);
+void *faux_ulist_find(const faux_ulist_t *list,
+	faux_list_kcmp_fn matchFn, const void *userkey);
+void *faux_ulist_kfind(const faux_ulist_t *list,
+	const void *userkey);
+void *faux_ulist_index(const faux_ulist_t *list, size_t index);
+
+C_DECL_END
+
+#endif				/* _faux_ulist_h */
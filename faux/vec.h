@@ -12,6 +12,7 @@
 typedef struct faux_vec_s faux_vec_t;
 
 typedef int (*faux_vec_kcmp_fn)(const void *key, const void *item);
+typedef int (*faux_vec_cmp_fn)(const void *first, const void *second);
 
 C_DECL_BEGIN
 
@@ -19,14 +20,23 @@ faux_vec_t *faux_vec_new(size_t item_size, faux_vec_kcmp_fn matchFn);
 void faux_vec_free(faux_vec_t *faux_vec);
 size_t faux_vec_len(const faux_vec_t *faux_vec);
 size_t faux_vec_item_size(const faux_vec_t *faux_vec);
+size_t faux_vec_capacity(const faux_vec_t *faux_vec);
+bool_t faux_vec_reserve(faux_vec_t *faux_vec, size_t capacity);
+bool_t faux_vec_shrink_to_fit(faux_vec_t *faux_vec);
 void *faux_vec_item(const faux_vec_t *faux_vec, unsigned int index);
 void *faux_vec_data(const faux_vec_t *faux_vec);
 void *faux_vec_add(faux_vec_t *faux_vec);
+void *faux_vec_insert(faux_vec_t *faux_vec, unsigned int index);
+void *faux_vec_add_sorted(faux_vec_t *faux_vec, const void *userkey);
 ssize_t faux_vec_del(faux_vec_t *faux_vec, unsigned int index);
 int faux_vec_find_fn(const faux_vec_t *faux_vec, faux_vec_kcmp_fn matchFn,
 	const void *userkey, unsigned int start_index);
 int faux_vec_find(const faux_vec_t *faux_vec, const void *userkey,
 	unsigned int start_index);
+void faux_vec_sort(faux_vec_t *faux_vec, faux_vec_cmp_fn cmpFn);
+int faux_vec_lower_bound(const faux_vec_t *faux_vec, const void *userkey);
+int faux_vec_upper_bound(const faux_vec_t *faux_vec, const void *userkey);
+int faux_vec_bsearch(const faux_vec_t *faux_vec, const void *userkey);
 void faux_vec_del_all(faux_vec_t *faux_vec);
 
 C_DECL_END
@@ -3,6 +3,8 @@
 struct faux_vec_s {
 	void *data;
 	size_t len;
+	size_t capacity; // Number of allocated items
+	size_t reserved; // Capacity kept by shrinking. See faux_vec_reserve()
 	size_t item_size;
 	faux_vec_kcmp_fn kcmpFn; // Function to compare key and vector's item
 };
@@ -100,3 +100,167 @@ err:
 
 	return ret;
 }
+
+
+#define VEC_BIG_LEN 1000
+int testc_faux_vec_capacity(void)
+{
+	unsigned int i = 0;
+	unsigned int reallocs = 0;
+	size_t capacity = 0;
+	int ret = -1; // Pessimistic return value
+	faux_vec_t *vec = NULL;
+
+	vec = faux_vec_new(sizeof(uint32_t), kmatch);
+
+	// Geometric growth. Number of reallocations is logarithmic.
+	for (i = 0; i < VEC_BIG_LEN; i++) {
+		*(uint32_t *)faux_vec_add(vec) = i;
+		if (faux_vec_capacity(vec) != capacity) {
+			capacity = faux_vec_capacity(vec);
+			reallocs++;
+		}
+	}
+	if ((reallocs > 10) || (faux_vec_capacity(vec) < VEC_BIG_LEN)) {
+		fprintf(stderr, "Too many reallocations: %u\n", reallocs);
+		goto err;
+	}
+
+	// Hysteresis. Deletion of single item doesn't shrink vector.
+	faux_vec_del(vec, 0);
+	if (faux_vec_capacity(vec) != capacity) {
+		fprintf(stderr, "Vector is shrinked too early\n");
+		goto err;
+	}
+	while (faux_vec_len(vec) > (capacity / 4))
+		faux_vec_del(vec, faux_vec_len(vec) - 1);
+	if (faux_vec_capacity(vec) != (capacity / 2)) {
+		fprintf(stderr, "Vector is not shrinked\n");
+		goto err;
+	}
+	// Items are kept
+	for (i = 0; i < faux_vec_len(vec); i++) {
+		if (*(uint32_t *)faux_vec_item(vec, i) != (i + 1)) {
+			fprintf(stderr, "Broken item after shrink\n");
+			goto err;
+		}
+	}
+
+	// Reserved space is not shrinked
+	faux_vec_del_all(vec);
+	faux_vec_reserve(vec, VEC_BIG_LEN);
+	if (faux_vec_capacity(vec) != VEC_BIG_LEN) {
+		fprintf(stderr, "Broken reserve\n");
+		goto err;
+	}
+	for (i = 0; i < VEC_BIG_LEN; i++)
+		*(uint32_t *)faux_vec_add(vec) = i;
+	while (faux_vec_len(vec) > 0)
+		faux_vec_del(vec, 0);
+	if (faux_vec_capacity(vec) != VEC_BIG_LEN) {
+		fprintf(stderr, "Reserved space is shrinked\n");
+		goto err;
+	}
+
+	// Shrink to fit
+	*(uint32_t *)faux_vec_add(vec) = 1;
+	faux_vec_shrink_to_fit(vec);
+	if ((faux_vec_capacity(vec) != 1) ||
+		(*(uint32_t *)faux_vec_item(vec, 0) != 1)) {
+		fprintf(stderr, "Broken shrink to fit\n");
+		goto err;
+	}
+
+	ret = 0;
+err:
+	faux_vec_free(vec);
+
+	return ret;
+}
+
+
+static int vec_kcmp(const void *key, const void *item)
+{
+	uint32_t k = *(uint32_t *)key;
+	uint32_t i = *(uint32_t *)item;
+	if (k < i)
+		return -1;
+	if (k > i)
+		return 1;
+	return 0;
+}
+
+
+static int vec_cmp(const void *first, const void *second)
+{
+	return vec_kcmp(first, second);
+}
+
+
+#define VEC_SORTED_LEN 100
+int testc_faux_vec_sorted(void)
+{
+	unsigned int i = 0;
+	uint32_t key = 0;
+	int ret = -1; // Pessimistic return value
+	faux_vec_t *vec = NULL;
+
+	// Fill the vector with even numbers in reverse order and sort it
+	vec = faux_vec_new(sizeof(uint32_t), vec_kcmp);
+	for (i = 0; i < VEC_SORTED_LEN; i++)
+		*(uint32_t *)faux_vec_add(vec) = (VEC_SORTED_LEN - 1 - i) * 2;
+	faux_vec_sort(vec, vec_cmp);
+	for (i = 0; i < VEC_SORTED_LEN; i++) {
+		if (*(uint32_t *)faux_vec_item(vec, i) != (i * 2)) {
+			fprintf(stderr, "Broken sort\n");
+			goto err;
+		}
+	}
+
+	// Binary search
+	key = 42;
+	if (faux_vec_bsearch(vec, &key) != 21) {
+		fprintf(stderr, "Can't find item by binary search\n");
+		goto err;
+	}
+	key = 43;
+	if (faux_vec_bsearch(vec, &key) >= 0) {
+		fprintf(stderr, "Found unexistent item\n");
+		goto err;
+	}
+
+	// Sorted insert
+	key = 43;
+	*(uint32_t *)faux_vec_add_sorted(vec, &key) = key;
+	key = 42;
+	*(uint32_t *)faux_vec_add_sorted(vec, &key) = key;
+	key = VEC_SORTED_LEN * 2;
+	*(uint32_t *)faux_vec_add_sorted(vec, &key) = key;
+	for (i = 1; i < faux_vec_len(vec); i++) {
+		if (*(uint32_t *)faux_vec_item(vec, i - 1) >
+			*(uint32_t *)faux_vec_item(vec, i)) {
+			fprintf(stderr, "Broken sorted insert\n");
+			goto err;
+		}
+	}
+
+	// Bounds of duplicate keys
+	key = 42;
+	if ((faux_vec_bsearch(vec, &key) != 21) ||
+		(faux_vec_lower_bound(vec, &key) != 21) ||
+		(faux_vec_upper_bound(vec, &key) != 23)) {
+		fprintf(stderr, "Broken bounds\n");
+		goto err;
+	}
+	key = VEC_SORTED_LEN * 3;
+	if (faux_vec_lower_bound(vec, &key) != (int)faux_vec_len(vec)) {
+		fprintf(stderr, "Broken bound of the biggest key\n");
+		goto err;
+	}
+
+	ret = 0;
+err:
+	faux_vec_free(vec);
+
+	return ret;
+}
@@ -1,5 +1,19 @@
 /** @file vec.c
  * Implementation of variable length vector of arbitrary structures.
+ *
+ * The allocated space (capacity) grows geometrically so adding of N items
+ * costs O(N) copies in total. The space is shrinked to the half when vector
+ * length drops to the quarter of capacity. The gap between thresholds
+ * prevents reallocation on every add/del near the border.
+ *
+ * The vector can be kept sorted by user. The faux_vec_sort() sorts items and
+ * faux_vec_add_sorted() inserts new item to the right place. Then search
+ * functions faux_vec_bsearch(), faux_vec_lower_bound() and
+ * faux_vec_upper_bound() find items in O(log n) time. These functions use
+ * vector's key compare function. It must return value less than, equal to,
+ * or greater than zero if the key is less than, equal to, or greater than
+ * the item, in the same order the vector is sorted by. The vector doesn't
+ * check the order. The user is responsible for it.
  */
 
 
@@ -11,6 +25,8 @@
 
 #include "private.h"
 
+#define VEC_CAPACITY_MIN 8 // Initial number of allocated items
+
 
 /** @brief Allocates and initalizes new vector.
  *
@@ -36,6 +52,8 @@ faux_vec_t *faux_vec_new(size_t item_size, faux_vec_kcmp_fn matchFn)
 	faux_vec->data = NULL;
 	faux_vec->item_size = item_size;
 	faux_vec->len = 0;
+	faux_vec->capacity = 0;
+	faux_vec->reserved = 0;
 	faux_vec->kcmpFn = matchFn;
 
 	return faux_vec;
@@ -85,6 +103,99 @@ size_t faux_vec_item_size(const faux_vec_t *faux_vec)
 }
 
 
+/** @brief Gets vector capacity in items.
+ *
+ * Capacity is a number of items the vector can hold without reallocation.
+ *
+ * @param [in] faux_vec Allocated vector object.
+ * @return Number of allocated items.
+ */
+size_t faux_vec_capacity(const faux_vec_t *faux_vec)
+{
+	assert(faux_vec);
+	if (!faux_vec)
+		return 0;
+
+	return faux_vec->capacity;
+}
+
+
+/** @brief Reallocates vector space.
+ *
+ * Static service function.
+ *
+ * @param [in] faux_vec Allocated vector object.
+ * @param [in] capacity New number of allocated items. Not less than length.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+static bool_t faux_vec_set_capacity(faux_vec_t *faux_vec, size_t capacity)
+{
+	void *new_vector = NULL;
+
+	if (capacity == faux_vec->capacity)
+		return BOOL_TRUE;
+	if (0 == capacity) {
+		faux_free(faux_vec->data);
+		faux_vec->data = NULL;
+		faux_vec->capacity = 0;
+		return BOOL_TRUE;
+	}
+
+	new_vector = realloc(faux_vec->data,
+		capacity * faux_vec_item_size(faux_vec));
+	if (!new_vector)
+		return BOOL_FALSE;
+	faux_vec->data = new_vector;
+	faux_vec->capacity = capacity;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Reserves space for specified number of items.
+ *
+ * The adding of items up to reserved capacity doesn't reallocate vector.
+ * The automatic shrinking keeps reserved capacity too. Note pointers to
+ * items are valid until reallocation.
+ *
+ * @param [in] faux_vec Allocated vector object.
+ * @param [in] capacity Number of items to reserve space for.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_vec_reserve(faux_vec_t *faux_vec, size_t capacity)
+{
+	assert(faux_vec);
+	if (!faux_vec)
+		return BOOL_FALSE;
+
+	faux_vec->reserved = capacity;
+	if (capacity <= faux_vec->capacity)
+		return BOOL_TRUE;
+
+	return faux_vec_set_capacity(faux_vec, capacity);
+}
+
+
+/** @brief Frees unused space of vector.
+ *
+ * Capacity becomes equal to length. The reservation made by
+ * faux_vec_reserve() is dropped.
+ *
+ * @param [in] faux_vec Allocated vector object.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_vec_shrink_to_fit(faux_vec_t *faux_vec)
+{
+	assert(faux_vec);
+	if (!faux_vec)
+		return BOOL_FALSE;
+
+	faux_vec->reserved = 0;
+
+	return faux_vec_set_capacity(faux_vec, faux_vec_len(faux_vec));
+}
+
+
 /** @brief Gets item by index.
  *
  * Gets pointer to item's data.
@@ -128,8 +239,6 @@ void *faux_vec_data(const faux_vec_t *faux_vec)
  */
 void *faux_vec_add(faux_vec_t *faux_vec)
 {
-	void *new_vector = NULL;
-	size_t new_data_len = 0;
 	void *new_item = NULL;
 
 	assert(faux_vec);
@@ -137,13 +246,14 @@ void *faux_vec_add(faux_vec_t *faux_vec)
 		return NULL;
 
 	// Allocate space to hold new vector
-	new_data_len = (faux_vec_len(faux_vec) + 1) * faux_vec_item_size(faux_vec);
-	new_vector = realloc(faux_vec->data, new_data_len);
-	assert(new_vector);
-	if (!new_vector)
-		return NULL;
+	if (faux_vec_len(faux_vec) == faux_vec->capacity) {
+		size_t new_capacity = faux_vec->capacity * 2;
+		if (new_capacity < VEC_CAPACITY_MIN)
+			new_capacity = VEC_CAPACITY_MIN;
+		if (!faux_vec_set_capacity(faux_vec, new_capacity))
+			return NULL;
+	}
 	faux_vec->len++;
-	faux_vec->data = new_vector;
 
 	// Newly created item (it's last one)
 	new_item = faux_vec_item(faux_vec, faux_vec_len(faux_vec) - 1);
@@ -153,10 +263,67 @@ void *faux_vec_add(faux_vec_t *faux_vec)
 }
 
 
+/** @brief Inserts item to vector at specified position.
+ *
+ * The items starting with specified index are moved to the end. The index
+ * equal to vector length adds item to the end.
+ *
+ * @param [in] faux_vec Allocated vector object.
+ * @param [in] index Index of new item.
+ * @return Newly created item or NULL on error.
+ */
+void *faux_vec_insert(faux_vec_t *faux_vec, unsigned int index)
+{
+	void *new_item = NULL;
+	unsigned int items_to_move = 0;
+
+	assert(faux_vec);
+	if (!faux_vec)
+		return NULL;
+	if (index > faux_vec_len(faux_vec))
+		return NULL;
+
+	items_to_move = faux_vec_len(faux_vec) - index;
+	if (!faux_vec_add(faux_vec))
+		return NULL;
+	new_item = faux_vec_item(faux_vec, index);
+	if (items_to_move > 0) {
+		memmove(faux_vec_item(faux_vec, index + 1), new_item,
+			items_to_move * faux_vec_item_size(faux_vec));
+		faux_bzero(new_item, faux_vec_item_size(faux_vec));
+	}
+
+	return new_item;
+}
+
+
+/** @brief Inserts item to sorted vector.
+ *
+ * The new item is placed after all items equal to the key. So insertion is
+ * stable. User must fill new item with data that corresponds to the key.
+ *
+ * @sa faux_vec_upper_bound()
+ * @param [in] faux_vec Allocated vector object.
+ * @param [in] userkey Key of new item.
+ * @return Newly created item or NULL on error.
+ */
+void *faux_vec_add_sorted(faux_vec_t *faux_vec, const void *userkey)
+{
+	int index = 0;
+
+	index = faux_vec_upper_bound(faux_vec, userkey);
+	if (index < 0)
+		return NULL;
+
+	return faux_vec_insert(faux_vec, index);
+}
+
+
 /** @brief Removes item from vector by index.
  *
  * Function removes item by index and then fill hole with the following items.
- * It saves items sequence and frees vector memory.
+ * It saves items sequence. The vector space is shrinked to the half when
+ * length drops to the quarter of capacity but not below reserved capacity.
  *
  * @param [in] faux_vec Allocated vector object.
  * @param [in] index Index of item to remove.
@@ -164,8 +331,7 @@ void *faux_vec_add(faux_vec_t *faux_vec)
  */
 ssize_t faux_vec_del(faux_vec_t *faux_vec, unsigned int index)
 {
-	void *new_vector = NULL;
-	size_t new_data_len = 0;
+	size_t new_capacity = 0;
 
 	assert(faux_vec);
 	if (!faux_vec)
@@ -174,15 +340,6 @@ ssize_t faux_vec_del(faux_vec_t *faux_vec, unsigned int index)
 	if ((index + 1) > faux_vec_len(faux_vec))
 		return -1;
 
-	// It's special case when the only one item left within vector. In this
-	// case we don't need to realloc() but free() the vector.
-	if (faux_vec_len(faux_vec) == 1) {
-		free(faux_vec->data);
-		faux_vec->data = NULL;
-		faux_vec->len = 0;
-		return 0;
-	}
-
 	// Move following items to fill the space of deleted item
 	if (index != (faux_vec_len(faux_vec) - 1)) { // Is it last item?
 		void *item_to_del = faux_vec_item(faux_vec, index);
@@ -193,14 +350,14 @@ ssize_t faux_vec_del(faux_vec_t *faux_vec, unsigned int index)
 			items_to_move * faux_vec_item_size(faux_vec));
 	}
 
-	// Re-allocate space to hold new vector
 	faux_vec->len--;
-	new_data_len = faux_vec_len(faux_vec) * faux_vec_item_size(faux_vec);
-	new_vector = realloc(faux_vec->data, new_data_len);
-	assert(new_vector);
-	if (!new_vector)
-		return -1;
-	faux_vec->data = new_vector;
+
+	// Shrink with hysteresis. Shrinking error is not fatal.
+	new_capacity = faux_vec->capacity / 2;
+	if ((faux_vec_len(faux_vec) <= (faux_vec->capacity / 4)) &&
+		(new_capacity >= VEC_CAPACITY_MIN) &&
+		(new_capacity >= faux_vec->reserved))
+		faux_vec_set_capacity(faux_vec, new_capacity);
 
 	return faux_vec_len(faux_vec);
 }
@@ -269,7 +426,122 @@ int faux_vec_find(const faux_vec_t *faux_vec, const void *userkey,
 }
 
 
+/** @brief Sorts vector items.
+ *
+ * The sort is not stable.
+ *
+ * @param [in] faux_vec Allocated vector object.
+ * @param [in] cmpFn Callback function to compare two items.
+ */
+void faux_vec_sort(faux_vec_t *faux_vec, faux_vec_cmp_fn cmpFn)
+{
+	assert(faux_vec);
+	if (!faux_vec)
+		return;
+	assert(cmpFn);
+	if (!cmpFn)
+		return;
+	if (faux_vec_len(faux_vec) < 2)
+		return;
+
+	qsort(faux_vec->data, faux_vec_len(faux_vec),
+		faux_vec_item_size(faux_vec), cmpFn);
+}
+
+
+/** @brief Finds bound of items equal to key within sorted vector.
+ *
+ * Static service function.
+ *
+ * @param [in] faux_vec Allocated vector object.
+ * @param [in] userkey User defined key to compare item to.
+ * @param [in] upper BOOL_TRUE - find upper bound, BOOL_FALSE - lower bound.
+ * @return Index of bound or < 0 on error.
+ */
+static int faux_vec_bound(const faux_vec_t *faux_vec, const void *userkey,
+	bool_t upper)
+{
+	unsigned int first = 0;
+	unsigned int last = 0;
+
+	assert(faux_vec);
+	if (!faux_vec)
+		return -1;
+	assert(userkey);
+	if (!userkey)
+		return -1;
+	assert(faux_vec->kcmpFn);
+	if (!faux_vec->kcmpFn)
+		return -1;
+
+	last = faux_vec_len(faux_vec);
+	while (first < last) {
+		unsigned int middle = first + (last - first) / 2;
+		int r = faux_vec->kcmpFn(userkey, faux_vec_item(faux_vec, middle));
+		if ((r > 0) || (upper && (0 == r)))
+			first = middle + 1;
+		else
+			last = middle;
+	}
+
+	return first;
+}
+
+
+/** @brief Finds the first item not less than key within sorted vector.
+ *
+ * @param [in] faux_vec Allocated vector object.
+ * @param [in] userkey User defined key to compare item to.
+ * @return Index of item, vector length if all items are less than key
+ * or < 0 on error.
+ */
+int faux_vec_lower_bound(const faux_vec_t *faux_vec, const void *userkey)
+{
+	return faux_vec_bound(faux_vec, userkey, BOOL_FALSE);
+}
+
+
+/** @brief Finds the first item greater than key within sorted vector.
+ *
+ * @param [in] faux_vec Allocated vector object.
+ * @param [in] userkey User defined key to compare item to.
+ * @return Index of item, vector length if there is no items greater than key
+ * or < 0 on error.
+ */
+int faux_vec_upper_bound(const faux_vec_t *faux_vec, const void *userkey)
+{
+	return faux_vec_bound(faux_vec, userkey, BOOL_TRUE);
+}
+
+
+/** @brief Finds item by key within sorted vector using binary search.
+ *
+ * The index of the first item equal to the key is returned. So items with
+ * duplicate keys can be iterated by faux_vec_find() starting with it.
+ *
+ * @param [in] faux_vec Allocated vector object.
+ * @param [in] userkey User defined key to compare item to.
+ * @return Index of found item or < 0 on error or "not found" case.
+ */
+int faux_vec_bsearch(const faux_vec_t *faux_vec, const void *userkey)
+{
+	int index = 0;
+
+	index = faux_vec_lower_bound(faux_vec, userkey);
+	if (index < 0)
+		return -1;
+	if ((unsigned int)index >= faux_vec_len(faux_vec))
+		return -1;
+	if (faux_vec->kcmpFn(userkey, faux_vec_item(faux_vec, index)) != 0)
+		return -1;
+
+	return index;
+}
+
+
 /** @brief Deletes all vector's items.
+ *
+ * The vector space is freed except reserved capacity.
  *
  * @param [in] faux_vec Allocated vector object.
  */
@@ -277,7 +549,7 @@ void faux_vec_del_all(faux_vec_t *faux_vec)
 {
 	if (!faux_vec)
 		return;
-	faux_free(faux_vec->data);
-	faux_vec->data = NULL;
 	faux_vec->len = 0;
+	if (!faux_vec_set_capacity(faux_vec, faux_vec->reserved))
+		faux_vec_set_capacity(faux_vec, 0);
 }
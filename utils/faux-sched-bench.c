@@ -0,0 +1,125 @@
+/** @file faux-sched-bench.c
+ * @brief Benchmark of scheduler backends.
+ *
+ * Runs the typical timeout workload on sorted list, heap and timing wheel
+ * based schedulers with different number of events. Events are added in
+ * random order, quarter of them is rescheduled, half of them is cancelled
+ * and the rest is popped. The numbers of events can be specified on command
+ * line. The sorted list is too slow for large number of events so it's
+ * skipped for default sizes greater than BENCH_LIST_MAX. The explicitly
+ * specified sizes are used for all backends.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include <faux/faux.h>
+#include <faux/time.h>
+#include <faux/sched.h>
+
+#define BENCH_LIST_MAX 10000
+
+
+static uint64_t bench_run(faux_sched_t *sched, unsigned int ev_num)
+{
+	faux_ev_t **evs = NULL;
+	struct timespec now = {};
+	struct timespec base = {};
+	struct timespec start = {};
+	struct timespec stop = {};
+	struct timespec t = {};
+	struct timespec offset = {};
+	unsigned int i = 0;
+	unsigned int popped = 0;
+	uint64_t rnd = 1;
+	faux_ev_t *ev = NULL;
+
+	evs = faux_zmalloc(ev_num * sizeof(*evs));
+	if (!evs)
+		return 0;
+	// All events are in the past so pop gets them all
+	faux_timespec_now(&now);
+	faux_timespec_diff(&base, &now, &(struct timespec){3600, 0});
+
+	faux_timespec_now_monotonic(&start);
+	for (i = 0; i < ev_num; i++) {
+		rnd = rnd * 6364136223846793005ull + 1442695040888963407ull;
+		faux_nsec_to_timespec(&offset, (rnd >> 33) % 1000000000000ull);
+		faux_timespec_sum(&t, &base, &offset);
+		evs[i] = faux_sched_once(sched, &t, i, NULL);
+	}
+	for (i = 0; i < ev_num; i += 4) {
+		rnd = rnd * 6364136223846793005ull + 1442695040888963407ull;
+		faux_nsec_to_timespec(&offset, (rnd >> 33) % 1000000000000ull);
+		faux_timespec_sum(&t, &base, &offset);
+		faux_sched_reschedule(sched, evs[i], &t);
+	}
+	for (i = 1; i < ev_num; i += 2)
+		faux_sched_del(sched, evs[i]);
+	while ((ev = faux_sched_pop(sched))) {
+		faux_ev_free(ev);
+		popped++;
+	}
+	faux_timespec_now_monotonic(&stop);
+
+	faux_free(evs);
+	if (popped != (ev_num - ev_num / 2))
+		return 0;
+	faux_timespec_diff(&t, &stop, &start);
+
+	return faux_timespec_to_nsec(&t);
+}
+
+
+int main(int argc, char *argv[])
+{
+	unsigned int def_sizes[] = {10, 100, 1000, 10000, 100000};
+	unsigned int def_num = sizeof(def_sizes) / sizeof(def_sizes[0]);
+	unsigned int num = (argc > 1) ? (unsigned int)(argc - 1) : def_num;
+	unsigned int i = 0;
+
+	printf("%10s %14s %14s %14s\n", "events",
+		"list ns/ev", "heap ns/ev", "wheel ns/ev");
+	for (i = 0; i < num; i++) {
+		unsigned int ev_num = (argc > 1) ?
+			strtoul(argv[i + 1], NULL, 0) : def_sizes[i];
+		faux_sched_t *list = NULL;
+		faux_sched_t *heap = NULL;
+		faux_sched_t *wheel = NULL;
+		uint64_t list_nsec = 0;
+		uint64_t heap_nsec = 0;
+		uint64_t wheel_nsec = 0;
+		bool_t use_list = BOOL_TRUE;
+
+		if (0 == ev_num)
+			continue;
+		if ((argc <= 1) && (ev_num > BENCH_LIST_MAX))
+			use_list = BOOL_FALSE;
+		if (use_list) {
+			list = faux_sched_new();
+			list_nsec = bench_run(list, ev_num);
+			faux_sched_free(list);
+		}
+		heap = faux_sched_new_heap();
+		wheel = faux_sched_new_wheel(&(struct timespec){0, 1000000});
+		heap_nsec = bench_run(heap, ev_num);
+		wheel_nsec = bench_run(wheel, ev_num);
+		faux_sched_free(heap);
+		faux_sched_free(wheel);
+		if ((use_list && !list_nsec) || !heap_nsec || !wheel_nsec) {
+			fprintf(stderr, "Error: Wrong number of popped events\n");
+			return -1;
+		}
+		printf("%10u ", ev_num);
+		if (use_list)
+			printf("%14llu ", (unsigned long long)(list_nsec / ev_num));
+		else
+			printf("%14s ", "-");
+		printf("%14llu %14llu\n",
+			(unsigned long long)(heap_nsec / ev_num),
+			(unsigned long long)(wheel_nsec / ev_num));
+	}
+
+	return 0;
+}